@@ -0,0 +1,84 @@
+/*===========================================================================*
+ * File:        cylinder_trim.h
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Per cylinder fuel and spark trims
+ *===========================================================================*/
+#ifndef _CYLINDER_TRIM_H_
+#define _CYLINDER_TRIM_H_
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "common_include.h"
+
+#include "engine_constants.h"
+
+/*===========================================================================*
+ *
+ * EXPORTED DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED GLOBAL VARIABLES SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Initialize cylinder trims
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+void CylTrim_Init(void);
+
+/*===========================================================================*
+ * brief:       Recalculate trims of all cylinders for the operating point
+ * param[in]:   speed - engine speed in RPM
+ * param[in]:   pressure - engine absolute pressure in kPa
+ * param[out]:  None
+ * return:      None
+ * details:     Needs to be called once per engine cycle, getters return values cached here
+ *===========================================================================*/
+void CylTrim_Update(float speed, float pressure);
+
+/*===========================================================================*
+ * brief:       Gets cylinder fuel trim
+ * param[in]:   channel - cylinder channel
+ * param[out]:  None
+ * return:      float - multiplier of the fuel mass, 1.0 means no correction
+ * details:     None
+ *===========================================================================*/
+float CylTrim_GetFuelMultiplier(EnCon_CylinderChannels_T channel);
+
+/*===========================================================================*
+ * brief:       Gets cylinder spark trim
+ * param[in]:   channel - cylinder channel
+ * param[out]:  None
+ * return:      float - spark advance to be added to the base angle in degrees
+ * details:     None
+ *===========================================================================*/
+float CylTrim_GetSparkAdvance(EnCon_CylinderChannels_T channel);
+
+
+#endif
+/* end of file */
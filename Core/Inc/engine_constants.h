@@ -39,9 +39,13 @@
 #define ENCON_ENGINE_INTAKE_ANGLE               (ENCON_ENGINE_ONE_CYCLE_ANGLE * 2.0F)
 #define ENCON_ENGINE_COMPRESSION_ANGLE          (ENCON_ENGINE_ONE_CYCLE_ANGLE * 3.0F)
 
-#define ENCON_ENGINE_PISTON_1_OFFSET            (ENCON_ENGINE_FULL_CYCLE_ANGLE / ENCON_ENGINE_PISTONS_NO * 0.0F)
-#define ENCON_ENGINE_PISTON_2_OFFSET            (ENCON_ENGINE_FULL_CYCLE_ANGLE / ENCON_ENGINE_PISTONS_NO * 1.0F)
-#define ENCON_ENGINE_PISTON_3_OFFSET            (ENCON_ENGINE_FULL_CYCLE_ANGLE / ENCON_ENGINE_PISTONS_NO * 2.0F)
+/* Maximum number of cylinders supported by output map. Outputs above the 3rd are GPIO pins driven */
+/* from the timer interrupt, their timing includes interrupt latency, see output_map.c */
+#define ENCON_CHANNELS_MAX                      (8U)
+
+/* Work stroke TDC offset of the piston with given index in firing order (0 - first piston) */
+#define ENCON_ENGINE_PISTON_OFFSET(_INDEX_)     ((ENCON_ENGINE_FULL_CYCLE_ANGLE / (float)ENCON_ENGINE_PISTONS_NO) *    \
+                                                 (float)(_INDEX_))
 
 #define ENCON_ENGINE_DISPLACEMENT_M3            (0.000796F)
 
@@ -55,20 +59,32 @@
 #define ENCON_ONE_TRIGGER_PULSE_ANGLE           (ENCON_ENGINE_ONE_ROTATION_ANGLE /    \
                                                  ENCON_TRIGGER_WHEEL_TEETH_NO)
 
-#define ENCON_COILS_DWELL_TIME_MS               (5.0F)
-
 /* Flow rate in cm^3/min */
 #define ENCON_INJECTOR_FLOW_RATE_CC_MIN         (150.0F)
-#define ENCON_INJECTOR_DEAD_TIME_MS             (0.0F)
+
+/* Maximum injection pulses per cylinder event, split defined by TABLES_3D_INJECTION_SPLIT_RATIO table */
+#define ENCON_INJECTION_PULSES_NO               (2U)
 
 #define ENCON_CRANKING_FLOOR_RPM                (200.0F)
 #define ENCON_RUNNING_FLOOR_RPM                 (400.0F)
 
 /* Angle offset after beggining of the intake stroke, at which injector will be opened */
 #define ENCON_FUEL_DELIVERY_OFFSET_ANGLE        (10.0F)
+/* Angle offset after beggining of the intake stroke, at which injection should be finished */
+/* Used in end of injection timing mode, must be a multiple of ENCON_ONE_TRIGGER_PULSE_ANGLE */
+#define ENCON_FUEL_DELIVERY_END_OFFSET_ANGLE    (60.0F)
+
+/* Angle offset after beggining of the intake stroke, at which MAP is sampled */
+/* Must be a multiple of ENCON_ONE_TRIGGER_PULSE_ANGLE */
+#define ENCON_MAP_SAMPLE_OFFSET_ANGLE           (120.0F)
+
+/* Knock sensor signal window, angles after piston work TDC */
+#define ENCON_KNOCK_WINDOW_START_ANGLE          (10.0F)
+#define ENCON_KNOCK_WINDOW_END_ANGLE            (70.0F)
 
-/* Enrichment during cranking in % */
-#define ENCON_CRANKING_ENRICHMENT               (15.0F)
+#if (ENCON_ENGINE_PISTONS_NO > ENCON_CHANNELS_MAX)
+#error "Engine pistons number exceeds output map size"
+#endif
 
 /*===========================================================================*
  *
@@ -76,13 +92,19 @@
  *
  *===========================================================================*/
 
+/* Channels are given in firing order, physical outputs are assigned in output map */
 typedef enum EnCon_CylinderChannels_Tag
 {
     ENCON_CHANNEL_1 = 0,
     ENCON_CHANNEL_2 = 1,
     ENCON_CHANNEL_3 = 2,
+    ENCON_CHANNEL_4 = 3,
+    ENCON_CHANNEL_5 = 4,
+    ENCON_CHANNEL_6 = 5,
+    ENCON_CHANNEL_7 = 6,
+    ENCON_CHANNEL_8 = 7,
 
-    ENCON_CHANNEL_COUNT
+    ENCON_CHANNEL_COUNT = ENCON_ENGINE_PISTONS_NO
 } EnCon_CylinderChannels_T;
 
 /*===========================================================================*
@@ -142,6 +164,15 @@ void EnCon_UpdateEngineAngle(float angle);
  *===========================================================================*/
 void EnCon_UpdateEngineSpeed(uint32_t speed);
 
+/*===========================================================================*
+ * brief:       Convert time to engine angle at current engine speed
+ * param[in]:   timeMs - time in ms
+ * param[out]:  None
+ * return:      float - engine angle in degrees, ENCON_ANGLE_UNKNOWN if engine speed is unknown
+ * details:     Engine speed is assumed to be constant, last speed signal period is used
+ *===========================================================================*/
+float EnCon_ConvertTimeToAngle(float timeMs);
+
 
 #endif
 /* end of file */
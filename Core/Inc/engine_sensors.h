@@ -16,18 +16,64 @@
 
 #include "common_include.h"
 
+#include "engine_constants.h"
+
 /*===========================================================================*
  *
  * EXPORTED DEFINES AND MACRO SECTION
  *
  *===========================================================================*/
 
+/* Oil pressure sensor uses PA3, the 3rd ignition output is then moved to GPIO output (PB2) */
+#define ENSENS_OIL_PRESSURE_SENSOR_ENABLED      (0)
+/* Knock sensor uses PA2, the 3rd injection output is then moved to GPIO output */
+#define ENSENS_KNOCK_SENSOR_ENABLED             (0)
+/* TPS (PA4) and lambda (PA6) use the trigger inputs pins, which are then moved to PB5 and PB4 */
+/* Needs board rework, see README. PB4 is JTAG NJTRST, so only SWD can be used for debugging */
+#define ENSENS_TPS_LAMBDA_SENSORS_ENABLED       (0)
+
+/* Bit of the sensor faults mask */
+#define ENSENS_FAULT_MASK(_FAULT_)              (1U << (uint8_t)(_FAULT_))
+
 /*===========================================================================*
  *
  * EXPORTED TYPES AND ENUMERATION SECTION
  *
  *===========================================================================*/
 
+/* Order of ADC conversion sequence */
+typedef enum EnSens_Sensor_Tag
+{
+    ENSENS_SENSOR_MAP,
+    ENSENS_SENSOR_IAT,
+    ENSENS_SENSOR_CLT,
+    ENSENS_SENSOR_VBAT,
+#if ENSENS_TPS_LAMBDA_SENSORS_ENABLED
+    ENSENS_SENSOR_TPS,
+    ENSENS_SENSOR_LAMBDA,
+#endif
+#if ENSENS_OIL_PRESSURE_SENSOR_ENABLED
+    ENSENS_SENSOR_OIL_PRESSURE,
+#endif
+
+    ENSENS_SENSOR_COUNT
+} EnSens_Sensor_T;
+
+/* Diagnostic codes latched for each sensor */
+typedef enum EnSens_Fault_Tag
+{
+    /* Voltage below plausible range, e.g. short to ground */
+    ENSENS_FAULT_RANGE_LOW,
+    /* Voltage above plausible range, e.g. open circuit */
+    ENSENS_FAULT_RANGE_HIGH,
+    /* Value changed faster than physically possible, e.g. loose connection */
+    ENSENS_FAULT_RATE,
+    /* ADC code didn't change for too long */
+    ENSENS_FAULT_STUCK,
+
+    ENSENS_FAULT_COUNT
+} EnSens_Fault_T;
+
 typedef enum EnSens_CltResultType_Tag
 {
     /* Temperature in Kelvin */
@@ -60,20 +106,90 @@ typedef enum EnSens_CltResultType_Tag
 void EnSens_Init(void);
 
 /*===========================================================================*
- * brief:       Start sensors measurement
+ * brief:       Mark the beggining of the MAP averaging window
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Should be called at intake stroke beggining. Ignored until previous window
+ *              average is calculated
+ *===========================================================================*/
+void EnSens_StartMapWindow(void);
+
+/*===========================================================================*
+ * brief:       Mark the end of the MAP averaging window
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Should be called at intake stroke end. Average is calculated in low priority
+ *              DMA interrupt when all window samples are available
+ *===========================================================================*/
+void EnSens_EndMapWindow(void);
+
+/*===========================================================================*
+ * brief:       Cancel MAP averaging
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Should be called when engine is stopped, last window average is invalidated
+ *===========================================================================*/
+void EnSens_CancelMapWindow(void);
+
+/*===========================================================================*
+ * brief:       Mark the beggining of the knock sensor window
+ * param[in]:   channel - cylinder which combustion is observed
+ * param[out]:  None
+ * return:      None
+ * details:     Ignored until previous window is processed. Does nothing when knock sensor is disabled
+ *===========================================================================*/
+void EnSens_StartKnockWindow(EnCon_CylinderChannels_T channel);
+
+/*===========================================================================*
+ * brief:       Mark the end of the knock sensor window
  * param[in]:   None
  * param[out]:  None
  * return:      None
+ * details:     Window samples are passed to the knock module in low priority DMA interrupt
+ *              when all of them are available
+ *===========================================================================*/
+void EnSens_EndKnockWindow(void);
+
+/*===========================================================================*
+ * brief:       Cancel knock sensor window
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Should be called when engine is stopped
+ *===========================================================================*/
+void EnSens_CancelKnockWindow(void);
+
+/*===========================================================================*
+ * brief:       Gets knock sensor sampling frequency
+ * param[in]:   None
+ * param[out]:  None
+ * return:      float - sampling frequency in Hz
  * details:     None
  *===========================================================================*/
-void EnSens_StartMeasurement(void);
+float EnSens_GetKnockSamplingFrequency(void);
+
+/*===========================================================================*
+ * brief:       Align crank angle synchronous MAP sampling
+ * param[in]:   engineAngle - current engine angle in degrees
+ * param[in]:   sampleAngle - engine angle of one of the MAP samples
+ * param[out]:  None
+ * return:      None
+ * details:     MAP is sampled by hardware once per intake stroke, every 720/ENCON_ENGINE_PISTONS_NO
+ *              degrees. Sampling timer is aligned at the first call and then once per engine cycle,
+ *              unknown engine angle stops synchronous sampling until next alignment
+ *===========================================================================*/
+void EnSens_AlignMapSampling(float engineAngle, float sampleAngle);
 
 /*===========================================================================*
  * brief:       Gets MAP value
  * param[in]:   None
  * param[out]:  None
  * return:      float - absolute MAP value in kPa
- * details:     MAP - Manifold Absolute Pressure
+ * details:     MAP - Manifold Absolute Pressure. Average of the last intake stroke is returned when
+ *              available, then crank angle synchronous sample, otherwise the last sample
  *===========================================================================*/
 float EnSens_GetMap(void);
 
@@ -86,6 +202,15 @@ float EnSens_GetMap(void);
  *===========================================================================*/
 float EnSens_GetIat(void);
 
+/*===========================================================================*
+ * brief:       Gets IAT reciprocal
+ * param[in]:   None
+ * param[out]:  None
+ * return:      float - 1 / IAT in 1/K
+ * details:     Interpolated from the lookup table once per samples set, without division
+ *===========================================================================*/
+float EnSens_GetIatReciprocal(void);
+
 /*===========================================================================*
  * brief:       Gets CLT specified value
  * param[in]:   resultType - what type of result will be returned
@@ -95,14 +220,70 @@ float EnSens_GetIat(void);
  *===========================================================================*/
 float EnSens_GetClt(EnSens_CltResultTypes_T resultType);
 
+/*===========================================================================*
+ * brief:       Gets battery voltage
+ * param[in]:   None
+ * param[out]:  None
+ * return:      float - battery voltage in V
+ * details:     None
+ *===========================================================================*/
+float EnSens_GetBatteryVoltage(void);
+
+/*===========================================================================*
+ * brief:       Gets throttle position
+ * param[in]:   None
+ * param[out]:  None
+ * return:      float - throttle opening in %
+ * details:     TPS - Throttle Position Sensor. Returns 0 (closed) when the sensor is not enabled
+ *===========================================================================*/
+float EnSens_GetTps(void);
+
+/*===========================================================================*
+ * brief:       Gets lambda value
+ * param[in]:   None
+ * param[out]:  None
+ * return:      float - lambda
+ * details:     Read from wideband controller analog output. Returns 1.0 when the sensor is not enabled
+ *===========================================================================*/
+float EnSens_GetLambda(void);
+
 /*===========================================================================*
  * brief:       Gets oil pressure
  * param[in]:   None
  * param[out]:  None
  * return:      float - oil pressure in kPa
- * details:     None
+ * details:     Returns 0 when the sensor is not enabled
+ *===========================================================================*/
+float EnSens_GetOilPressure(void);
+
+
+/*===========================================================================*
+ * brief:       Gets sensor latched faults
+ * param[in]:   sensor - sensor to be checked
+ * param[out]:  None
+ * return:      uint32_t - mask of "EnSens_Fault_T" faults, see ENSENS_FAULT_MASK
+ * details:     Faults stay latched after the sensor heals, until EnSens_ClearFaults is called
+ *===========================================================================*/
+uint32_t EnSens_GetFaults(EnSens_Sensor_T sensor);
+
+/*===========================================================================*
+ * brief:       Gets sensor active faults
+ * param[in]:   sensor - sensor to be checked
+ * param[out]:  None
+ * return:      uint32_t - mask of "EnSens_Fault_T" faults, see ENSENS_FAULT_MASK
+ * details:     Sensor getters return configured substitute value while any fault is active. Fault is
+ *              cleared after 1 s of good samples
+ *===========================================================================*/
+uint32_t EnSens_GetActiveFaults(EnSens_Sensor_T sensor);
+
+/*===========================================================================*
+ * brief:       Clear all latched sensors faults
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Faults still present are latched again at the next samples check
  *===========================================================================*/
-// float EnSens_GetOilPressure(void);
+void EnSens_ClearFaults(void);
 
 
 #endif
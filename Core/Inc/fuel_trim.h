@@ -0,0 +1,75 @@
+/*===========================================================================*
+ * File:        fuel_trim.h
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Closed loop lambda control and long term fuel trim learning
+ *===========================================================================*/
+#ifndef _FUEL_TRIM_H_
+#define _FUEL_TRIM_H_
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "common_include.h"
+
+#include "tables.h"
+
+/*===========================================================================*
+ *
+ * EXPORTED DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED GLOBAL VARIABLES SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Initialize fuel trim module
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Long term trim map starts from zero, it is kept in RAM only
+ *===========================================================================*/
+void FuelTrim_Init(void);
+
+/*===========================================================================*
+ * brief:       Run lambda controller and long term trim learning
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Needs to be called from the main loop, controller runs every
+ *              FUELTRIM_UPDATE_PERIOD_MS. It is the only writer of trim values
+ *===========================================================================*/
+void FuelTrim_OnBackgroundTask(void);
+
+/*===========================================================================*
+ * brief:       Gets fuel trim multiplier
+ * param[in]:   cell - TABLES_3D_VE cell of the current operating point
+ * param[out]:  None
+ * return:      float - multiplier of the fuel mass, 1.0 means no correction
+ * details:     Combines short term trim with long term trim of the VE table cell
+ *===========================================================================*/
+float FuelTrim_GetMultiplier(const Tables_3DCell_T* cell);
+
+
+#endif
+/* end of file */
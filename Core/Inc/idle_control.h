@@ -0,0 +1,75 @@
+/*===========================================================================*
+ * File:        idle_control.h
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Closed loop idle speed control
+ *===========================================================================*/
+#ifndef _IDLE_CONTROL_H_
+#define _IDLE_CONTROL_H_
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "common_include.h"
+
+/*===========================================================================*
+ *
+ * EXPORTED DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED GLOBAL VARIABLES SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Initialize idle control and idle air valve output
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Valve is driven by TIMER_IDLE_VALVE PWM on PB9
+ *===========================================================================*/
+void Idle_Init(void);
+
+/*===========================================================================*
+ * brief:       Run idle air valve control loop
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Needs to be called from the main loop, controller runs every IDLE_UPDATE_PERIOD_MS.
+ *              Idle state and target speed used by the spark loop are updated here. Closed throttle is
+ *              detected with TPS or, without the sensor, with MAP
+ *===========================================================================*/
+void Idle_OnBackgroundTask(void);
+
+/*===========================================================================*
+ * brief:       Gets idle spark advance correction
+ * param[in]:   speed - engine speed in RPM
+ * param[out]:  None
+ * return:      float - spark advance to be added to the base angle in degrees
+ * details:     Fast loop called for every ignition event, proportional to the speed error.
+ *              Returns 0 when the engine is not idling
+ *===========================================================================*/
+float Idle_GetSparkCorrection(float speed);
+
+
+#endif
+/* end of file */
@@ -55,21 +55,15 @@ void IgnDrv_Init(void);
  * brief:       Prepere ignition channel
  * param[in]:   channel - ignition channel to be prepared
  * param[in]:   fireAngle - engine angle at which ignition need to occure
+ * param[in]:   dwellAngle - engine angle range in which coil is charged before the spark
  * param[in]:   startAngle - engine angle at which module will be started
  * param[out]:  None
  * return:      None
- * details:     None
- *===========================================================================*/
-void IgnDrv_PrepareIgnitionChannel(EnCon_CylinderChannels_T channel, float fireAngle, float startAngle);
-
-/*===========================================================================*
- * brief:       Starts ignition module
- * param[in]:   None
- * param[out]:  None
- * return:      None
- * details:     It is necessary to previously prepare proper channel via prepare function
+ * details:     Timer is armed and will be started by hardware at the next speed signal pulse.
+ *              Dwell is shortened if it doesn't fit between start and fire angle
  *===========================================================================*/
-void IgnDrv_StartIgnitionModule(void);
+void IgnDrv_PrepareIgnitionChannel(EnCon_CylinderChannels_T channel, float fireAngle, float dwellAngle,
+                                   float startAngle);
 
 
 #endif
@@ -24,12 +24,21 @@
  *
  *===========================================================================*/
 
+/* Maximum number of injection pulses in one engine cycle */
+#define INJDRV_PULSES_MAX                  (3U)
+
 /*===========================================================================*
  *
  * EXPORTED TYPES AND ENUMERATION SECTION
  *
  *===========================================================================*/
 
+typedef struct InjDrv_Pulse_Tag
+{
+    float injAngle;
+    float openTimeMs;
+} InjDrv_Pulse_T;
+
 /*===========================================================================*
  *
  * EXPORTED GLOBAL VARIABLES SECTION
@@ -54,24 +63,17 @@ void InjDrv_Init(void);
 /*===========================================================================*
  * brief:       Prepere injection channel
  * param[in]:   channel - injection channel to be prepared
- * param[in]:   injAngle - engine angle at which injection need to start
+ * param[in]:   pulses - injection pulses sorted by start angle (start angle and open time in ms)
+ * param[in]:   pulsesNo - number of pulses, from 1 to INJDRV_PULSES_MAX
  * param[in]:   startAngle - engine angle at which module will be started
- * param[in]:   injOpenTimeMs - required injector open time in ms
- * param[out]:  None
- * return:      None
- * details:     None
- *===========================================================================*/
-void InjDrv_PrepareInjectionChannel(EnCon_CylinderChannels_T channel, float injAngle, float startAngle,
-                                    float injOpenTimeMs);
-
-/*===========================================================================*
- * brief:       Starts injection module
- * param[in]:   None
  * param[out]:  None
  * return:      None
- * details:     It is necessary to previously prepare proper channel via prepare function
+ * details:     Timer is armed and will be started by hardware at the next speed signal pulse.
+ *              Pulses after the first one are loaded by DMA at timer update events, overlapping
+ *              pulses are delayed to the end of the previous one
  *===========================================================================*/
-void InjDrv_StartInjectionModule(void);
+void InjDrv_PrepareInjectionChannel(EnCon_CylinderChannels_T channel, const InjDrv_Pulse_T* pulses,
+                                    uint8_t pulsesNo, float startAngle);
 
 
 #endif
@@ -0,0 +1,72 @@
+/*===========================================================================*
+ * File:        injector_model.h
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Injector dead time and short pulse characterisation
+ *===========================================================================*/
+#ifndef _INJECTOR_MODEL_H_
+#define _INJECTOR_MODEL_H_
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "common_include.h"
+
+/*===========================================================================*
+ *
+ * EXPORTED DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED GLOBAL VARIABLES SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Initialize injector model
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Short pulse correction table is resampled to the evenly spaced lookup table
+ *===========================================================================*/
+void InjMod_Init(void);
+
+/*===========================================================================*
+ * brief:       Update injector dead time with the current battery voltage
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Needs to be called once per engine cycle, battery voltage changes slowly
+ *===========================================================================*/
+void InjMod_Update(void);
+
+/*===========================================================================*
+ * brief:       Calculate injector pulse width delivering given fuel
+ * param[in]:   fuelMs - effective open time in ms, fuel mass divided by the static flow rate
+ * param[out]:  None
+ * return:      float - injector pulse width in ms
+ * details:     Constant time, adds short pulse correction and dead time. Zero fuel gives zero pulse
+ *===========================================================================*/
+float InjMod_GetPulseWidth(float fuelMs);
+
+
+#endif
+/* end of file */
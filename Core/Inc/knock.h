@@ -0,0 +1,80 @@
+/*===========================================================================*
+ * File:        knock.h
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Knock detection and spark retard
+ *===========================================================================*/
+#ifndef _KNOCK_H_
+#define _KNOCK_H_
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "common_include.h"
+
+#include "engine_constants.h"
+
+/*===========================================================================*
+ *
+ * EXPORTED DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/* Longer windows are truncated: 8.5ms at 30kHz */
+#define KNOCK_WINDOW_SAMPLES_MAX                (256U)
+
+/*===========================================================================*
+ *
+ * EXPORTED TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED GLOBAL VARIABLES SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Initialize knock module
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+void Knock_Init(void);
+
+/*===========================================================================*
+ * brief:       Process knock sensor samples of one combustion window
+ * param[in]:   channel - cylinder which combustion was observed
+ * param[in]:   samples - knock sensor ADC codes
+ * param[in]:   samplesNo - number of samples, up to KNOCK_WINDOW_SAMPLES_MAX
+ * param[out]:  None
+ * return:      None
+ * details:     Called from low priority DMA interrupt. Knock frequency band energy is compared
+ *              with the learned cylinder background and cylinder spark retard is updated
+ *===========================================================================*/
+void Knock_OnWindowCaptured(EnCon_CylinderChannels_T channel, const float* samples, uint16_t samplesNo);
+
+/*===========================================================================*
+ * brief:       Gets cylinder spark retard
+ * param[in]:   channel - cylinder channel
+ * param[out]:  None
+ * return:      float - spark retard in degrees
+ * details:     None
+ *===========================================================================*/
+float Knock_GetRetard(EnCon_CylinderChannels_T channel);
+
+
+#endif
+/* end of file */
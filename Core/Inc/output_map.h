@@ -0,0 +1,87 @@
+/*===========================================================================*
+ * File:        output_map.h
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Cylinder channels to ignition and injection outputs map
+ *===========================================================================*/
+#ifndef _OUTPUT_MAP_H_
+#define _OUTPUT_MAP_H_
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "common_include.h"
+
+#include "engine_constants.h"
+
+/*===========================================================================*
+ *
+ * EXPORTED DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+typedef enum OutMap_Group_Tag
+{
+    /* Outputs driven by TIMER_IGNITION */
+    OUTMAP_GROUP_IGNITION,
+    /* Outputs driven by TIMER_INJECTOR */
+    OUTMAP_GROUP_INJECTION,
+
+    OUTMAP_GROUP_COUNT
+} OutMap_Group_T;
+
+/*===========================================================================*
+ *
+ * EXPORTED GLOBAL VARIABLES SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Initialize outputs of the group
+ * param[in]:   group - outputs group to be initialized
+ * param[out]:  None
+ * return:      None
+ * details:     Only ENCON_CHANNEL_COUNT first outputs of the group are initialized
+ *===========================================================================*/
+void OutMap_Init(OutMap_Group_T group);
+
+/*===========================================================================*
+ * brief:       Select group output driven by the next timer event
+ * param[in]:   group - outputs group
+ * param[in]:   channel - cylinder channel to be selected
+ * param[in]:   compareValue - timer compare value at which output is activated
+ * param[out]:  None
+ * return:      None
+ * details:     Output is active from compare event to timer update event.
+ *              All other group outputs are disabled
+ *===========================================================================*/
+void OutMap_SelectChannel(OutMap_Group_T group, EnCon_CylinderChannels_T channel, uint32_t compareValue);
+
+/*===========================================================================*
+ * brief:       Handle group timer compare and update interrupts
+ * param[in]:   group - outputs group
+ * param[out]:  None
+ * return:      None
+ * details:     Drives GPIO outputs, needs to be called from the group timer interrupt handler
+ *===========================================================================*/
+void OutMap_OnTimerInterrupt(OutMap_Group_T group);
+
+
+#endif
+/* end of file */
@@ -0,0 +1,112 @@
+/*===========================================================================*
+ * File:        rev_limiter.h
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Engine speed limiter and launch control
+ *===========================================================================*/
+#ifndef _REV_LIMITER_H_
+#define _REV_LIMITER_H_
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "common_include.h"
+
+/*===========================================================================*
+ *
+ * EXPORTED DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+typedef enum RevLim_CutMode_Tag
+{
+    /* Ignition events are skipped */
+    REVLIM_CUT_MODE_SPARK,
+    /* Injection events are skipped */
+    REVLIM_CUT_MODE_FUEL,
+    /* Spark is retarded first, ignition events are skipped above the retard levels */
+    REVLIM_CUT_MODE_SOFT,
+
+    REVLIM_CUT_MODE_COUNT
+} RevLim_CutMode_T;
+
+/*===========================================================================*
+ *
+ * EXPORTED GLOBAL VARIABLES SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Initialize limiter and launch control input
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Cut patterns are precomputed for every cut level
+ *===========================================================================*/
+void RevLim_Init(void);
+
+/*===========================================================================*
+ * brief:       Update cut level with the current engine speed
+ * param[in]:   speed - engine speed in RPM
+ * param[out]:  None
+ * return:      None
+ * details:     Needs to be called at every speed signal pulse before the events dispatch.
+ *              Launch limit is used while the clutch switch is pressed
+ *===========================================================================*/
+void RevLim_Update(float speed);
+
+/*===========================================================================*
+ * brief:       Check if the next ignition event has to be skipped
+ * param[in]:   None
+ * param[out]:  None
+ * return:      bool - true when the event is cut
+ * details:     Needs to be called exactly once per ignition event, it moves the pattern position
+ *===========================================================================*/
+bool RevLim_IsSparkCut(void);
+
+/*===========================================================================*
+ * brief:       Check if the next injection event has to be skipped
+ * param[in]:   None
+ * param[out]:  None
+ * return:      bool - true when the event is cut
+ * details:     Needs to be called exactly once per injection event, it moves the pattern position
+ *===========================================================================*/
+bool RevLim_IsFuelCut(void);
+
+/*===========================================================================*
+ * brief:       Check if the limiter cuts any events
+ * param[in]:   None
+ * param[out]:  None
+ * return:      bool - true when spark or fuel cut level is above 0
+ * details:     Exhaust gas has air only or unburnt charge of cut events, lambda reads lean
+ *===========================================================================*/
+bool RevLim_IsCutActive(void);
+
+/*===========================================================================*
+ * brief:       Gets limiter spark retard
+ * param[in]:   None
+ * param[out]:  None
+ * return:      float - spark retard in degrees
+ * details:     Non zero only in REVLIM_CUT_MODE_SOFT
+ *===========================================================================*/
+float RevLim_GetRetard(void);
+
+
+#endif
+/* end of file */
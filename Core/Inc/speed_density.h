@@ -22,6 +22,17 @@
  *
  *===========================================================================*/
 
+/* Engine load models, load is expressed as absolute pressure in kPa */
+/* Measured MAP */
+#define SPDEN_LOAD_MODEL_SPEED_DENSITY          (0)
+/* MAP estimated from TPS and engine speed, for individual throttle bodies with weak MAP signal */
+#define SPDEN_LOAD_MODEL_ALPHA_N                (1)
+/* MAP and alpha-N blended with TABLES_3D_LOAD_BLEND share */
+#define SPDEN_LOAD_MODEL_BLENDED                (2)
+
+/* Load model is selected at calibration time */
+#define SPDEN_LOAD_MODEL                        (SPDEN_LOAD_MODEL_SPEED_DENSITY)
+
 /*===========================================================================*
  *
  * EXPORTED TYPES AND ENUMERATION SECTION
@@ -59,13 +70,22 @@ void SpDen_Init(void);
 void SpDen_OnTriggerInterrupt(void);
 
 /*===========================================================================*
- * brief:       Trigger ISR callback
+ * brief:       Gets engine load
+ * param[in]:   speed - engine speed in RPM
+ * param[out]:  None
+ * return:      float - engine load as absolute pressure in kPa
+ * details:     Calculated with SPDEN_LOAD_MODEL, used for all load axes of fuel and spark tables
+ *===========================================================================*/
+float SpDen_GetEngineLoad(float speed);
+
+/*===========================================================================*
+ * brief:       Check if fuel is enriched above the base fuel equation
  * param[in]:   None
  * param[out]:  None
- * return:      None
- * details:     None
+ * return:      bool - true during start, after start, warm up or acceleration enrichment
+ * details:     Lambda doesn't reflect the base fuel error while enrichment is active
  *===========================================================================*/
-void SpDen_TriggerCallback(void);
+bool SpDen_IsEnrichmentActive(void);
 
 
 #endif
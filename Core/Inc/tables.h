@@ -22,6 +22,13 @@
  *
  *===========================================================================*/
 
+#define TABLES_3D_ROWS                                  (16u)
+#define TABLES_3D_COLUMNS                               (16u)
+
+/* Per cylinder trims change slowly over the operating range, coarse tables are enough */
+#define TABLES_TRIM_ROWS                                (4u)
+#define TABLES_TRIM_COLUMNS                             (4u)
+
 /*===========================================================================*
  *
  * EXPORTED TYPES AND ENUMERATION SECTION
@@ -32,8 +39,25 @@ typedef enum Tables_3D_Tag
 {
     /* x-axis -> engine speed in [RPM], y-axis -> engine pressure in [kPa] */
     TABLES_3D_VE,
+    /* x-axis -> engine speed in [RPM], y-axis -> engine pressure in [kPa], same axes as TABLES_3D_VE */
+    /* z-axis -> 1 / target lambda, fuel multiplier */
+    TABLES_3D_TARGET_LAMBDA_RECIPROCAL,
     /* x-axis -> engine speed in [RPM], y-axis -> engine pressure in [kPa] */
     TABLES_3D_SPARK,
+    /* x-axis -> engine speed in [RPM], y-axis -> throttle position in [%] */
+    TABLES_3D_ALPHA_N_LOAD,
+    /* x-axis -> engine speed in [RPM], y-axis -> throttle position in [%] */
+    TABLES_3D_LOAD_BLEND,
+    /* x-axis -> engine speed in [RPM], y-axis -> engine pressure in [kPa] */
+    TABLES_3D_INJECTION_SPLIT_RATIO,
+    /* x-axis -> engine speed in [RPM], y-axis -> engine pressure in [kPa] */
+    TABLES_3D_INJECTION_SPLIT_ANGLE,
+    /* x-axis -> engine speed in [RPM], y-axis -> engine pressure change rate in [kPa/s] */
+    TABLES_3D_ACCEL_ENRICHMENT,
+    /* x-axis -> engine speed in [RPM], y-axis -> coolant temperature in [oC] */
+    TABLES_3D_WALL_WETTING_X,
+    /* x-axis -> engine speed in [RPM], y-axis -> coolant temperature in [oC] */
+    TABLES_3D_WALL_WETTING_TAU,
 
     TABLES_3D_COUNT
 } Tables_3D_T;
@@ -46,10 +70,56 @@ typedef enum Tables_2D_Tag
     TABLES_2D_CLT,
     /* x-axis -> temperature [oC] */
     TABLES_2D_CLT_ENRICHEMENT,
+    /* x-axis -> battery voltage in [V] */
+    TABLES_2D_DWELL,
+    /* x-axis -> engine speed in [RPM] */
+    TABLES_2D_DWELL_DUTY_LIMIT,
+    /* x-axis -> battery voltage in [V] */
+    TABLES_2D_INJECTOR_DEAD_TIME,
+    /* x-axis -> effective injector open time in [ms] */
+    TABLES_2D_INJECTOR_SHORT_PULSE,
+    /* x-axis -> coolant temperature in [oC] */
+    TABLES_2D_IDLE_TARGET_SPEED,
+    /* x-axis -> coolant temperature in [oC] */
+    TABLES_2D_IDLE_BASE_DUTY,
+    /* x-axis -> coolant temperature in [oC] */
+    TABLES_2D_SPARK_CLT_CORRECTION,
+    /* x-axis -> intake air temperature in [oC] */
+    TABLES_2D_SPARK_IAT_CORRECTION,
+    /* x-axis -> coolant temperature in [oC] */
+    TABLES_2D_PRIME_PULSE,
+    /* x-axis -> coolant temperature in [oC] */
+    TABLES_2D_CRANKING_ENRICHMENT,
+    /* x-axis -> coolant temperature in [oC] */
+    TABLES_2D_AFTER_START_ENRICHMENT,
+    /* x-axis -> coolant temperature in [oC] */
+    TABLES_2D_AFTER_START_CYCLES,
 
     TABLES_2S_COUNT
 } Tables_2D_T;
 
+/* One table for every cylinder, all trim tables share the axes */
+typedef enum Tables_Trim_Tag
+{
+    /* x-axis -> engine speed in [RPM], y-axis -> engine pressure in [kPa], z-axis -> fuel trim in [%] */
+    TABLES_TRIM_FUEL,
+    /* x-axis -> engine speed in [RPM], y-axis -> engine pressure in [kPa], z-axis -> spark advance in [deg] */
+    TABLES_TRIM_SPARK,
+
+    TABLES_TRIM_COUNT
+} Tables_Trim_T;
+
+/* Interpolated point of the 3D table */
+typedef struct Tables_3DCell_Tag
+{
+    /* Lower x-axis and y-axis indexes of the cell, y index is counted from the bottom row */
+    uint8_t xIndex;
+    uint8_t yIndex;
+    /* Position inside the cell in <0; 1> range */
+    float u;
+    float v;
+} Tables_3DCell_T;
+
 /*===========================================================================*
  *
  * EXPORTED GLOBAL VARIABLES SECTION
@@ -83,6 +153,50 @@ float Tables_Get3DTableValue(Tables_3D_T tableType, float xValue, float yValue);
  *===========================================================================*/
 float Tables_Get2DTableValue(Tables_2D_T tableType, float xValue);
 
+/*===========================================================================*
+ * brief:       Gets 3D table cell containing given x-axis and y-axis values
+ * param[in]:   tableType - specifies which table axes will be used
+ * param[in]:   xValue - x-axis value specific for given table type
+ * param[in]:   yValue - y-axis value specific for given table type
+ * param[out]:  cell - cell indexes and position used for bilinear interpolation
+ * return:      None
+ * details:     Used by maps sharing axes with the given table. Corner weights are
+ *              (1-u)(1-v), u(1-v), (1-u)v and uv, starting from the lower left corner
+ *===========================================================================*/
+void Tables_Get3DTableCell(Tables_3D_T tableType, float xValue, float yValue, Tables_3DCell_T* cell);
+
+/*===========================================================================*
+ * brief:       Gets 3D table z-axis value in the given cell
+ * param[in]:   tableType - specifies which table will be read
+ * param[in]:   cell - cell taken from Tables_Get3DTableCell for a table with the same axes
+ * param[out]:  None
+ * return:      float - z-axis value
+ * details:     Only the four corners blend is done, axes search is shared between tables
+ *===========================================================================*/
+float Tables_Get3DCellValue(Tables_3D_T tableType, const Tables_3DCell_T* cell);
+
+/*===========================================================================*
+ * brief:       Gets trim table cell containing given x-axis and y-axis values
+ * param[in]:   tableType - specifies which table axes will be used
+ * param[in]:   xValue - x-axis value specific for given table type
+ * param[in]:   yValue - y-axis value specific for given table type
+ * param[out]:  cell - cell indexes and position used for bilinear interpolation
+ * return:      None
+ * details:     Cell is valid for all cylinders and all trim tables
+ *===========================================================================*/
+void Tables_GetTrimTableCell(Tables_Trim_T tableType, float xValue, float yValue, Tables_3DCell_T* cell);
+
+/*===========================================================================*
+ * brief:       Gets cylinder trim table z-axis value in the given cell
+ * param[in]:   tableType - specifies which table will be read
+ * param[in]:   cylinder - cylinder index, counted from 0
+ * param[in]:   cell - cell taken from Tables_GetTrimTableCell
+ * param[out]:  None
+ * return:      float - z-axis value
+ * details:     Returns 0 (no trim) for cylinders without a table
+ *===========================================================================*/
+float Tables_GetTrimCellValue(Tables_Trim_T tableType, uint8_t cylinder, const Tables_3DCell_T* cell);
+
 
 #endif
 /* end of file */
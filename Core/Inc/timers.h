@@ -33,7 +33,10 @@
 /* TIM2, TIM5 -> 32bit */
 #define TIMER_IGNITION                          (TIM2)
 #define TIMER_SPEED                             (TIM3)
+#define TIMER_MAP_SAMPLING                      (TIM4)
 #define TIMER_INJECTOR                          (TIM5)
+/* TIM11 -> 16bit */
+#define TIMER_IDLE_VALVE                        (TIM11)
 
 #define TIMER_SPEED_PRESCALER                   ((uint16_t)(100U - 1U))
 #define TIMER_SPEED_CLOCK                       (TIMER_TIM_CLOCK / (TIMER_SPEED_PRESCALER + 1U))
@@ -41,6 +44,17 @@
 
 #define TIMER_SPEED_TIMER_MAX_VAL               (UINT16_MAX)
 
+/* TIMER_SPEED TRGO is routed to the event timers internal trigger inputs */
+/* TIM2 ITR2 -> TIM3 TRGO, TIM5 ITR1 -> TIM3 TRGO, TIM4 ITR2 -> TIM3 TRGO */
+#define TIMER_IGNITION_SPEED_TRIGGER            (TIM_SMCR_TS_1)
+#define TIMER_INJECTOR_SPEED_TRIGGER            (TIM_SMCR_TS_0)
+#define TIMER_MAP_SAMPLING_SPEED_TRIGGER        (TIM_SMCR_TS_1)
+
+/* Slave trigger mode: counter is started (not reset) at the rising edge of the trigger input */
+#define TIMER_SLAVE_MODE_TRIGGER                (TIM_SMCR_SMS_2 | TIM_SMCR_SMS_1)
+/* Slave external clock mode 1: counter is clocked by the rising edges of the trigger input */
+#define TIMER_SLAVE_MODE_EXTERNAL_CLOCK         (TIM_SMCR_SMS_2 | TIM_SMCR_SMS_1 | TIM_SMCR_SMS_0)
+
 /*===========================================================================*
  *
  * EXPORTED TYPES AND ENUMERATION SECTION
@@ -41,6 +41,10 @@
                                                                  (((_VAL1_) + (_VAL2_)) - (_LOOP_VAL_)) :        \
                                                                  ((_VAL1_) + (_VAL2_)))
 
+/* Saturate the value to <_MIN_; _MAX_> range */
+#define UTILS_LIMIT(_VALUE_, _MIN_, _MAX_)                      (((_VALUE_) > (_MAX_)) ? (_MAX_) :               \
+                                                                 (((_VALUE_) < (_MIN_)) ? (_MIN_) : (_VALUE_)))
+
 #define UTILS_PERCENTAGE_CONVERTER                              (100U)
 
 #define UTILS_CONVERT_TO_MILI_MULTIPL                           (1000.0F)
@@ -50,6 +54,23 @@
 /* Convert Celsius to Kelvins */
 #define UTILS_CONVERT_C_TO_K(_C_)                               (((float)(_C_)) + 273.15F)
 
+/* Core cycles counter, wraps around every ~42s at 100MHz */
+#define UTILS_GET_TIMESTAMP()                                   (DWT->CYCCNT)
+/* Convert difference of two timestamps to miliseconds */
+#define UTILS_TIMESTAMP_TO_MS(_TICKS_)                          ((float)(_TICKS_) /                            \
+                                                                 ((float)SystemCoreClock / 1000.0F))
+
+/* Update execution time statistics with the cycles elapsed since _START_ timestamp */
+#define UTILS_CYCLES_STATS_UPDATE(_STATS_, _START_)             do                                              \
+                                                                {                                               \
+                                                                    (_STATS_)->last = UTILS_GET_TIMESTAMP() -   \
+                                                                                      (_START_);                \
+                                                                    if ((_STATS_)->last > (_STATS_)->max)       \
+                                                                    {                                           \
+                                                                        (_STATS_)->max = (_STATS_)->last;       \
+                                                                    }                                           \
+                                                                } while (0)
+
 /*===========================================================================*
  *
  * EXPORTED TYPES AND ENUMERATION SECTION
@@ -63,6 +84,13 @@ typedef enum Result_Tag
 
 } Result_T;
 
+/* Execution time of a code section in core cycles, read with the debugger */
+typedef struct Utils_CyclesStats_Tag
+{
+    uint32_t last;
+    uint32_t max;
+} Utils_CyclesStats_T;
+
 /*===========================================================================*
  *
  * EXPORTED FUNCTION DECLARATION SECTION
@@ -91,6 +119,15 @@ char* Utils_Itoa(unsigned int number, unsigned int base);
  *===========================================================================*/
 uint32_t Utils_FloatToUint32(float inValue);
 
+/*===========================================================================*
+ * brief:       Start core cycles counter used for timestamps
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+void Utils_TimestampInit(void);
+
 
 #endif
 /* end of file */
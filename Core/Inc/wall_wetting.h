@@ -0,0 +1,86 @@
+/*===========================================================================*
+ * File:        wall_wetting.h
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Intake port fuel film (X-tau) transient compensation
+ *===========================================================================*/
+#ifndef _WALL_WETTING_H_
+#define _WALL_WETTING_H_
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "common_include.h"
+
+#include "engine_constants.h"
+
+/*===========================================================================*
+ *
+ * EXPORTED DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED GLOBAL VARIABLES SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * EXPORTED FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Initialize wall wetting module
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+void WallWet_Init(void);
+
+/*===========================================================================*
+ * brief:       Forget fuel film of all cylinders
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Needs to be called when the engine stops, film evaporates before the next start
+ *===========================================================================*/
+void WallWet_Reset(void);
+
+/*===========================================================================*
+ * brief:       Update film parameters with the current engine speed and coolant temperature
+ * param[in]:   speed - engine speed in RPM
+ * param[out]:  None
+ * return:      None
+ * details:     Needs to be called once per engine cycle, table lookups and divisions are done here
+ *===========================================================================*/
+void WallWet_Update(float speed);
+
+/*===========================================================================*
+ * brief:       Compensate cylinder fuel for the intake port film
+ * param[in]:   channel - cylinder channel
+ * param[in]:   fuelMs - fuel requested in the cylinder, as effective injector open time in ms
+ * param[out]:  None
+ * return:      float - effective injector open time in ms, without dead time
+ * details:     Needs to be called once per cylinder injection event. Film is updated with the
+ *              returned fuel, so the call can't be repeated for the same event. Fuel cut event
+ *              is passed as 0ms, the film then only evaporates
+ *===========================================================================*/
+float WallWet_Compensate(EnCon_CylinderChannels_T channel, float fuelMs);
+
+
+#endif
+/* end of file */
@@ -0,0 +1,110 @@
+/*===========================================================================*
+ * File:        cylinder_trim.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Per cylinder fuel and spark trims
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "cylinder_trim.h"
+
+#include "tables.h"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * LOCAL TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+/* Values for the current operating point */
+static float cyltrim_fuel_multipliers[ENCON_CHANNEL_COUNT];
+static float cyltrim_spark_advances[ENCON_CHANNEL_COUNT];
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: CylTrim_Init
+ *===========================================================================*/
+void CylTrim_Init(void)
+{
+    EnCon_CylinderChannels_T channel;
+
+    for (channel = ENCON_CHANNEL_1; channel < ENCON_CHANNEL_COUNT; channel++)
+    {
+        cyltrim_fuel_multipliers[channel] = 1.0F;
+        cyltrim_spark_advances[channel] = 0.0F;
+    }
+}
+
+/*===========================================================================*
+ * Function: CylTrim_Update
+ *===========================================================================*/
+void CylTrim_Update(float speed, float pressure)
+{
+    EnCon_CylinderChannels_T channel;
+    Tables_3DCell_T cell;
+
+    /* Fuel and spark trim tables of all cylinders share axes, so the cell is searched once */
+    Tables_GetTrimTableCell(TABLES_TRIM_FUEL, speed, pressure, &cell);
+
+    for (channel = ENCON_CHANNEL_1; channel < ENCON_CHANNEL_COUNT; channel++)
+    {
+        cyltrim_fuel_multipliers[channel] = 1.0F + (Tables_GetTrimCellValue(TABLES_TRIM_FUEL, (uint8_t)channel,
+                                                                            &cell) /
+                                                    (float)UTILS_PERCENTAGE_CONVERTER);
+        cyltrim_spark_advances[channel] = Tables_GetTrimCellValue(TABLES_TRIM_SPARK, (uint8_t)channel, &cell);
+    }
+}
+
+/*===========================================================================*
+ * Function: CylTrim_GetFuelMultiplier
+ *===========================================================================*/
+float CylTrim_GetFuelMultiplier(EnCon_CylinderChannels_T channel)
+{
+    return cyltrim_fuel_multipliers[channel];
+}
+
+/*===========================================================================*
+ * Function: CylTrim_GetSparkAdvance
+ *===========================================================================*/
+float CylTrim_GetSparkAdvance(EnCon_CylinderChannels_T channel)
+{
+    return cyltrim_spark_advances[channel];
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+
+/* end of file */
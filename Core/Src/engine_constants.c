@@ -113,6 +113,28 @@ void EnCon_UpdateEngineSpeed(uint32_t speed)
     encon_engine_speed_rpm = ENCON_SPEED_UNKNOWN;
 }
 
+/*===========================================================================*
+ * Function: EnCon_ConvertTimeToAngle
+ *===========================================================================*/
+float EnCon_ConvertTimeToAngle(float timeMs)
+{
+    uint32_t speedRaw;
+    float angle;
+
+    speedRaw = encon_engine_speed_raw;
+
+    if ((ENCON_SPEED_RAW_UNKNOWN == speedRaw) || (0U == speedRaw))
+    {
+        angle = ENCON_ANGLE_UNKNOWN;
+    }
+    else
+    {
+        angle = (((timeMs / TIMER_MS_IN_S) * TIMER_SPEED_CLOCK) / (float)speedRaw) * ENCON_ONE_TRIGGER_PULSE_ANGLE;
+    }
+
+    return angle;
+}
+
 /*===========================================================================*
  *
  * LOCAL FUNCTION DEFINITION SECTION
@@ -14,7 +14,12 @@
 
 #include "engine_sensors.h"
 
+#include "engine_constants.h"
+#include "knock.h"
 #include "tables.h"
+#include "timers.h"
+
+#include "arm_math.h"
 
 /*===========================================================================*
  *
@@ -23,14 +28,93 @@
  *===========================================================================*/
 
 #define ENSENS_ADC_12_BIT_RESOLUTION            (4096U)
+#define ENSENS_ADC_BITS                         (12U)
 #define ENSENS_ADC_REFERENCE_VOLTAGE_V          (3.3F)
 #define ENSENS_ADC_REFERENCE_VOLTAGE_MV         (3300.0F)
 
+#define ENSENS_ADC_MAX_CODE                     ((float)(ENSENS_ADC_12_BIT_RESOLUTION - 1U))
+/* Filter overshoot may exceed ADC codes range */
+#define ENSENS_ADC_CLAMP_CODE(_CODE_)           (((_CODE_) < 0.0F) ? 0.0F :                                    \
+                                                 (((_CODE_) > ENSENS_ADC_MAX_CODE) ? ENSENS_ADC_MAX_CODE : (_CODE_)))
+
 #define ENSENS_ADC_CALCULATE_VOLTAGE_MV(_REG_)  ((((float)(_REG_)) / ENSENS_ADC_12_BIT_RESOLUTION) *        \
                                                  ENSENS_ADC_REFERENCE_VOLTAGE_MV)
 
-/* Pierburg 7.18222.01.0 MAP sensor */
-#define ENSENS_CALCULATE_MAP_KPA(_MV_)          ((((float)(_MV_)) * 0.0280643351F + 10.1656376410F))
+/* ADC registers layout: channels per SQR3/SQR2 and SMPR2 registers, bits per channel */
+#define ENSENS_ADC_SQR_CHANNELS                 (6U)
+#define ENSENS_ADC_SQR_BITS                     (5U)
+#define ENSENS_ADC_SMPR_CHANNELS                (10U)
+#define ENSENS_ADC_SMPR_BITS                    (3U)
+
+/* ADC1_2 on PA2 */
+#define ENSENS_ADC_KNOCK_CHANNEL                (2U)
+
+#if ENSENS_KNOCK_SENSOR_ENABLED
+/* Sequence is split into groups converted one per timer event (discontinuous mode). Knock sensor is */
+/* converted first in every group, so it's sampled ENSENS_ADC_GROUPS_NO times more often than others */
+#define ENSENS_ADC_GROUP_SIZE                   (3U)
+#define ENSENS_ADC_GROUP_KNOCK_SLOTS            (1U)
+#else
+/* Whole sequence is converted at every timer event */
+#define ENSENS_ADC_GROUP_SIZE                   (ENSENS_SENSOR_COUNT)
+#define ENSENS_ADC_GROUP_KNOCK_SLOTS            (0U)
+#endif
+#define ENSENS_ADC_GROUP_SENSORS                (ENSENS_ADC_GROUP_SIZE - ENSENS_ADC_GROUP_KNOCK_SLOTS)
+#define ENSENS_ADC_GROUPS_NO                    ((ENSENS_SENSOR_COUNT + ENSENS_ADC_GROUP_SENSORS - 1U) /       \
+                                                 ENSENS_ADC_GROUP_SENSORS)
+/* Unused slots of the last group are filled with knock channel, SQR2 and SQR3 fit 12 conversions */
+#define ENSENS_ADC_SEQUENCE_LENGTH              (ENSENS_ADC_GROUPS_NO * ENSENS_ADC_GROUP_SIZE)
+#define ENSENS_ADC_SENSOR_SLOT(_SENSOR_)        ((((_SENSOR_) / ENSENS_ADC_GROUP_SENSORS) * ENSENS_ADC_GROUP_SIZE) + \
+                                                 ENSENS_ADC_GROUP_KNOCK_SLOTS +                                  \
+                                                 ((_SENSOR_) % ENSENS_ADC_GROUP_SENSORS))
+
+/* Regular channels are sampled continuously, TIM1 CC1 event starts conversion of the next group */
+#define ENSENS_ADC_TIMER                        (TIM1)
+#define ENSENS_ADC_TIMER_PRESCALER              ((uint16_t)0U)
+#define ENSENS_ADC_TIMER_CLOCK_HZ               (100000000U)
+/* Whole sequence is converted at 10kHz */
+#define ENSENS_ADC_SEQUENCE_FREQUENCY_HZ        (10000U)
+#define ENSENS_ADC_TIMER_PERIOD                 ((ENSENS_ADC_TIMER_CLOCK_HZ / ENSENS_ADC_SEQUENCE_FREQUENCY_HZ) /  \
+                                                 ENSENS_ADC_GROUPS_NO)
+
+/* Scans of regular sequence in one DMA buffer: 1.6 ms at 10kHz */
+#define ENSENS_ADC_SCANS_PER_BUFFER             (16U)
+#define ENSENS_ADC_BUFFER_SIZE                  (ENSENS_ADC_SCANS_PER_BUFFER * ENSENS_ADC_SEQUENCE_LENGTH)
+
+/* Each sensor is filtered with cascade of up to 2 biquads (4th order) */
+#define ENSENS_FILTER_STAGES_MAX                (2U)
+/* Direct form I keeps 4 state variables per stage */
+#define ENSENS_FILTER_STATE_SIZE                (4U * ENSENS_FILTER_STAGES_MAX)
+/* Coefficients per stage: b0, b1, b2, a1, a2 (a coefficients negated) */
+#define ENSENS_FILTER_STAGE_COEFFS              (5U)
+
+/* Number of consecutive samples sets out of range before the fault is latched */
+#define ENSENS_RANGE_FAULT_DEBOUNCE             (10U)
+/* Number of consecutive good samples sets before the substitute value is dropped: 1 s */
+#define ENSENS_FAULT_HEAL_SETS                  (625U)
+
+/* MAP samples history has to cover the longest intake stroke: 150 ms at 200 RPM, power of 2 */
+#define ENSENS_MAP_HISTORY_SIZE                 (2048U)
+#define ENSENS_MAP_HISTORY_MASK                 (ENSENS_MAP_HISTORY_SIZE - 1U)
+
+/* Knock samples history has to cover the window and one DMA buffer, power of 2 */
+#define ENSENS_KNOCK_HISTORY_SIZE               (1024U)
+#define ENSENS_KNOCK_HISTORY_MASK               (ENSENS_KNOCK_HISTORY_SIZE - 1U)
+
+/* ADC injected conversion external trigger: TIM4 TRGO */
+#define ENSENS_ADC_JEXTSEL_TIM4_TRGO            (ADC_CR2_JEXTSEL_3 | ADC_CR2_JEXTSEL_0)
+
+/* MAP is sampled once per intake stroke */
+#define ENSENS_MAP_SAMPLING_PERIOD_PULSES       ((ENCON_ENGINE_FULL_CYCLE_ANGLE / (float)ENCON_ENGINE_PISTONS_NO) /    \
+                                                 ENCON_ONE_TRIGGER_PULSE_ANGLE)
+
+/* Conversion LUTs are indexed by the top ADC code bits, low bits are interpolated */
+#define ENSENS_LUT_INDEX_BITS                   (6U)
+#define ENSENS_LUT_FRACTION_BITS                (ENSENS_ADC_BITS - ENSENS_LUT_INDEX_BITS)
+#define ENSENS_LUT_FRACTION_MULTIPLIER          (1.0F / (float)(1U << ENSENS_LUT_FRACTION_BITS))
+/* One more point for the upper edge of the last segment */
+#define ENSENS_LUT_SIZE                         ((1U << ENSENS_LUT_INDEX_BITS) + 1U)
+
 
 /*===========================================================================*
  *
@@ -38,15 +122,112 @@
  *
  *===========================================================================*/
 
-/* Sync with "ensens_sensors_data" and ADC conversion sequence */
-typedef enum EnSens_DataIndex_Tag
+typedef enum EnSens_WindowState_Tag
+{
+    ENSENS_WINDOW_STATE_IDLE,
+    /* Window start sample is marked */
+    ENSENS_WINDOW_STATE_OPEN,
+    /* Window end sample is marked, average will be calculated when all samples are available */
+    ENSENS_WINDOW_STATE_CLOSED,
+
+    ENSENS_WINDOW_STATE_COUNT
+} EnSens_WindowState_T;
+
+typedef enum EnSens_Lut_Tag
+{
+    /* Temperature in Kelvin */
+    ENSENS_LUT_IAT,
+    /* IAT reciprocal in 1/K, interpolated so the fuel calculation doesn't need a division */
+    ENSENS_LUT_IAT_RECIPROCAL,
+    /* Temperature in Kelvin */
+    ENSENS_LUT_CLT,
+    /* Enrichement percentage */
+    ENSENS_LUT_CLT_ENRICHEMENT,
+
+    ENSENS_LUT_COUNT
+} EnSens_Lut_T;
+
+/* Values of ADC SMPRx register fields */
+typedef enum EnSens_SampleTime_Tag
+{
+    ENSENS_SAMPLE_TIME_3_CYCLES,
+    ENSENS_SAMPLE_TIME_15_CYCLES,
+    ENSENS_SAMPLE_TIME_28_CYCLES,
+    ENSENS_SAMPLE_TIME_56_CYCLES,
+    ENSENS_SAMPLE_TIME_84_CYCLES,
+    ENSENS_SAMPLE_TIME_112_CYCLES,
+    ENSENS_SAMPLE_TIME_144_CYCLES,
+    ENSENS_SAMPLE_TIME_480_CYCLES,
+
+    ENSENS_SAMPLE_TIME_COUNT
+} EnSens_SampleTime_T;
+
+typedef enum EnSens_CurveType_Tag
+{
+    /* value = gain * voltage[mV] + offset */
+    ENSENS_CURVE_TYPE_LINEAR,
+    /* Conversion table built from calibration table */
+    ENSENS_CURVE_TYPE_LUT,
+
+    ENSENS_CURVE_TYPE_COUNT
+} EnSens_CurveType_T;
+
+typedef struct EnSens_FilterConfig_Tag
+{
+    /* 0 - sensor is not filtered, only the last sample of the buffer is used */
+    uint8_t stagesNo;
+    float32_t coeffs[ENSENS_FILTER_STAGES_MAX * ENSENS_FILTER_STAGE_COEFFS];
+} EnSens_FilterConfig_T;
+
+typedef struct EnSens_DiagnosticConfig_Tag
+{
+    /* Plausible voltage range */
+    float minMv;
+    float maxMv;
+    /* Maximum change between samples sets, 0 - not checked */
+    float maxRateMv;
+    /* Number of samples sets with the same ADC code, 0 - not checked */
+    uint16_t stuckSetsNo;
+    /* Value in sensor units returned when sensor is faulty */
+    float substituteValue;
+} EnSens_DiagnosticConfig_T;
+
+typedef struct EnSens_DiagnosticState_Tag
+{
+    float lastMv;
+    uint16_t lastCode;
+    uint16_t rangeCounter;
+    uint16_t stuckCounter;
+    uint16_t healCounter;
+} EnSens_DiagnosticState_T;
+
+typedef struct EnSens_ChannelConfig_Tag
 {
-    ENSENS_DATA_INDEX_MAP = 0,
-    ENSENS_DATA_INDEX_IAT = 1,
-    ENSENS_DATA_INDEX_CLT = 2,
+    GPIO_TypeDef* port;
+    uint8_t pin;
+    uint8_t adcChannel;
+    EnSens_SampleTime_T sampleTime;
+    EnSens_CurveType_T curveType;
+    float gain;
+    float offset;
+    EnSens_Lut_T lut;
+    EnSens_FilterConfig_T filter;
+    EnSens_DiagnosticConfig_T diagnostic;
+} EnSens_ChannelConfig_T;
 
-    ENSENS_DATA_INDEX_COUNT
-} EnSens_DataIndex_T;
+/* Values derived from one set of sensors samples */
+typedef struct EnSens_DerivedValues_Tag
+{
+    /* Samples generation the values were calculated from */
+    uint32_t generation;
+    /* MAP is not updated here */
+    float values[ENSENS_SENSOR_COUNT];
+    float iatReciprocal;
+    float cltEnrichment;
+    /* MAP has also sources independent of the samples set, it's cached by the ADC code */
+    float mapRaw;
+    float map;
+} EnSens_DerivedValues_T;
 
 /*===========================================================================*
  *
@@ -54,7 +235,238 @@ typedef enum EnSens_DataIndex_Tag
  *
  *===========================================================================*/
 
-static volatile uint16_t ensens_sensors_data[ENSENS_DATA_INDEX_COUNT];
+/* Filters are Butterworth low-pass designed for 10kHz sampling */
+static const EnSens_ChannelConfig_T ensens_channels_config[ENSENS_SENSOR_COUNT] =
+{
+    /* MAP: Pierburg 7.18222.01.0, kPa */
+    {
+        .port = GPIOA,
+        .pin = 5U,
+        .adcChannel = 5U,
+        .sampleTime = ENSENS_SAMPLE_TIME_15_CYCLES,
+        .curveType = ENSENS_CURVE_TYPE_LINEAR,
+        .gain = 0.0280643351F,
+        .offset = 10.1656376410F,
+        /* 2nd order, 1kHz, keeps intake stroke pressure shape for window averaging */
+        .filter =
+        {
+            .stagesNo = 1U,
+            .coeffs =
+            {
+                6.745527685e-02F, 1.349105537e-01F, 6.745527685e-02F, 1.142980456e+00F, -4.128015935e-01F
+            }
+        },
+        /* Sensor output doesn't reach ADC limit, rate isn't checked due to intake pulsation */
+        .diagnostic =
+        {
+            .minMv = 100.0F,
+            .maxMv = ENSENS_ADC_REFERENCE_VOLTAGE_MV,
+            .maxRateMv = 0.0F,
+            .stuckSetsNo = 1250U,
+            .substituteValue = 100.0F
+        }
+    },
+    /* IAT: Kelvin */
+    {
+        .port = GPIOA,
+        .pin = 7U,
+        .adcChannel = 7U,
+        .sampleTime = ENSENS_SAMPLE_TIME_84_CYCLES,
+        .curveType = ENSENS_CURVE_TYPE_LUT,
+        .lut = ENSENS_LUT_IAT,
+        /* 4th order, 50Hz */
+        .filter =
+        {
+            .stagesNo = 2U,
+            .coeffs =
+            {
+                2.397619828e-04F, 4.795239656e-04F, 2.397619828e-04F, 1.942638278e+00F, -9.435972571e-01F,
+                2.437893709e-04F, 4.875787417e-04F, 2.437893709e-04F, 1.975269675e+00F, -9.762448072e-01F
+            }
+        },
+        .diagnostic =
+        {
+            .minMv = 100.0F,
+            .maxMv = 3200.0F,
+            .maxRateMv = 200.0F,
+            .stuckSetsNo = 0U,
+            .substituteValue = UTILS_CONVERT_C_TO_K(20.0F)
+        }
+    },
+    /* CLT: Kelvin */
+    {
+        .port = GPIOB,
+        .pin = 0U,
+        .adcChannel = 8U,
+        .sampleTime = ENSENS_SAMPLE_TIME_84_CYCLES,
+        .curveType = ENSENS_CURVE_TYPE_LUT,
+        .lut = ENSENS_LUT_CLT,
+        /* 4th order, 50Hz */
+        .filter =
+        {
+            .stagesNo = 2U,
+            .coeffs =
+            {
+                2.397619828e-04F, 4.795239656e-04F, 2.397619828e-04F, 1.942638278e+00F, -9.435972571e-01F,
+                2.437893709e-04F, 4.875787417e-04F, 2.437893709e-04F, 1.975269675e+00F, -9.762448072e-01F
+            }
+        },
+        .diagnostic =
+        {
+            .minMv = 100.0F,
+            .maxMv = 3200.0F,
+            .maxRateMv = 200.0F,
+            .stuckSetsNo = 0U,
+            .substituteValue = UTILS_CONVERT_C_TO_K(80.0F)
+        }
+    },
+    /* VBAT: 10k / 1k divider, V */
+    {
+        .port = GPIOB,
+        .pin = 1U,
+        .adcChannel = 9U,
+        .sampleTime = ENSENS_SAMPLE_TIME_84_CYCLES,
+        .curveType = ENSENS_CURVE_TYPE_LINEAR,
+        .gain = 0.011F,
+        .offset = 0.0F,
+        /* 2nd order, 50Hz */
+        .filter =
+        {
+            .stagesNo = 1U,
+            .coeffs =
+            {
+                2.413590555e-04F, 4.827181110e-04F, 2.413590555e-04F, 1.955578208e+00F, -9.565436840e-01F
+            }
+        },
+        /* 3.3V - 33V */
+        .diagnostic =
+        {
+            .minMv = 300.0F,
+            .maxMv = 3000.0F,
+            .maxRateMv = 0.0F,
+            .stuckSetsNo = 0U,
+            .substituteValue = 13.5F
+        }
+    },
+#if ENSENS_TPS_LAMBDA_SENSORS_ENABLED
+    /* TPS: 330mV closed, 2970mV wide open, % */
+    {
+        .port = GPIOA,
+        .pin = 4U,
+        .adcChannel = 4U,
+        .sampleTime = ENSENS_SAMPLE_TIME_28_CYCLES,
+        .curveType = ENSENS_CURVE_TYPE_LINEAR,
+        .gain = 0.0378787879F,
+        .offset = -12.5F,
+        .filter = { .stagesNo = 0U },
+        .diagnostic =
+        {
+            .minMv = 150.0F,
+            .maxMv = 3150.0F,
+            .maxRateMv = 0.0F,
+            .stuckSetsNo = 0U,
+            .substituteValue = 0.0F
+        }
+    },
+    /* Wideband lambda controller analog output: 0mV - 0.5, 3300mV - 1.5 */
+    {
+        .port = GPIOA,
+        .pin = 6U,
+        .adcChannel = 6U,
+        .sampleTime = ENSENS_SAMPLE_TIME_28_CYCLES,
+        .curveType = ENSENS_CURVE_TYPE_LINEAR,
+        .gain = 0.000303030303F,
+        .offset = 0.5F,
+        .filter = { .stagesNo = 0U },
+        /* Whole ADC range is valid */
+        .diagnostic =
+        {
+            .minMv = 0.0F,
+            .maxMv = ENSENS_ADC_REFERENCE_VOLTAGE_MV,
+            .maxRateMv = 0.0F,
+            .stuckSetsNo = 0U,
+            .substituteValue = 1.0F
+        }
+    },
+#endif
+#if ENSENS_OIL_PRESSURE_SENSOR_ENABLED
+    /* Oil pressure: 0.5V - 4.5V sensor through 2/3 divider, 0 - 1000kPa */
+    {
+        .port = GPIOA,
+        .pin = 3U,
+        .adcChannel = 3U,
+        .sampleTime = ENSENS_SAMPLE_TIME_28_CYCLES,
+        .curveType = ENSENS_CURVE_TYPE_LINEAR,
+        .gain = 0.375F,
+        .offset = -125.0F,
+        .filter = { .stagesNo = 0U },
+        .diagnostic =
+        {
+            .minMv = 150.0F,
+            .maxMv = 3150.0F,
+            .maxRateMv = 0.0F,
+            .stuckSetsNo = 0U,
+            .substituteValue = 0.0F
+        }
+    },
+#endif
+};
+
+static arm_biquad_casd_df1_inst_f32 ensens_filters[ENSENS_SENSOR_COUNT];
+static float32_t ensens_filters_state[ENSENS_SENSOR_COUNT][ENSENS_FILTER_STATE_SIZE];
+/* Filters state is set to the first samples to avoid start-up transient */
+static bool ensens_is_filters_primed;
+
+static EnSens_DiagnosticState_T ensens_diagnostic_states[ENSENS_SENSOR_COUNT];
+/* Latched faults masks, kept for diagnostics until cleared */
+static volatile uint32_t ensens_faults[ENSENS_SENSOR_COUNT];
+/* Active faults masks, sensor is substituted until it heals */
+static volatile uint32_t ensens_active_faults[ENSENS_SENSOR_COUNT];
+
+/* Last filtered sample of each sensor in ADC codes */
+static volatile float ensens_sensors_data[ENSENS_SENSOR_COUNT];
+/* Incremented every time new samples set is available */
+static volatile uint32_t ensens_samples_generation;
+
+/* Derived values cache, read and updated only from the main loop: trigger processing (SpDen_OnTriggerInterrupt) */
+/* and background tasks (FuelTrim_OnBackgroundTask, Idle_OnBackgroundTask). The DMA2 stream 0 interrupt */
+/* only increments the samples generation, which can happen in the middle of an update */
+static EnSens_DerivedValues_T ensens_derived_values;
+
+/* ADC code to engineering unit conversion tables, built from calibration tables */
+static float ensens_luts[ENSENS_LUT_COUNT][ENSENS_LUT_SIZE];
+
+/* DMA double buffer, interleaved in ADC conversion sequence order */
+static volatile uint16_t ensens_adc_buffers[2U][ENSENS_ADC_BUFFER_SIZE];
+
+static q15_t ensens_map_history[ENSENS_MAP_HISTORY_SIZE];
+/* Number of MAP samples written to the history since start, wraps around */
+static volatile uint32_t ensens_map_samples_count;
+
+static volatile EnSens_WindowState_T ensens_map_window_state;
+static volatile uint32_t ensens_map_window_start;
+static volatile uint32_t ensens_map_window_end;
+/* MAP raw value averaged over the last intake window */
+static volatile uint16_t ensens_map_window_average;
+static volatile bool ensens_is_map_window_average_valid;
+
+#if ENSENS_KNOCK_SENSOR_ENABLED
+static q15_t ensens_knock_history[ENSENS_KNOCK_HISTORY_SIZE];
+/* Number of knock samples written to the history since start, wraps around */
+static volatile uint32_t ensens_knock_samples_count;
+/* Window samples passed to the knock module */
+static float32_t ensens_knock_window[KNOCK_WINDOW_SAMPLES_MAX];
+
+static volatile EnSens_WindowState_T ensens_knock_window_state;
+static volatile EnCon_CylinderChannels_T ensens_knock_window_channel;
+static volatile uint32_t ensens_knock_window_start;
+static volatile uint32_t ensens_knock_window_end;
+#endif
+
+/* Crank angle synchronous MAP sampling requires intake strokes aligned with speed signal pulses */
+static bool ensens_is_map_sampling_supported;
+static uint32_t ensens_map_sampling_period;
+static bool ensens_is_map_sampling_aligned;
 
 /*===========================================================================*
  *
@@ -76,10 +488,153 @@ extern void ADC_IRQHandler(void);
  * param[in]:   None
  * param[out]:  None
  * return:      None
- * details:     None
+ * details:     ADC buffer is full, runs at the lowest priority
  *===========================================================================*/
 extern void DMA2_Stream0_IRQHandler(void);
 
+/*===========================================================================*
+ * brief:       Initialize crank angle synchronous MAP sampling
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     TIM4 counts speed signal pulses (TIM3 TRGO) and its update event triggers
+ *              ADC injected conversion of MAP channel once per intake stroke
+ *===========================================================================*/
+static void EnSens_MapSamplingInit(void);
+
+/*===========================================================================*
+ * brief:       Build ADC code conversion tables
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Needs to be called again when calibration tables are changed
+ *===========================================================================*/
+static void EnSens_BuildLuts(void);
+
+/*===========================================================================*
+ * brief:       Convert ADC code using conversion table
+ * param[in]:   lut - conversion table
+ * param[in]:   adcCode - 12 bit ADC code, fractional part is interpolated
+ * param[out]:  None
+ * return:      float - converted value
+ * details:     None
+ *===========================================================================*/
+static float EnSens_ConvertWithLut(EnSens_Lut_T lut, float adcCode);
+
+/*===========================================================================*
+ * brief:       Convert ADC code using sensor conversion curve
+ * param[in]:   sensor - sensor to be processed
+ * param[in]:   adcCode - 12 bit ADC code
+ * param[out]:  None
+ * return:      float - value in sensor units
+ * details:     None
+ *===========================================================================*/
+static float EnSens_ConvertChannel(EnSens_Sensor_T sensor, float adcCode);
+
+/*===========================================================================*
+ * brief:       Configure sensors pins and ADC regular sequence
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Sequence order follows "ensens_channels_config"
+ *===========================================================================*/
+static void EnSens_ChannelsInit(void);
+
+/*===========================================================================*
+ * brief:       Recalculate derived values if new samples set is available
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+static void EnSens_UpdateDerivedValues(void);
+
+/*===========================================================================*
+ * brief:       Initialize sensors filters
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+static void EnSens_FiltersInit(void);
+
+/*===========================================================================*
+ * brief:       Filter samples of one sensor from the DMA buffer
+ * param[in]:   sensor - sensor to be processed
+ * param[in]:   buffer - complete DMA buffer
+ * param[out]:  filtered - filtered samples, ENSENS_ADC_SCANS_PER_BUFFER long
+ * return:      None
+ * details:     Whole buffer is processed with one block call
+ *===========================================================================*/
+static void EnSens_FilterSamples(EnSens_Sensor_T sensor, volatile const uint16_t* buffer, float32_t* filtered);
+
+#if ENSENS_KNOCK_SENSOR_ENABLED
+/*===========================================================================*
+ * brief:       Gets index of the knock sample being converted
+ * param[in]:   None
+ * param[out]:  None
+ * return:      uint32_t - sample index in knock history, wraps around
+ * details:     None
+ *===========================================================================*/
+static uint32_t EnSens_GetKnockSampleIndex(void);
+
+/*===========================================================================*
+ * brief:       Store knock samples of the DMA buffer and process completed window
+ * param[in]:   buffer - complete DMA buffer
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+static void EnSens_ProcessKnockSamples(volatile const uint16_t* buffer);
+#endif
+
+/*===========================================================================*
+ * brief:       Check sensor plausibility with the last samples set
+ * param[in]:   sensor - sensor to be checked
+ * param[in]:   code - last ADC code of the samples set, not filtered
+ * param[out]:  None
+ * return:      None
+ * details:     Checks are incremental, run once per samples set. Faults are latched, active faults are
+ *              healed after ENSENS_FAULT_HEAL_SETS good samples sets
+ *===========================================================================*/
+static void EnSens_CheckSensor(EnSens_Sensor_T sensor, uint16_t code);
+
+/*===========================================================================*
+ * brief:       Initialize timer triggering regular channels conversion
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+static void EnSens_AdcTimerInit(void);
+
+/*===========================================================================*
+ * brief:       (Re)start ADC DMA stream
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+static void EnSens_DmaStart(void);
+
+/*===========================================================================*
+ * brief:       Gets index of the next MAP sample
+ * param[in]:   None
+ * param[out]:  None
+ * return:      uint32_t - index of the MAP sample which will be converted next
+ * details:     Samples already transfered to the DMA buffer are included
+ *===========================================================================*/
+static uint32_t EnSens_GetMapSampleIndex(void);
+
+/*===========================================================================*
+ * brief:       Calculate MAP average of the closed window
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+static void EnSens_CalculateMapWindowAverage(void);
+
 /*===========================================================================*
  *
  * FUNCTION DEFINITION SECTION
@@ -91,22 +646,11 @@ extern void DMA2_Stream0_IRQHandler(void);
  *===========================================================================*/
 void EnSens_Init(void)
 {
-    /* MAP pin: PA5 (ADC1_5) */
-    /* IAT pin: PA7 (ADC1_7) */
-    /* CLT pin: PB0 (ADC1_8) */
+    EnSens_BuildLuts();
+    EnSens_FiltersInit();
 
     /* Enable ADC clock */
     RCC->APB2ENR |= RCC_APB2ENR_ADC1EN;
-    /* Enable GPIOA clock */
-    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN;
-    /* Enable GPIOB clock */
-    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOBEN;
-    /* Set port PA5 in analog mode */
-    GPIOA->MODER |= GPIO_MODER_MODER5;
-    /* Set port PA7 in analog mode */
-    GPIOA->MODER |= GPIO_MODER_MODER7;
-    /* Set port PB0 in analog mode */
-    GPIOB->MODER |= GPIO_MODER_MODER0;
 
     /* Set ADC clock to 25[MHz] (100MHz / 4) */
     ADC->CCR |= ADC_CCR_ADCPRE_0;
@@ -115,9 +659,18 @@ void EnSens_Init(void)
     ADC1->CR1 &= ~ADC_CR1_RES;
     /* Enable scan mode */
     ADC1->CR1 |= ADC_CR1_SCAN;
+#if ENSENS_KNOCK_SENSOR_ENABLED
+    /* Convert one group of the sequence per trigger */
+    ADC1->CR1 |= ADC_CR1_DISCEN;
+    ADC1->CR1 |= ((ENSENS_ADC_GROUP_SIZE - 1U) << ADC_CR1_DISCNUM_Pos);
+#endif
 
-    /* Set single conversion mode */
+    /* Set single conversion mode, each sequence is started by the timer */
     ADC1->CR2 &= ~ADC_CR2_CONT;
+    /* Select TIM1 CC1 event as regular conversion trigger */
+    ADC1->CR2 &= ~ADC_CR2_EXTSEL;
+    /* Enable regular conversion trigger on rising edge */
+    ADC1->CR2 |= ADC_CR2_EXTEN_0;
     /* Set End Of Conversion flag at the end of each conversion*/
     ADC1->CR2 |= ADC_CR2_EOCS;
     /* Set right data alignment */
@@ -129,23 +682,7 @@ void EnSens_Init(void)
     /* Enable continuous DMA requests */
     ADC1->CR2 |= ADC_CR2_DDS;
 
-    /* Set channel 5 sample time to 3 cycles */
-    ADC1->SMPR2 &= ~ADC_SMPR2_SMP5;
-    /* Set channel 7 sample time to 3 cycles */
-    ADC1->SMPR2 &= ~ADC_SMPR2_SMP7;
-    /* Set channel 8 sample time to 3 cycles */
-    ADC1->SMPR2 &= ~ADC_SMPR2_SMP8;
-
-    /* Set total conversion number to 3 */
-    ADC1->SQR1 |= ADC_SQR1_L_1;
-
-    /* Select regular channels sequence */
-    /* Set channel 5 as 1st */
-    ADC1->SQR3 |= (0x05 << ADC_SQR3_SQ1_Pos);
-    /* Set channel 7 as 2nd */
-    ADC1->SQR3 |= (0x07 << ADC_SQR3_SQ2_Pos);
-    /* Set channel 8 as 3rd */
-    ADC1->SQR3 |= (0x08 << ADC_SQR3_SQ3_Pos);
+    EnSens_ChannelsInit();
 
     /* Enable AD converter */
     ADC1->CR2 |= ADC_CR2_ADON;
@@ -155,8 +692,8 @@ void EnSens_Init(void)
 
     /* Set direction to peripherial to memory */
     DMA2_Stream0->CR &= ~DMA_SxCR_DIR;
-    /* Enable circular mode */
-    DMA2_Stream0->CR |= DMA_SxCR_CIRC;
+    /* Enable double buffer mode (circular mode is enabled by hardware) */
+    DMA2_Stream0->CR |= DMA_SxCR_DBM;
     /* Enable memory address increment */
     DMA2_Stream0->CR |= DMA_SxCR_MINC;
     /* Set peripherial data size: 16bit */
@@ -165,27 +702,172 @@ void EnSens_Init(void)
     DMA2_Stream0->CR |= DMA_SxCR_MSIZE_0;
     /* Select channel 0 (ADC) */
     DMA2_Stream0->CR &= ~DMA_SxCR_CHSEL;
+    /* Enable transfer complete interrupt */
+    DMA2_Stream0->CR |= DMA_SxCR_TCIE;
 
-    /* Set number of data registers */
-    DMA2_Stream0->NDTR = ENSENS_DATA_INDEX_COUNT;
-    /* Set peripherial adress */
-    DMA2_Stream0->PAR = (uint32_t)&ADC1->DR;
-    /* Set memory adress */
-    DMA2_Stream0->M0AR = (uint32_t)&ensens_sensors_data[0];
+    /* Buffers are processed at the lowest priority */
+    NVIC_SetPriority(DMA2_Stream0_IRQn, 15U);
+    NVIC_ClearPendingIRQ(DMA2_Stream0_IRQn);
+    NVIC_EnableIRQ(DMA2_Stream0_IRQn);
 
-    /* Enable DMA */
-    DMA2_Stream0->CR |= DMA_SxCR_EN;
+    /* Cache is outdated until the first samples set is converted */
+    ensens_samples_generation = 1U;
+    ensens_derived_values.generation = 0U;
+    ensens_derived_values.mapRaw = 0.0F;
+    ensens_derived_values.map = EnSens_ConvertChannel(ENSENS_SENSOR_MAP, 0.0F);
+
+    EnSens_ClearFaults();
+
+#if ENSENS_KNOCK_SENSOR_ENABLED
+    ensens_knock_samples_count = 0U;
+    ensens_knock_window_state = ENSENS_WINDOW_STATE_IDLE;
+#endif
+
+    ensens_map_samples_count = 0U;
+    ensens_map_window_state = ENSENS_WINDOW_STATE_IDLE;
+    ensens_is_map_window_average_valid = false;
+
+    EnSens_DmaStart();
+    EnSens_AdcTimerInit();
+
+    EnSens_MapSamplingInit();
+}
+
+/*===========================================================================*
+ * Function: EnSens_StartKnockWindow
+ *===========================================================================*/
+void EnSens_StartKnockWindow(EnCon_CylinderChannels_T channel)
+{
+#if ENSENS_KNOCK_SENSOR_ENABLED
+    /* Previous window is processed before next window is opened */
+    if (ensens_knock_window_state != ENSENS_WINDOW_STATE_CLOSED)
+    {
+        ensens_knock_window_start = EnSens_GetKnockSampleIndex();
+        ensens_knock_window_channel = channel;
+        ensens_knock_window_state = ENSENS_WINDOW_STATE_OPEN;
+    }
+#else
+    (void)channel;
+#endif
+}
+
+/*===========================================================================*
+ * Function: EnSens_EndKnockWindow
+ *===========================================================================*/
+void EnSens_EndKnockWindow(void)
+{
+#if ENSENS_KNOCK_SENSOR_ENABLED
+    uint32_t windowEnd;
+
+    if (ENSENS_WINDOW_STATE_OPEN == ensens_knock_window_state)
+    {
+        windowEnd = EnSens_GetKnockSampleIndex();
+
+        /* At low engine speed only the beggining of the window is used */
+        if ((windowEnd - ensens_knock_window_start) > KNOCK_WINDOW_SAMPLES_MAX)
+        {
+            windowEnd = ensens_knock_window_start + KNOCK_WINDOW_SAMPLES_MAX;
+        }
+
+        ensens_knock_window_end = windowEnd;
+        ensens_knock_window_state = ENSENS_WINDOW_STATE_CLOSED;
+    }
+#endif
+}
+
+/*===========================================================================*
+ * Function: EnSens_CancelKnockWindow
+ *===========================================================================*/
+void EnSens_CancelKnockWindow(void)
+{
+#if ENSENS_KNOCK_SENSOR_ENABLED
+    ensens_knock_window_state = ENSENS_WINDOW_STATE_IDLE;
+#endif
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetKnockSamplingFrequency
+ *===========================================================================*/
+float EnSens_GetKnockSamplingFrequency(void)
+{
+    return (float)ENSENS_ADC_TIMER_CLOCK_HZ / (float)ENSENS_ADC_TIMER_PERIOD;
+}
+
+/*===========================================================================*
+ * Function: EnSens_AlignMapSampling
+ *===========================================================================*/
+void EnSens_AlignMapSampling(float engineAngle, float sampleAngle)
+{
+    uint32_t pulsesToSample;
+
+    if (!ensens_is_map_sampling_supported)
+    {
+        goto ensens_align_map_sampling_exit;
+    }
+
+    if (ENCON_ANGLE_UNKNOWN == engineAngle)
+    {
+        /* Engine stopped, samples are no longer synchronous */
+        ensens_is_map_sampling_aligned = false;
+        goto ensens_align_map_sampling_exit;
+    }
+
+    if (ensens_is_map_sampling_aligned && (engineAngle != ENCON_TRIGGER_ANGLE))
+    {
+        goto ensens_align_map_sampling_exit;
+    }
+
+    pulsesToSample = Utils_FloatToUint32(UTILS_CIRCULAR_DIFFERENCE(sampleAngle, engineAngle,
+                                                                   ENCON_ENGINE_FULL_CYCLE_ANGLE) /
+                                         ENCON_ONE_TRIGGER_PULSE_ANGLE) % ensens_map_sampling_period;
+
+    /* Counter overflows (and triggers conversion) after pulsesToSample next speed signal pulses */
+    TIMER_MAP_SAMPLING->CNT = (ensens_map_sampling_period - pulsesToSample) % ensens_map_sampling_period;
+
+    if (!ensens_is_map_sampling_aligned)
+    {
+        /* Use only samples taken after alignment */
+        ADC1->SR &= ~ADC_SR_JEOC;
+        ensens_is_map_sampling_aligned = true;
+    }
+
+ensens_align_map_sampling_exit:
+
+    return;
+}
+
+/*===========================================================================*
+ * Function: EnSens_StartMapWindow
+ *===========================================================================*/
+void EnSens_StartMapWindow(void)
+{
+    /* Previous window average is calculated before next window is opened */
+    if (ensens_map_window_state != ENSENS_WINDOW_STATE_CLOSED)
+    {
+        ensens_map_window_start = EnSens_GetMapSampleIndex();
+        ensens_map_window_state = ENSENS_WINDOW_STATE_OPEN;
+    }
+}
+
+/*===========================================================================*
+ * Function: EnSens_EndMapWindow
+ *===========================================================================*/
+void EnSens_EndMapWindow(void)
+{
+    if (ENSENS_WINDOW_STATE_OPEN == ensens_map_window_state)
+    {
+        ensens_map_window_end = EnSens_GetMapSampleIndex();
+        ensens_map_window_state = ENSENS_WINDOW_STATE_CLOSED;
+    }
 }
 
 /*===========================================================================*
- * Function: EnSens_StartMeasurement
+ * Function: EnSens_CancelMapWindow
  *===========================================================================*/
-void EnSens_StartMeasurement(void)
+void EnSens_CancelMapWindow(void)
 {
-    /* Clear status register */
-    ADC1->SR = 0x00;
-    /* Start regular channels conversion */
-    ADC1->CR2 |= ADC_CR2_SWSTART;
+    ensens_map_window_state = ENSENS_WINDOW_STATE_IDLE;
+    ensens_is_map_window_average_valid = false;
 }
 
 /*===========================================================================*
@@ -193,7 +875,38 @@ void EnSens_StartMeasurement(void)
  *===========================================================================*/
 float EnSens_GetMap(void)
 {
-    return ENSENS_CALCULATE_MAP_KPA(ENSENS_ADC_CALCULATE_VOLTAGE_MV(ensens_sensors_data[ENSENS_DATA_INDEX_MAP]));
+    float mapRaw;
+
+    if (ensens_active_faults[ENSENS_SENSOR_MAP] != 0U)
+    {
+        ensens_derived_values.map = ensens_channels_config[ENSENS_SENSOR_MAP].diagnostic.substituteValue;
+        /* Force conversion when fault is cleared */
+        ensens_derived_values.mapRaw = -1.0F;
+        goto ensens_get_map_exit;
+    }
+
+    if (ensens_is_map_window_average_valid)
+    {
+        mapRaw = (float)ensens_map_window_average;
+    }
+    else if (ensens_is_map_sampling_aligned && (ADC1->SR & ADC_SR_JEOC))
+    {
+        mapRaw = (float)ADC1->JDR1;
+    }
+    else
+    {
+        mapRaw = ensens_sensors_data[ENSENS_SENSOR_MAP];
+    }
+
+    if (mapRaw != ensens_derived_values.mapRaw)
+    {
+        ensens_derived_values.map = EnSens_ConvertChannel(ENSENS_SENSOR_MAP, mapRaw);
+        ensens_derived_values.mapRaw = mapRaw;
+    }
+
+ensens_get_map_exit:
+
+    return ensens_derived_values.map;
 }
 
 /*===========================================================================*
@@ -201,12 +914,19 @@ float EnSens_GetMap(void)
  *===========================================================================*/
 float EnSens_GetIat(void)
 {
-    float iatCelsius;
+    EnSens_UpdateDerivedValues();
+
+    return ensens_derived_values.values[ENSENS_SENSOR_IAT];
+}
 
-    iatCelsius = Tables_Get2DTableValue(TABLES_2D_IAT,
-                                        ENSENS_ADC_CALCULATE_VOLTAGE_MV(ensens_sensors_data[ENSENS_DATA_INDEX_IAT]));
+/*===========================================================================*
+ * Function: EnSens_GetIatReciprocal
+ *===========================================================================*/
+float EnSens_GetIatReciprocal(void)
+{
+    EnSens_UpdateDerivedValues();
 
-    return UTILS_CONVERT_C_TO_K(iatCelsius);
+    return ensens_derived_values.iatReciprocal;
 }
 
 /*===========================================================================*
@@ -215,19 +935,17 @@ float EnSens_GetIat(void)
 float EnSens_GetClt(EnSens_CltResultTypes_T resultType)
 {
     float result;
-    float cltCelsius;
 
-    cltCelsius = Tables_Get2DTableValue(TABLES_2D_CLT,
-                                        ENSENS_ADC_CALCULATE_VOLTAGE_MV(ensens_sensors_data[ENSENS_DATA_INDEX_CLT]));
+    EnSens_UpdateDerivedValues();
 
     switch (resultType)
     {
         case ENSENS_CLT_RESULT_TYPE_TEMPERATURE:
-            result = UTILS_CONVERT_C_TO_K(cltCelsius);
+            result = ensens_derived_values.values[ENSENS_SENSOR_CLT];
             break;
         
         case ENSENS_CLT_RESULT_TYPE_ENRICHEMENT:
-            result = Tables_Get2DTableValue(TABLES_2D_CLT_ENRICHEMENT, cltCelsius);
+            result = ensens_derived_values.cltEnrichment;
             break;
 
         default:
@@ -239,28 +957,697 @@ float EnSens_GetClt(EnSens_CltResultTypes_T resultType)
 }
 
 /*===========================================================================*
- *
- * LOCAL FUNCTION DEFINITION SECTION
- *
- *===========================================================================*/
-
-/*===========================================================================*
- * Function: ADC_IRQHandler
+ * Function: EnSens_GetBatteryVoltage
  *===========================================================================*/
-extern void ADC_IRQHandler(void)
+float EnSens_GetBatteryVoltage(void)
 {
-    /* ADC overrun occured */
-    if (ADC1->SR & ADC_SR_OVR)
-    {
-        /* Reinitialize number of data registers */
-        DMA2_Stream0->NDTR = ENSENS_DATA_INDEX_COUNT;
-        /* Reinitialize peripherial adress */
-        DMA2_Stream0->PAR = (uint32_t)&ADC1->DR;
-        /* Reinitialize memory adress */
-        DMA2_Stream0->M0AR = (uint32_t)&ensens_sensors_data[0];
-        /* Clean overrun bit */
-        ADC1->SR &= ~ADC_SR_OVR;
-    }
+    EnSens_UpdateDerivedValues();
+
+    return ensens_derived_values.values[ENSENS_SENSOR_VBAT];
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetTps
+ *===========================================================================*/
+float EnSens_GetTps(void)
+{
+    float result;
+
+#if ENSENS_TPS_LAMBDA_SENSORS_ENABLED
+    EnSens_UpdateDerivedValues();
+
+    result = ensens_derived_values.values[ENSENS_SENSOR_TPS];
+#else
+    result = 0.0F;
+#endif
+
+    return result;
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetLambda
+ *===========================================================================*/
+float EnSens_GetLambda(void)
+{
+    float result;
+
+#if ENSENS_TPS_LAMBDA_SENSORS_ENABLED
+    EnSens_UpdateDerivedValues();
+
+    result = ensens_derived_values.values[ENSENS_SENSOR_LAMBDA];
+#else
+    result = 1.0F;
+#endif
+
+    return result;
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetOilPressure
+ *===========================================================================*/
+float EnSens_GetOilPressure(void)
+{
+    float result;
+
+#if ENSENS_OIL_PRESSURE_SENSOR_ENABLED
+    EnSens_UpdateDerivedValues();
+
+    result = ensens_derived_values.values[ENSENS_SENSOR_OIL_PRESSURE];
+#else
+    result = 0.0F;
+#endif
+
+    return result;
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetFaults
+ *===========================================================================*/
+uint32_t EnSens_GetFaults(EnSens_Sensor_T sensor)
+{
+    return ensens_faults[sensor];
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetActiveFaults
+ *===========================================================================*/
+uint32_t EnSens_GetActiveFaults(EnSens_Sensor_T sensor)
+{
+    return ensens_active_faults[sensor];
+}
+
+/*===========================================================================*
+ * Function: EnSens_ClearFaults
+ *===========================================================================*/
+void EnSens_ClearFaults(void)
+{
+    uint8_t sensor;
+
+    for (sensor = 0U; sensor < ENSENS_SENSOR_COUNT; sensor++)
+    {
+        ensens_faults[sensor] = 0U;
+        ensens_active_faults[sensor] = 0U;
+        ensens_diagnostic_states[sensor].healCounter = 0U;
+    }
+
+    /* Substituted values are converted again */
+    ensens_samples_generation++;
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: EnSens_MapSamplingInit
+ *===========================================================================*/
+static void EnSens_MapSamplingInit(void)
+{
+    ensens_is_map_sampling_aligned = false;
+    ensens_map_sampling_period = (uint32_t)ENSENS_MAP_SAMPLING_PERIOD_PULSES;
+    ensens_is_map_sampling_supported = ((float)ensens_map_sampling_period == ENSENS_MAP_SAMPLING_PERIOD_PULSES);
+
+    if (!ensens_is_map_sampling_supported)
+    {
+        goto ensens_map_sampling_init_exit;
+    }
+
+    /* Set MAP channel as the only injected channel (single conversion uses JSQ4) */
+    ADC1->JSQR = ((uint32_t)ensens_channels_config[ENSENS_SENSOR_MAP].adcChannel << ADC_JSQR_JSQ4_Pos);
+    /* Select TIM4 TRGO as injected conversion trigger */
+    ADC1->CR2 |= ENSENS_ADC_JEXTSEL_TIM4_TRGO;
+    /* Enable injected conversion trigger on rising edge */
+    ADC1->CR2 |= ADC_CR2_JEXTEN_0;
+
+    /* Enable timer clock */
+    RCC->APB1ENR |= RCC_APB1ENR_TIM4EN;
+    /* Set timer clock prescaler to 0 (source clock divided by 0+1) */
+    TIMER_MAP_SAMPLING->PSC = (uint16_t)0U;
+    /* Overflow once per intake stroke */
+    TIMER_MAP_SAMPLING->ARR = ensens_map_sampling_period - 1U;
+    /* Select speed timer TRGO as trigger input */
+    TIMER_MAP_SAMPLING->SMCR |= TIMER_MAP_SAMPLING_SPEED_TRIGGER;
+    /* Count speed signal pulses */
+    TIMER_MAP_SAMPLING->SMCR |= TIMER_SLAVE_MODE_EXTERNAL_CLOCK;
+    /* Set master mode update: TRGO pulse on every counter overflow */
+    TIMER_MAP_SAMPLING->CR2 |= TIM_CR2_MMS_1;
+
+#ifdef DEBUG
+    /* Stop timer when core is halted in debug */
+    DBGMCU->APB1FZ |= DBGMCU_APB1_FZ_DBG_TIM4_STOP;
+#endif
+
+    /* Start the timer */
+    TIMER_MAP_SAMPLING->CR1 |= TIM_CR1_CEN;
+
+ensens_map_sampling_init_exit:
+
+    return;
+}
+
+/*===========================================================================*
+ * Function: EnSens_BuildLuts
+ *===========================================================================*/
+static void EnSens_BuildLuts(void)
+{
+    uint8_t index;
+    float voltageMv;
+    float cltCelsius;
+    float iatKelvin;
+
+    for (index = 0U; index < ENSENS_LUT_SIZE; index++)
+    {
+        voltageMv = ENSENS_ADC_CALCULATE_VOLTAGE_MV((uint32_t)index << ENSENS_LUT_FRACTION_BITS);
+        cltCelsius = Tables_Get2DTableValue(TABLES_2D_CLT, voltageMv);
+        iatKelvin = UTILS_CONVERT_C_TO_K(Tables_Get2DTableValue(TABLES_2D_IAT, voltageMv));
+
+        ensens_luts[ENSENS_LUT_IAT][index] = iatKelvin;
+        ensens_luts[ENSENS_LUT_IAT_RECIPROCAL][index] = 1.0F / iatKelvin;
+        ensens_luts[ENSENS_LUT_CLT][index] = UTILS_CONVERT_C_TO_K(cltCelsius);
+        ensens_luts[ENSENS_LUT_CLT_ENRICHEMENT][index] = Tables_Get2DTableValue(TABLES_2D_CLT_ENRICHEMENT, cltCelsius);
+    }
+}
+
+/*===========================================================================*
+ * Function: EnSens_ConvertWithLut
+ *===========================================================================*/
+static float EnSens_ConvertWithLut(EnSens_Lut_T lut, float adcCode)
+{
+    const float* point;
+    float position;
+    uint32_t index;
+
+    position = ENSENS_ADC_CLAMP_CODE(adcCode) * ENSENS_LUT_FRACTION_MULTIPLIER;
+    index = (uint32_t)position;
+    point = &ensens_luts[lut][index];
+
+    return point[0] + ((point[1] - point[0]) * (position - (float)index));
+}
+
+/*===========================================================================*
+ * Function: EnSens_ConvertChannel
+ *===========================================================================*/
+static float EnSens_ConvertChannel(EnSens_Sensor_T sensor, float adcCode)
+{
+    const EnSens_ChannelConfig_T* config;
+    float result;
+
+    config = &ensens_channels_config[sensor];
+
+    if (ENSENS_CURVE_TYPE_LUT == config->curveType)
+    {
+        result = EnSens_ConvertWithLut(config->lut, adcCode);
+    }
+    else
+    {
+        result = (config->gain * ENSENS_ADC_CALCULATE_VOLTAGE_MV(ENSENS_ADC_CLAMP_CODE(adcCode))) + config->offset;
+    }
+
+    return result;
+}
+
+/*===========================================================================*
+ * Function: EnSens_ChannelsInit
+ *===========================================================================*/
+static void EnSens_ChannelsInit(void)
+{
+    const EnSens_ChannelConfig_T* config;
+    uint8_t sensor;
+    uint8_t slot;
+    uint32_t shift;
+
+    /* Enable GPIOA clock */
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN;
+    /* Enable GPIOB clock */
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOBEN;
+
+#if ENSENS_KNOCK_SENSOR_ENABLED
+    /* Set port PA2 in analog mode */
+    GPIOA->MODER |= GPIO_MODER_MODER2;
+    /* Set knock channel sample time to 15 cycles */
+    ADC1->SMPR2 &= ~(ADC_SMPR2_SMP0 << (ENSENS_ADC_KNOCK_CHANNEL * ENSENS_ADC_SMPR_BITS));
+    ADC1->SMPR2 |= ((uint32_t)ENSENS_SAMPLE_TIME_15_CYCLES << (ENSENS_ADC_KNOCK_CHANNEL * ENSENS_ADC_SMPR_BITS));
+#endif
+
+    /* Fill whole sequence with knock channel, sensors slots are overwritten below */
+    for (slot = 0U; slot < ENSENS_ADC_SEQUENCE_LENGTH; slot++)
+    {
+        if (slot < ENSENS_ADC_SQR_CHANNELS)
+        {
+            shift = slot * ENSENS_ADC_SQR_BITS;
+            ADC1->SQR3 &= ~(ADC_SQR3_SQ1 << shift);
+            ADC1->SQR3 |= (ENSENS_ADC_KNOCK_CHANNEL << shift);
+        }
+        else
+        {
+            shift = (slot - ENSENS_ADC_SQR_CHANNELS) * ENSENS_ADC_SQR_BITS;
+            ADC1->SQR2 &= ~(ADC_SQR2_SQ7 << shift);
+            ADC1->SQR2 |= (ENSENS_ADC_KNOCK_CHANNEL << shift);
+        }
+    }
+
+    for (sensor = 0U; sensor < ENSENS_SENSOR_COUNT; sensor++)
+    {
+        config = &ensens_channels_config[sensor];
+        slot = ENSENS_ADC_SENSOR_SLOT(sensor);
+
+        /* Set pin in analog mode */
+        config->port->MODER |= (GPIO_MODER_MODER0 << (config->pin * 2U));
+
+        /* Set channel sample time */
+        if (config->adcChannel < ENSENS_ADC_SMPR_CHANNELS)
+        {
+            shift = config->adcChannel * ENSENS_ADC_SMPR_BITS;
+            ADC1->SMPR2 &= ~(ADC_SMPR2_SMP0 << shift);
+            ADC1->SMPR2 |= ((uint32_t)config->sampleTime << shift);
+        }
+        else
+        {
+            shift = (config->adcChannel - ENSENS_ADC_SMPR_CHANNELS) * ENSENS_ADC_SMPR_BITS;
+            ADC1->SMPR1 &= ~(ADC_SMPR1_SMP10 << shift);
+            ADC1->SMPR1 |= ((uint32_t)config->sampleTime << shift);
+        }
+
+        /* Set channel in its regular sequence slot */
+        if (slot < ENSENS_ADC_SQR_CHANNELS)
+        {
+            shift = slot * ENSENS_ADC_SQR_BITS;
+            ADC1->SQR3 &= ~(ADC_SQR3_SQ1 << shift);
+            ADC1->SQR3 |= ((uint32_t)config->adcChannel << shift);
+        }
+        else
+        {
+            shift = (slot - ENSENS_ADC_SQR_CHANNELS) * ENSENS_ADC_SQR_BITS;
+            ADC1->SQR2 &= ~(ADC_SQR2_SQ7 << shift);
+            ADC1->SQR2 |= ((uint32_t)config->adcChannel << shift);
+        }
+    }
+
+    /* Set total conversion number */
+    ADC1->SQR1 &= ~ADC_SQR1_L;
+    ADC1->SQR1 |= ((ENSENS_ADC_SEQUENCE_LENGTH - 1U) << ADC_SQR1_L_Pos);
+}
+
+/*===========================================================================*
+ * Function: EnSens_FiltersInit
+ *===========================================================================*/
+static void EnSens_FiltersInit(void)
+{
+    uint8_t sensor;
+
+    for (sensor = 0U; sensor < ENSENS_SENSOR_COUNT; sensor++)
+    {
+        if (ensens_channels_config[sensor].filter.stagesNo > 0U)
+        {
+            /* Coefficients are only read, CMSIS-DSP init function takes non-const pointer */
+            arm_biquad_cascade_df1_init_f32(&ensens_filters[sensor], ensens_channels_config[sensor].filter.stagesNo,
+                                            (float32_t*)ensens_channels_config[sensor].filter.coeffs,
+                                            ensens_filters_state[sensor]);
+        }
+    }
+
+    ensens_is_filters_primed = false;
+}
+
+/*===========================================================================*
+ * Function: EnSens_FilterSamples
+ *===========================================================================*/
+static void EnSens_FilterSamples(EnSens_Sensor_T sensor, volatile const uint16_t* buffer, float32_t* filtered)
+{
+    float32_t samples[ENSENS_ADC_SCANS_PER_BUFFER];
+    uint8_t scan;
+
+    /* Deinterleave sensor samples */
+    for (scan = 0U; scan < ENSENS_ADC_SCANS_PER_BUFFER; scan++)
+    {
+        samples[scan] = (float32_t)buffer[(scan * ENSENS_ADC_SEQUENCE_LENGTH) + ENSENS_ADC_SENSOR_SLOT(sensor)];
+    }
+
+    if (!ensens_is_filters_primed)
+    {
+        /* Filters have unity DC gain, steady state inputs and outputs are equal to the first sample */
+        for (scan = 0U; scan < ENSENS_FILTER_STATE_SIZE; scan++)
+        {
+            ensens_filters_state[sensor][scan] = samples[0U];
+        }
+    }
+
+    arm_biquad_cascade_df1_f32(&ensens_filters[sensor], samples, filtered, ENSENS_ADC_SCANS_PER_BUFFER);
+}
+
+/*===========================================================================*
+ * Function: EnSens_UpdateDerivedValues
+ *===========================================================================*/
+static void EnSens_UpdateDerivedValues(void)
+{
+    uint32_t generation;
+    uint8_t sensor;
+
+    generation = ensens_samples_generation;
+
+    if (generation == ensens_derived_values.generation)
+    {
+        goto ensens_update_derived_values_exit;
+    }
+
+    /* DMA2 interrupt can deliver a new samples set during the conversion, then values would mix two sets. */
+    /* Conversion is repeated until generation read before and after it is the same */
+    do
+    {
+        generation = ensens_samples_generation;
+
+        for (sensor = 0U; sensor < ENSENS_SENSOR_COUNT; sensor++)
+        {
+            if (ENSENS_SENSOR_MAP == sensor)
+            {
+                continue;
+            }
+
+            if (ensens_active_faults[sensor] != 0U)
+            {
+                ensens_derived_values.values[sensor] = ensens_channels_config[sensor].diagnostic.substituteValue;
+            }
+            else
+            {
+                ensens_derived_values.values[sensor] = EnSens_ConvertChannel((EnSens_Sensor_T)sensor,
+                                                                             ensens_sensors_data[sensor]);
+            }
+        }
+
+        if (ensens_active_faults[ENSENS_SENSOR_IAT] != 0U)
+        {
+            ensens_derived_values.iatReciprocal = 1.0F / ensens_derived_values.values[ENSENS_SENSOR_IAT];
+        }
+        else
+        {
+            ensens_derived_values.iatReciprocal = EnSens_ConvertWithLut(ENSENS_LUT_IAT_RECIPROCAL,
+                                                                        ensens_sensors_data[ENSENS_SENSOR_IAT]);
+        }
+
+        if (ensens_active_faults[ENSENS_SENSOR_CLT] != 0U)
+        {
+            ensens_derived_values.cltEnrichment =
+                Tables_Get2DTableValue(TABLES_2D_CLT_ENRICHEMENT,
+                                       UTILS_CONVERT_K_TO_C(ensens_derived_values.values[ENSENS_SENSOR_CLT]));
+        }
+        else
+        {
+            ensens_derived_values.cltEnrichment = EnSens_ConvertWithLut(ENSENS_LUT_CLT_ENRICHEMENT,
+                                                                        ensens_sensors_data[ENSENS_SENSOR_CLT]);
+        }
+    } while (generation != ensens_samples_generation);
+
+    ensens_derived_values.generation = generation;
+
+ensens_update_derived_values_exit:
+
+    return;
+}
+
+/*===========================================================================*
+ * Function: EnSens_CheckSensor
+ *===========================================================================*/
+static void EnSens_CheckSensor(EnSens_Sensor_T sensor, uint16_t code)
+{
+    const EnSens_DiagnosticConfig_T* config;
+    EnSens_DiagnosticState_T* state;
+    float voltageMv;
+    uint32_t faults;
+
+    config = &ensens_channels_config[sensor].diagnostic;
+    state = &ensens_diagnostic_states[sensor];
+    voltageMv = ENSENS_ADC_CALCULATE_VOLTAGE_MV(ensens_sensors_data[sensor]);
+    faults = 0U;
+
+    if ((voltageMv < config->minMv) || (voltageMv > config->maxMv))
+    {
+        if (state->rangeCounter < ENSENS_RANGE_FAULT_DEBOUNCE)
+        {
+            state->rangeCounter++;
+        }
+        else
+        {
+            faults |= (voltageMv < config->minMv) ? ENSENS_FAULT_MASK(ENSENS_FAULT_RANGE_LOW) :
+                                                    ENSENS_FAULT_MASK(ENSENS_FAULT_RANGE_HIGH);
+        }
+    }
+    else
+    {
+        state->rangeCounter = 0U;
+    }
+
+    if (ensens_is_filters_primed)
+    {
+        if ((config->maxRateMv > 0.0F) && (fabsf(voltageMv - state->lastMv) > config->maxRateMv))
+        {
+            faults |= ENSENS_FAULT_MASK(ENSENS_FAULT_RATE);
+        }
+
+        /* Sensors read constant values with stopped engine, e.g. MAP at key-on */
+        if ((config->stuckSetsNo > 0U) && (code == state->lastCode) &&
+            (ENCON_SPEED_RAW_UNKNOWN != EnCon_GetEngineSpeedRaw()))
+        {
+            if (state->stuckCounter < config->stuckSetsNo)
+            {
+                state->stuckCounter++;
+            }
+            else
+            {
+                faults |= ENSENS_FAULT_MASK(ENSENS_FAULT_STUCK);
+            }
+        }
+        else
+        {
+            state->stuckCounter = 0U;
+        }
+    }
+
+    state->lastMv = voltageMv;
+    state->lastCode = code;
+
+    if (faults != 0U)
+    {
+        ensens_faults[sensor] |= faults;
+        ensens_active_faults[sensor] |= faults;
+        state->healCounter = 0U;
+    }
+    else if ((ensens_active_faults[sensor] != 0U) && (0U == state->rangeCounter))
+    {
+        if (state->healCounter < ENSENS_FAULT_HEAL_SETS)
+        {
+            state->healCounter++;
+        }
+        else
+        {
+            ensens_active_faults[sensor] = 0U;
+            state->healCounter = 0U;
+        }
+    }
+    else
+    {
+        state->healCounter = 0U;
+    }
+}
+
+/*===========================================================================*
+ * Function: EnSens_AdcTimerInit
+ *===========================================================================*/
+static void EnSens_AdcTimerInit(void)
+{
+    /* Enable timer clock */
+    RCC->APB2ENR |= RCC_APB2ENR_TIM1EN;
+    /* Set timer clock prescaler to 1 (100MHz) */
+    ENSENS_ADC_TIMER->PSC = ENSENS_ADC_TIMER_PRESCALER;
+    /* Set conversion period of one sequence group */
+    ENSENS_ADC_TIMER->ARR = ENSENS_ADC_TIMER_PERIOD - 1U;
+    ENSENS_ADC_TIMER->CCR1 = ENSENS_ADC_TIMER_PERIOD / 2U;
+    /* Set channel 1 PWM mode 1, CC1 event is used only internally (PA8 is not in alternate function mode) */
+    ENSENS_ADC_TIMER->CCMR1 |= TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1M_1;
+    ENSENS_ADC_TIMER->CCER |= TIM_CCER_CC1E;
+
+#ifdef DEBUG
+    /* Stop timer when core is halted in debug */
+    DBGMCU->APB2FZ |= DBGMCU_APB2_FZ_DBG_TIM1_STOP;
+#endif
+
+    /* Start the timer */
+    ENSENS_ADC_TIMER->CR1 |= TIM_CR1_CEN;
+}
+
+/*===========================================================================*
+ * Function: EnSens_DmaStart
+ *===========================================================================*/
+static void EnSens_DmaStart(void)
+{
+    /* Disable DMA and wait until it's stopped */
+    DMA2_Stream0->CR &= ~DMA_SxCR_EN;
+    while (DMA2_Stream0->CR & DMA_SxCR_EN)
+    {
+        /* Wait */
+    }
+
+    /* Clear stream flags */
+    DMA2->LIFCR = DMA_LIFCR_CTCIF0 | DMA_LIFCR_CHTIF0 | DMA_LIFCR_CTEIF0 | DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CFEIF0;
+
+    /* Start with the first buffer */
+    DMA2_Stream0->CR &= ~DMA_SxCR_CT;
+    /* Set number of data registers */
+    DMA2_Stream0->NDTR = ENSENS_ADC_BUFFER_SIZE;
+    /* Set peripherial adress */
+    DMA2_Stream0->PAR = (uint32_t)&ADC1->DR;
+    /* Set memory adresses */
+    DMA2_Stream0->M0AR = (uint32_t)&ensens_adc_buffers[0U][0U];
+    DMA2_Stream0->M1AR = (uint32_t)&ensens_adc_buffers[1U][0U];
+
+    /* Enable DMA */
+    DMA2_Stream0->CR |= DMA_SxCR_EN;
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetMapSampleIndex
+ *===========================================================================*/
+static uint32_t EnSens_GetMapSampleIndex(void)
+{
+    uint32_t samplesCount;
+    uint32_t transfersLeft;
+
+    /* Repeat if buffer has been processed meantime */
+    do
+    {
+        samplesCount = ensens_map_samples_count;
+        transfersLeft = DMA2_Stream0->NDTR;
+    } while (samplesCount != ensens_map_samples_count);
+
+    return samplesCount + ((ENSENS_ADC_BUFFER_SIZE - transfersLeft) / ENSENS_ADC_SEQUENCE_LENGTH);
+}
+
+/*===========================================================================*
+ * Function: EnSens_CalculateMapWindowAverage
+ *===========================================================================*/
+static void EnSens_CalculateMapWindowAverage(void)
+{
+    uint32_t start;
+    uint32_t length;
+    uint32_t firstLength;
+    q15_t firstMean;
+    q15_t secondMean;
+
+    start = ensens_map_window_start & ENSENS_MAP_HISTORY_MASK;
+    length = ensens_map_window_end - ensens_map_window_start;
+
+    /* Samples at the window start were already overwritten */
+    if ((0U == length) || ((ensens_map_samples_count - ensens_map_window_start) > ENSENS_MAP_HISTORY_SIZE))
+    {
+        goto ensens_calculate_map_window_average_exit;
+    }
+
+    if ((start + length) <= ENSENS_MAP_HISTORY_SIZE)
+    {
+        arm_mean_q15(&ensens_map_history[start], length, &firstMean);
+        ensens_map_window_average = (uint16_t)firstMean;
+    }
+    else
+    {
+        /* Window wraps around the end of the history */
+        firstLength = ENSENS_MAP_HISTORY_SIZE - start;
+        arm_mean_q15(&ensens_map_history[start], firstLength, &firstMean);
+        arm_mean_q15(&ensens_map_history[0U], length - firstLength, &secondMean);
+        ensens_map_window_average = (uint16_t)((((uint32_t)firstMean * firstLength) +
+                                                ((uint32_t)secondMean * (length - firstLength))) / length);
+    }
+
+    ensens_is_map_window_average_valid = true;
+
+ensens_calculate_map_window_average_exit:
+
+    return;
+}
+
+#if ENSENS_KNOCK_SENSOR_ENABLED
+/*===========================================================================*
+ * Function: EnSens_GetKnockSampleIndex
+ *===========================================================================*/
+static uint32_t EnSens_GetKnockSampleIndex(void)
+{
+    uint32_t samplesCount;
+    uint32_t transfersLeft;
+    uint32_t transfersDone;
+
+    /* Repeat if buffer has been processed meantime */
+    do
+    {
+        samplesCount = ensens_knock_samples_count;
+        transfersLeft = DMA2_Stream0->NDTR;
+    } while (samplesCount != ensens_knock_samples_count);
+
+    transfersDone = ENSENS_ADC_BUFFER_SIZE - transfersLeft;
+
+    /* Knock sample is converted first in every group */
+    return samplesCount + ((transfersDone + ENSENS_ADC_GROUP_SIZE - 1U) / ENSENS_ADC_GROUP_SIZE);
+}
+
+/*===========================================================================*
+ * Function: EnSens_ProcessKnockSamples
+ *===========================================================================*/
+static void EnSens_ProcessKnockSamples(volatile const uint16_t* buffer)
+{
+    uint32_t samplesCount;
+    uint32_t length;
+    uint32_t index;
+
+    samplesCount = ensens_knock_samples_count;
+
+    for (index = 0U; index < (ENSENS_ADC_SCANS_PER_BUFFER * ENSENS_ADC_GROUPS_NO); index++)
+    {
+        ensens_knock_history[(samplesCount + index) & ENSENS_KNOCK_HISTORY_MASK] =
+            (q15_t)buffer[index * ENSENS_ADC_GROUP_SIZE];
+    }
+
+    samplesCount += ENSENS_ADC_SCANS_PER_BUFFER * ENSENS_ADC_GROUPS_NO;
+    ensens_knock_samples_count = samplesCount;
+
+    if ((ENSENS_WINDOW_STATE_CLOSED != ensens_knock_window_state) ||
+        ((int32_t)(samplesCount - ensens_knock_window_end) < 0))
+    {
+        goto ensens_process_knock_samples_exit;
+    }
+
+    length = ensens_knock_window_end - ensens_knock_window_start;
+
+    /* Samples at the window start may be already overwritten */
+    if ((samplesCount - ensens_knock_window_start) <= ENSENS_KNOCK_HISTORY_SIZE)
+    {
+        for (index = 0U; index < length; index++)
+        {
+            ensens_knock_window[index] =
+                (float32_t)ensens_knock_history[(ensens_knock_window_start + index) & ENSENS_KNOCK_HISTORY_MASK];
+        }
+
+        Knock_OnWindowCaptured(ensens_knock_window_channel, ensens_knock_window, (uint16_t)length);
+    }
+
+    ensens_knock_window_state = ENSENS_WINDOW_STATE_IDLE;
+
+ensens_process_knock_samples_exit:
+
+    return;
+}
+#endif
+
+/*===========================================================================*
+ * Function: ADC_IRQHandler
+ *===========================================================================*/
+extern void ADC_IRQHandler(void)
+{
+    /* ADC overrun occured */
+    if (ADC1->SR & ADC_SR_OVR)
+    {
+        EnSens_DmaStart();
+        /* Clean overrun bit */
+        ADC1->SR &= ~ADC_SR_OVR;
+    }
 }
 
 /*===========================================================================*
@@ -268,7 +1655,83 @@ extern void ADC_IRQHandler(void)
  *===========================================================================*/
 extern void DMA2_Stream0_IRQHandler(void)
 {
-    
+    volatile const uint16_t* buffer;
+    float32_t filtered[ENSENS_ADC_SCANS_PER_BUFFER];
+    uint32_t samplesCount;
+    uint16_t lastCode;
+    uint8_t scan;
+    uint8_t sensor;
+
+    if (DMA2->LISR & DMA_LISR_TCIF0)
+    {
+        /* Clear interrupt flag */
+        DMA2->LIFCR = DMA_LIFCR_CTCIF0;
+
+        /* DMA is filling the buffer pointed by current target, the other one is complete */
+        if (DMA2_Stream0->CR & DMA_SxCR_CT)
+        {
+            buffer = ensens_adc_buffers[0U];
+        }
+        else
+        {
+            buffer = ensens_adc_buffers[1U];
+        }
+
+        samplesCount = ensens_map_samples_count;
+
+        for (sensor = 0U; sensor < ENSENS_SENSOR_COUNT; sensor++)
+        {
+            lastCode = buffer[((ENSENS_ADC_SCANS_PER_BUFFER - 1U) * ENSENS_ADC_SEQUENCE_LENGTH) +
+                              ENSENS_ADC_SENSOR_SLOT(sensor)];
+
+            if (0U == ensens_channels_config[sensor].filter.stagesNo)
+            {
+                /* Not filtered sensors cost nothing per sample */
+                ensens_sensors_data[sensor] = (float)lastCode;
+            }
+            else
+            {
+                EnSens_FilterSamples((EnSens_Sensor_T)sensor, buffer, filtered);
+
+                if (ENSENS_SENSOR_MAP == sensor)
+                {
+                    /* Store filtered MAP samples in the history */
+                    for (scan = 0U; scan < ENSENS_ADC_SCANS_PER_BUFFER; scan++)
+                    {
+                        ensens_map_history[(samplesCount + scan) & ENSENS_MAP_HISTORY_MASK] =
+                            (q15_t)(ENSENS_ADC_CLAMP_CODE(filtered[scan]) + 0.5F);
+                    }
+                }
+
+                ensens_sensors_data[sensor] = filtered[ENSENS_ADC_SCANS_PER_BUFFER - 1U];
+            }
+
+            EnSens_CheckSensor((EnSens_Sensor_T)sensor, lastCode);
+        }
+
+        ensens_is_filters_primed = true;
+
+        ensens_map_samples_count = samplesCount + ENSENS_ADC_SCANS_PER_BUFFER;
+
+#if ENSENS_KNOCK_SENSOR_ENABLED
+        EnSens_ProcessKnockSamples(buffer);
+#endif
+
+        if ((ENSENS_WINDOW_STATE_CLOSED == ensens_map_window_state) &&
+            ((int32_t)(ensens_map_samples_count - ensens_map_window_end) >= 0))
+        {
+            EnSens_CalculateMapWindowAverage();
+            ensens_map_window_state = ENSENS_WINDOW_STATE_IDLE;
+        }
+
+        /* New samples set is complete */
+        ensens_samples_generation++;
+    }
+    else
+    {
+        /* Clear remaining flags */
+        DMA2->LIFCR = DMA_LIFCR_CHTIF0 | DMA_LIFCR_CTEIF0 | DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CFEIF0;
+    }
 }
 
 
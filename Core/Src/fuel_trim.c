@@ -0,0 +1,303 @@
+/*===========================================================================*
+ * File:        fuel_trim.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Closed loop lambda control and long term fuel trim learning
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "fuel_trim.h"
+
+#include "engine_constants.h"
+#include "engine_sensors.h"
+#include "rev_limiter.h"
+#include "speed_density.h"
+
+#include "arm_math.h"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/* Controller period, slower than the wideband sensor response */
+#define FUELTRIM_UPDATE_PERIOD_MS               (10.0F)
+
+/* Lean mixture (positive lambda error) increases fuel */
+#define FUELTRIM_PID_KP                         (0.05F)
+#define FUELTRIM_PID_KI                         (0.02F)
+#define FUELTRIM_PID_KD                         (0.0F)
+
+/* Trims are fractions of the fuel mass */
+#define FUELTRIM_SHORT_TERM_LIMIT               (0.25F)
+#define FUELTRIM_LONG_TERM_LIMIT                (0.25F)
+
+/* Part of the short term trim moved to the long term map every update */
+#define FUELTRIM_LEARNING_GAIN                  (0.002F)
+
+/* Closed loop is enabled only for the warm engine */
+#define FUELTRIM_CLOSED_LOOP_MIN_CLT_C          (60.0F)
+
+/* After enrichment or cut ends, exhaust of the last affected cycles still has to reach the sensor */
+#define FUELTRIM_TRANSPORT_DELAY_CYCLES         (3.0F)
+#define FUELTRIM_SENSOR_DELAY_MS                (100.0F)
+
+/* Engine cycle time in ms at given speed in RPM */
+#define FUELTRIM_CYCLE_TIME_MS(_SPEED_)         ((2.0F * 60.0F * UTILS_CONVERT_TO_MILI_MULTIPL) / (_SPEED_))
+
+/*===========================================================================*
+ *
+ * LOCAL TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+static arm_pid_instance_f32 fueltrim_pid;
+
+static uint32_t fueltrim_last_update_timestamp;
+
+/* Last update with enrichment or limiter cut active */
+static uint32_t fueltrim_hold_timestamp;
+
+static float fueltrim_short_term;
+
+/* Long term trim of every VE table cell, stored as zTable[yIndex][xIndex] with y index counted from the */
+/* bottom row, written only by the background task */
+static float fueltrim_long_term[TABLES_3D_ROWS][TABLES_3D_COLUMNS];
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Check closed loop control conditions
+ * param[in]:   None
+ * param[out]:  None
+ * return:      bool - true when lambda reading can be used for fuel correction
+ * details:     None
+ *===========================================================================*/
+static bool FuelTrim_IsClosedLoopActive(void);
+
+/*===========================================================================*
+ * brief:       Check if the controller has to be held
+ * param[in]:   timestamp - current update timestamp
+ * param[in]:   speed - engine speed in RPM
+ * param[out]:  None
+ * return:      bool - true when lambda doesn't reflect the base fuel error
+ * details:     Hold lasts during enrichment and limiter cut, and for the transport delay after them
+ *===========================================================================*/
+static bool FuelTrim_IsHoldActive(uint32_t timestamp, float speed);
+
+/*===========================================================================*
+ * brief:       Move part of the short term trim into the long term map
+ * param[in]:   speed - engine speed in RPM
+ * param[in]:   pressure - engine absolute pressure in kPa
+ * param[out]:  None
+ * return:      None
+ * details:     Four cells around the operating point are updated with bilinear weights
+ *===========================================================================*/
+static void FuelTrim_LearnLongTerm(float speed, float pressure);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: FuelTrim_Init
+ *===========================================================================*/
+void FuelTrim_Init(void)
+{
+    uint8_t row;
+    uint8_t column;
+
+    fueltrim_pid.Kp = FUELTRIM_PID_KP;
+    fueltrim_pid.Ki = FUELTRIM_PID_KI;
+    fueltrim_pid.Kd = FUELTRIM_PID_KD;
+    arm_pid_init_f32(&fueltrim_pid, 1);
+
+    fueltrim_short_term = 0.0F;
+    fueltrim_last_update_timestamp = UTILS_GET_TIMESTAMP();
+    fueltrim_hold_timestamp = fueltrim_last_update_timestamp;
+
+    for (row = 0U; row < TABLES_3D_ROWS; row++)
+    {
+        for (column = 0U; column < TABLES_3D_COLUMNS; column++)
+        {
+            fueltrim_long_term[row][column] = 0.0F;
+        }
+    }
+}
+
+/*===========================================================================*
+ * Function: FuelTrim_OnBackgroundTask
+ *===========================================================================*/
+void FuelTrim_OnBackgroundTask(void)
+{
+    uint32_t timestamp;
+    float engineSpeed;
+    float enginePressure;
+    float shortTerm;
+
+    timestamp = UTILS_GET_TIMESTAMP();
+
+    if (UTILS_TIMESTAMP_TO_MS(timestamp - fueltrim_last_update_timestamp) < FUELTRIM_UPDATE_PERIOD_MS)
+    {
+        goto fueltrim_on_background_task_exit;
+    }
+
+    fueltrim_last_update_timestamp = timestamp;
+
+    if (false == FuelTrim_IsClosedLoopActive())
+    {
+        /* Open loop, controller starts from zero when conditions are met again */
+        arm_pid_reset_f32(&fueltrim_pid);
+        fueltrim_short_term = 0.0F;
+        goto fueltrim_on_background_task_exit;
+    }
+
+    engineSpeed = EnCon_GetEngineSpeed();
+
+    if (true == FuelTrim_IsHoldActive(timestamp, engineSpeed))
+    {
+        /* Controller and learning are frozen, the trim found before is still valid */
+        goto fueltrim_on_background_task_exit;
+    }
+
+    enginePressure = SpDen_GetEngineLoad(engineSpeed);
+
+    /* Table keeps fuel multiplier, background task can afford the division back to lambda */
+    shortTerm = arm_pid_f32(&fueltrim_pid, EnSens_GetLambda() -
+                            (1.0F / Tables_Get3DTableValue(TABLES_3D_TARGET_LAMBDA_RECIPROCAL, engineSpeed,
+                                                           enginePressure)));
+    shortTerm = UTILS_LIMIT(shortTerm, -FUELTRIM_SHORT_TERM_LIMIT, FUELTRIM_SHORT_TERM_LIMIT);
+    /* Anti-windup, incremental controller keeps its output in the state */
+    fueltrim_pid.state[2] = shortTerm;
+    fueltrim_short_term = shortTerm;
+
+    FuelTrim_LearnLongTerm(engineSpeed, enginePressure);
+
+fueltrim_on_background_task_exit:
+
+    return;
+}
+
+/*===========================================================================*
+ * Function: FuelTrim_GetMultiplier
+ *===========================================================================*/
+float FuelTrim_GetMultiplier(const Tables_3DCell_T* cell)
+{
+    float longTerm;
+    uint8_t x0;
+    uint8_t y0;
+
+    x0 = cell->xIndex;
+    y0 = cell->yIndex;
+
+    longTerm = ((1.0F - cell->u) * (((1.0F - cell->v) * fueltrim_long_term[y0][x0]) +
+                                    (cell->v * fueltrim_long_term[y0 + 1U][x0]))) +
+               (cell->u * (((1.0F - cell->v) * fueltrim_long_term[y0][x0 + 1U]) +
+                           (cell->v * fueltrim_long_term[y0 + 1U][x0 + 1U])));
+
+    return (1.0F + fueltrim_short_term) * (1.0F + longTerm);
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: FuelTrim_IsClosedLoopActive
+ *===========================================================================*/
+static bool FuelTrim_IsClosedLoopActive(void)
+{
+    bool result;
+#if ENSENS_TPS_LAMBDA_SENSORS_ENABLED
+    float engineSpeed;
+
+    engineSpeed = EnCon_GetEngineSpeed();
+
+    result = (ENCON_SPEED_UNKNOWN != engineSpeed) && (engineSpeed >= ENCON_RUNNING_FLOOR_RPM) &&
+             (0U == EnSens_GetActiveFaults(ENSENS_SENSOR_LAMBDA)) &&
+             (UTILS_CONVERT_K_TO_C(EnSens_GetClt(ENSENS_CLT_RESULT_TYPE_TEMPERATURE)) >=
+              FUELTRIM_CLOSED_LOOP_MIN_CLT_C);
+#else
+    /* No lambda sensor, fuel stays in open loop */
+    result = false;
+#endif
+
+    return result;
+}
+
+/*===========================================================================*
+ * Function: FuelTrim_IsHoldActive
+ *===========================================================================*/
+static bool FuelTrim_IsHoldActive(uint32_t timestamp, float speed)
+{
+    bool result;
+
+    if ((true == SpDen_IsEnrichmentActive()) || (true == RevLim_IsCutActive()))
+    {
+        fueltrim_hold_timestamp = timestamp;
+        result = true;
+    }
+    else
+    {
+        result = (UTILS_TIMESTAMP_TO_MS(timestamp - fueltrim_hold_timestamp) <
+                  (FUELTRIM_SENSOR_DELAY_MS + (FUELTRIM_TRANSPORT_DELAY_CYCLES * FUELTRIM_CYCLE_TIME_MS(speed))));
+    }
+
+    return result;
+}
+
+/*===========================================================================*
+ * Function: FuelTrim_LearnLongTerm
+ *===========================================================================*/
+static void FuelTrim_LearnLongTerm(float speed, float pressure)
+{
+    Tables_3DCell_T cell;
+    float step;
+    float weights[2][2];
+    uint8_t row;
+    uint8_t column;
+    float* trim;
+
+    Tables_Get3DTableCell(TABLES_3D_VE, speed, pressure, &cell);
+
+    step = FUELTRIM_LEARNING_GAIN * fueltrim_short_term;
+
+    weights[0][0] = (1.0F - cell.u) * (1.0F - cell.v);
+    weights[0][1] = cell.u * (1.0F - cell.v);
+    weights[1][0] = (1.0F - cell.u) * cell.v;
+    weights[1][1] = cell.u * cell.v;
+
+    for (row = 0U; row < 2U; row++)
+    {
+        for (column = 0U; column < 2U; column++)
+        {
+            trim = &fueltrim_long_term[cell.yIndex + row][cell.xIndex + column];
+            *trim += step * weights[row][column];
+            *trim = UTILS_LIMIT(*trim, -FUELTRIM_LONG_TERM_LIMIT, FUELTRIM_LONG_TERM_LIMIT);
+        }
+    }
+}
+
+
+/* end of file */
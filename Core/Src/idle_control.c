@@ -0,0 +1,233 @@
+/*===========================================================================*
+ * File:        idle_control.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Closed loop idle speed control
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "idle_control.h"
+
+#include "engine_constants.h"
+#include "engine_sensors.h"
+#include "tables.h"
+#include "timers.h"
+
+#include "arm_math.h"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/* Air loop period, air path response is slower than a few engine cycles */
+#define IDLE_UPDATE_PERIOD_MS                   (50.0F)
+
+/* Idle is detected with closed throttle near the target speed */
+#define IDLE_TPS_THRESHOLD                      (2.0F)
+/* Without TPS closed throttle is detected by manifold vacuum, idle MAP stays below 50kPa */
+#define IDLE_MAP_THRESHOLD_KPA                  (60.0F)
+#define IDLE_SPEED_WINDOW_RPM                   (600.0F)
+
+/* Air loop gains, output in % of the valve duty per RPM of error */
+#define IDLE_AIR_PID_KP                         (0.02F)
+#define IDLE_AIR_PID_KI                         (0.005F)
+#define IDLE_AIR_PID_KD                         (0.0F)
+/* Air loop correction range around the base duty */
+#define IDLE_AIR_CORRECTION_LIMIT               (30.0F)
+
+/* Spark loop gain in degrees per RPM of error, engine torque responds within one cycle */
+#define IDLE_SPARK_GAIN                         (0.02F)
+#define IDLE_SPARK_CORRECTION_LIMIT             (8.0F)
+
+/* 100MHz / 100 -> 1MHz timer clock, 5000 ticks -> 200Hz valve PWM */
+#define IDLE_VALVE_PRESCALER                    ((uint16_t)(100U - 1U))
+#define IDLE_VALVE_PERIOD_TICKS                 (5000U)
+#define IDLE_VALVE_TICKS_PER_PERCENT            ((float)IDLE_VALVE_PERIOD_TICKS / (float)UTILS_PERCENTAGE_CONVERTER)
+/* Valve duty until the first air loop update, sensors are not converted yet at init */
+#define IDLE_VALVE_INIT_DUTY                    (50.0F)
+
+/*===========================================================================*
+ *
+ * LOCAL TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+static arm_pid_instance_f32 idle_air_pid;
+
+static uint32_t idle_last_update_timestamp;
+
+/* Updated by the background task, read by the spark loop */
+static volatile bool idle_is_active;
+static volatile float idle_target_speed;
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Set idle air valve duty
+ * param[in]:   duty - valve duty in %
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+static void Idle_SetValveDuty(float duty);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Idle_Init
+ *===========================================================================*/
+void Idle_Init(void)
+{
+    idle_air_pid.Kp = IDLE_AIR_PID_KP;
+    idle_air_pid.Ki = IDLE_AIR_PID_KI;
+    idle_air_pid.Kd = IDLE_AIR_PID_KD;
+    arm_pid_init_f32(&idle_air_pid, 1);
+
+    idle_is_active = false;
+    idle_target_speed = 0.0F;
+    idle_last_update_timestamp = UTILS_GET_TIMESTAMP();
+
+    /* Enable GPIOB clock */
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOBEN;
+    /* Enable TIM11 clock */
+    RCC->APB2ENR |= RCC_APB2ENR_TIM11EN;
+
+    /* PB9 alternate function 3 -> TIM11 CH1 */
+    GPIOB->AFR[1] &= ~GPIO_AFRH_AFSEL9;
+    GPIOB->AFR[1] |= GPIO_AFRH_AFSEL9_1 | GPIO_AFRH_AFSEL9_0;
+    GPIOB->MODER &= ~GPIO_MODER_MODE9;
+    GPIOB->MODER |= GPIO_MODER_MODE9_1;
+
+    TIMER_IDLE_VALVE->PSC = IDLE_VALVE_PRESCALER;
+    TIMER_IDLE_VALVE->ARR = IDLE_VALVE_PERIOD_TICKS - 1U;
+    /* PWM mode 1 with preload, duty is changed at the period end */
+    TIMER_IDLE_VALVE->CCMR1 = TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1PE;
+    TIMER_IDLE_VALVE->CCER = TIM_CCER_CC1E;
+    TIMER_IDLE_VALVE->CR1 = TIM_CR1_ARPE;
+    TIMER_IDLE_VALVE->EGR = TIM_EGR_UG;
+
+    /* Base duty of the coolant temperature is set by the first update */
+    Idle_SetValveDuty(IDLE_VALVE_INIT_DUTY);
+
+    TIMER_IDLE_VALVE->CR1 |= TIM_CR1_CEN;
+}
+
+/*===========================================================================*
+ * Function: Idle_OnBackgroundTask
+ *===========================================================================*/
+void Idle_OnBackgroundTask(void)
+{
+    uint32_t timestamp;
+    float engineSpeed;
+    bool isThrottleClosed;
+    float coolantTemp;
+    float targetSpeed;
+    float baseDuty;
+    float correction;
+
+    timestamp = UTILS_GET_TIMESTAMP();
+
+    if (UTILS_TIMESTAMP_TO_MS(timestamp - idle_last_update_timestamp) < IDLE_UPDATE_PERIOD_MS)
+    {
+        goto idle_on_background_task_exit;
+    }
+
+    idle_last_update_timestamp = timestamp;
+
+    engineSpeed = EnCon_GetEngineSpeed();
+    coolantTemp = UTILS_CONVERT_K_TO_C(EnSens_GetClt(ENSENS_CLT_RESULT_TYPE_TEMPERATURE));
+    targetSpeed = Tables_Get2DTableValue(TABLES_2D_IDLE_TARGET_SPEED, coolantTemp);
+    baseDuty = Tables_Get2DTableValue(TABLES_2D_IDLE_BASE_DUTY, coolantTemp);
+
+#if ENSENS_TPS_LAMBDA_SENSORS_ENABLED
+    isThrottleClosed = (EnSens_GetTps() < IDLE_TPS_THRESHOLD);
+#else
+    /* TPS getter returns closed throttle without the sensor */
+    isThrottleClosed = (EnSens_GetMap() < IDLE_MAP_THRESHOLD_KPA);
+#endif
+
+    idle_target_speed = targetSpeed;
+    idle_is_active = (ENCON_SPEED_UNKNOWN != engineSpeed) && (engineSpeed >= ENCON_RUNNING_FLOOR_RPM) &&
+                     (engineSpeed < (targetSpeed + IDLE_SPEED_WINDOW_RPM)) && isThrottleClosed;
+
+    if (false == idle_is_active)
+    {
+        /* Valve holds base air, so the engine returns to idle close to the target */
+        arm_pid_reset_f32(&idle_air_pid);
+        Idle_SetValveDuty(baseDuty);
+        goto idle_on_background_task_exit;
+    }
+
+    correction = arm_pid_f32(&idle_air_pid, targetSpeed - engineSpeed);
+    correction = UTILS_LIMIT(correction, -IDLE_AIR_CORRECTION_LIMIT, IDLE_AIR_CORRECTION_LIMIT);
+    /* Anti-windup, incremental controller keeps its output in the state */
+    idle_air_pid.state[2] = correction;
+
+    Idle_SetValveDuty(baseDuty + correction);
+
+idle_on_background_task_exit:
+
+    return;
+}
+
+/*===========================================================================*
+ * Function: Idle_GetSparkCorrection
+ *===========================================================================*/
+float Idle_GetSparkCorrection(float speed)
+{
+    float correction;
+
+    if (false == idle_is_active)
+    {
+        correction = 0.0F;
+    }
+    else
+    {
+        /* Speed below the target advances spark to get more torque */
+        correction = (idle_target_speed - speed) * IDLE_SPARK_GAIN;
+        correction = UTILS_LIMIT(correction, -IDLE_SPARK_CORRECTION_LIMIT, IDLE_SPARK_CORRECTION_LIMIT);
+    }
+
+    return correction;
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Idle_SetValveDuty
+ *===========================================================================*/
+static void Idle_SetValveDuty(float duty)
+{
+    duty = UTILS_LIMIT(duty, 0.0F, (float)UTILS_PERCENTAGE_CONVERTER);
+
+    TIMER_IDLE_VALVE->CCR1 = Utils_FloatToUint32(duty * IDLE_VALVE_TICKS_PER_PERCENT);
+}
+
+
+/* end of file */
@@ -15,6 +15,7 @@
 #include "ignition_driver.h"
 
 #include "engine_constants.h"
+#include "output_map.h"
 #include "timers.h"
 
 /*===========================================================================*
@@ -23,13 +24,8 @@
  *
  *===========================================================================*/
 
-#define IGNDRV_ENABLE_IGNITION_CHANNEL_1        (TIMER_IGNITION->CCMR1 |= TIM_CCMR1_OC1M)
-#define IGNDRV_ENABLE_IGNITION_CHANNEL_2        (TIMER_IGNITION->CCMR2 |= TIM_CCMR2_OC3M)
-#define IGNDRV_ENABLE_IGNITION_CHANNEL_3        (TIMER_IGNITION->CCMR2 |= TIM_CCMR2_OC4M)
-
-#define IGNDRV_DISABLE_IGNITION_CHANNEL_1       (TIMER_IGNITION->CCMR1 &= ~TIM_CCMR1_OC1M)
-#define IGNDRV_DISABLE_IGNITION_CHANNEL_2       (TIMER_IGNITION->CCMR2 &= ~TIM_CCMR2_OC3M)
-#define IGNDRV_DISABLE_IGNITION_CHANNEL_3       (TIMER_IGNITION->CCMR2 &= ~TIM_CCMR2_OC4M)
+#define IGNDRV_ARM_SPEED_TRIGGER                (TIMER_IGNITION->SMCR |= TIMER_SLAVE_MODE_TRIGGER)
+#define IGNDRV_DISARM_SPEED_TRIGGER             (TIMER_IGNITION->SMCR &= ~TIM_SMCR_SMS)
 
 /*===========================================================================*
  *
@@ -54,7 +50,7 @@
  * param[in]:   None
  * param[out]:  None
  * return:      None
- * details:     Ignition end event interrupt
+ * details:     Ignition start (trigger) event and GPIO outputs interrupts
  *===========================================================================*/
 extern void TIM2_IRQHandler(void);
 
@@ -69,26 +65,7 @@ extern void TIM2_IRQHandler(void);
  *===========================================================================*/
 void IgnDrv_Init(void)
 {
-    /* Ignition timer: TIM2 CH1(PA15)-CH3(PB10)-CH4(PA3) */
-
-    /* Enable GPIOA clock */
-    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN;
-    /* Enable GPIOB clock */
-    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOBEN;
-    /* Disable pull-up and pull-down for GPIOA port 15 */
-    GPIOA->PUPDR &= ~GPIO_PUPDR_PUPD15;
-    /* Set PA15 afternative function 1 (TIM2_CH1) */
-    GPIOA->AFR[1] |= GPIO_AFRH_AFSEL15_0;
-    /* Set PB10 afternative function 1 (TIM2_CH3) */
-    GPIOB->AFR[1] |= GPIO_AFRH_AFSEL10_0;
-    /* Set PA3 afternative function 1 (TIM2_CH4) */
-    GPIOA->AFR[0] |= GPIO_AFRL_AFSEL3_0;
-    /* Set PA15 Alternative function mode */
-    GPIOA->MODER |= GPIO_MODER_MODE15_1;
-    /* Set PB10 Alternative function mode */
-    GPIOB->MODER |= GPIO_MODER_MODE10_1;
-    /* Set PA3 Alternative function mode */
-    GPIOA->MODER |= GPIO_MODER_MODE3_1;
+    /* Ignition timer: TIM2, outputs are assigned in output map */
 
     /* Enable timer clock*/
     RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
@@ -96,17 +73,16 @@ void IgnDrv_Init(void)
     TIMER_IGNITION->PSC = (uint16_t)0U;
     /* Select the up counting mode */
     TIMER_IGNITION->CR1 &= ~(TIM_CR1_DIR | TIM_CR1_CMS);
-    /* Enable ignition channels outputs */
-    TIMER_IGNITION->CCER |= TIM_CCER_CC1E;
-    TIMER_IGNITION->CCER |= TIM_CCER_CC3E;
-    TIMER_IGNITION->CCER |= TIM_CCER_CC4E;
+    /* Initialize ignition outputs */
+    OutMap_Init(OUTMAP_GROUP_IGNITION);
     /* Set one-shot mode */
     TIMER_IGNITION->CR1 |= TIM_CR1_OPM;
+    /* Select speed timer TRGO as trigger input, slave mode stays disabled until channel is prepared */
+    TIMER_IGNITION->SMCR |= TIMER_IGNITION_SPEED_TRIGGER;
 
-    /* Enable interrupt requests */
+    /* Enable trigger interrupt request */
     TIMER_IGNITION->DIER |= TIM_DIER_TIE;
-    /* Enable update interrupt request */
-    TIMER_IGNITION->DIER |= TIM_DIER_UIE;
+    /* Compare and update interrupts are enabled by output map for GPIO outputs only */
 
 #ifdef DEBUG
     /* Stop timer when core is halted in debug */
@@ -121,18 +97,22 @@ void IgnDrv_Init(void)
 /*===========================================================================*
  * Function: IgnDrv_PrepareIgnitionChannel
  *===========================================================================*/
-void IgnDrv_PrepareIgnitionChannel(EnCon_CylinderChannels_T channel, float fireAngle, float startAngle)
+void IgnDrv_PrepareIgnitionChannel(EnCon_CylinderChannels_T channel, float fireAngle, float dwellAngle,
+                                   float startAngle)
 {
-    float engineSpeedRaw;
+    float timerTicksPerAngle;
     float angleDifference;
+    uint32_t dwellTicks;
     uint32_t tmpDelay;
 
-    if ((fireAngle > ENCON_ENGINE_FULL_CYCLE_ANGLE) || (startAngle > ENCON_ENGINE_FULL_CYCLE_ANGLE))
+    if ((channel >= ENCON_CHANNEL_COUNT) || (fireAngle > ENCON_ENGINE_FULL_CYCLE_ANGLE) ||
+        (startAngle > ENCON_ENGINE_FULL_CYCLE_ANGLE) || (dwellAngle < 0.0F))
     {
         goto igndrv_prepare_ignition_channel_exit;
     }
 
-    engineSpeedRaw = EnCon_GetEngineSpeedRaw();
+    timerTicksPerAngle = (TIMER_SPEED_TIM_MULTIPLIER * (float)EnCon_GetEngineSpeedRaw()) /
+                         ENCON_ONE_TRIGGER_PULSE_ANGLE;
     angleDifference = UTILS_CIRCULAR_DIFFERENCE(fireAngle, startAngle, ENCON_ENGINE_FULL_CYCLE_ANGLE);
 
     /* Make sure counter register is reset */
@@ -142,53 +122,32 @@ void IgnDrv_PrepareIgnitionChannel(EnCon_CylinderChannels_T channel, float fireA
     /* tpulse = TIMx_ARR - TIMx_CCR + 1 */
 
     /* Set total time: tdelay + tpulse - 1 = TIMx_ARR */
-    TIMER_IGNITION->ARR = Utils_FloatToUint32((angleDifference / ENCON_ONE_TRIGGER_PULSE_ANGLE) *
-                                              TIMER_SPEED_TIM_MULTIPLIER * engineSpeedRaw) - 1U;
+    TIMER_IGNITION->ARR = Utils_FloatToUint32(angleDifference * timerTicksPerAngle) - 1U;
 
-    /* TIMx_CCR = TIMx_ARR + 1 - tpulse */
-    tmpDelay = (TIMER_IGNITION->ARR + 1U) - TIMER_MS_TO_TIMER_REG_VALUE(ENCON_COILS_DWELL_TIME_MS);
+    /* Both spark and dwell start are given in angle, so dwell ends exactly at the spark angle */
+    dwellTicks = Utils_FloatToUint32(dwellAngle * timerTicksPerAngle);
 
-    switch (channel)
+    /* TIMx_CCR = TIMx_ARR + 1 - tpulse */
+    if (dwellTicks < (TIMER_IGNITION->ARR + 1U))
     {
-        case ENCON_CHANNEL_1:
-            TIMER_IGNITION->CCR1 = tmpDelay;
-            IGNDRV_ENABLE_IGNITION_CHANNEL_1;
-            IGNDRV_DISABLE_IGNITION_CHANNEL_2;
-            IGNDRV_DISABLE_IGNITION_CHANNEL_3;
-            break;
-
-        case ENCON_CHANNEL_2:
-            TIMER_IGNITION->CCR3 = tmpDelay;
-            IGNDRV_ENABLE_IGNITION_CHANNEL_2;
-            IGNDRV_DISABLE_IGNITION_CHANNEL_1;
-            IGNDRV_DISABLE_IGNITION_CHANNEL_3;
-            break;
-
-        case ENCON_CHANNEL_3:
-            TIMER_IGNITION->CCR4 = tmpDelay;
-            IGNDRV_ENABLE_IGNITION_CHANNEL_3;
-            IGNDRV_DISABLE_IGNITION_CHANNEL_1;
-            IGNDRV_DISABLE_IGNITION_CHANNEL_2;
-            break;
-
-        default:
-            break;
+        tmpDelay = (TIMER_IGNITION->ARR + 1U) - dwellTicks;
     }
+    else
+    {
+        /* Not enough time for full dwell, start charging the coil immediately */
+        tmpDelay = 0U;
+    }
+
+    OutMap_SelectChannel(OUTMAP_GROUP_IGNITION, channel, tmpDelay);
+
+    /* Timer will be started by hardware at the next speed signal pulse */
+    IGNDRV_ARM_SPEED_TRIGGER;
 
 igndrv_prepare_ignition_channel_exit:
 
     return;
 }
 
-/*===========================================================================*
- * Function: IGNDRV_StartIgnitionModule
- *===========================================================================*/
-void IgnDrv_StartIgnitionModule(void)
-{
-    /* Start the timer */
-    TIMER_IGNITION->CR1 |= TIM_CR1_CEN;
-}
-
 /*===========================================================================*
  *
  * LOCAL FUNCTION DEFINITION SECTION
@@ -200,16 +159,17 @@ void IgnDrv_StartIgnitionModule(void)
  *===========================================================================*/
 extern void TIM2_IRQHandler(void)
 {
-    /* Overflow interrupt */
-    if (TIMER_IGNITION->SR & TIM_SR_UIF)
+    /* Trigger interrupt - timer has been started by the speed signal */
+    if (TIMER_IGNITION->SR & TIM_SR_TIF)
     {
+        /* Disarm trigger, so next speed signal pulses won't restart finished event */
+        IGNDRV_DISARM_SPEED_TRIGGER;
         /* Clear interrupt flag */
-        TIMER_IGNITION->SR &= ~TIM_SR_UIF;
-    }
-    else
-    {
-        /* Do nothing */
+        TIMER_IGNITION->SR &= ~TIM_SR_TIF;
     }
+
+    /* Compare (start) and overflow (end) interrupts of GPIO outputs */
+    OutMap_OnTimerInterrupt(OUTMAP_GROUP_IGNITION);
 }
 
 
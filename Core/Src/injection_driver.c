@@ -15,6 +15,7 @@
 #include "injection_driver.h"
 
 #include "engine_constants.h"
+#include "output_map.h"
 #include "timers.h"
 
 /*===========================================================================*
@@ -23,13 +24,17 @@
  *
  *===========================================================================*/
 
-#define INJDRV_ENABLE_INJECTION_CHANNEL_1        (TIMER_INJECTOR->CCMR1 |= TIM_CCMR1_OC1M)
-#define INJDRV_ENABLE_INJECTION_CHANNEL_2        (TIMER_INJECTOR->CCMR1 |= TIM_CCMR1_OC2M)
-#define INJDRV_ENABLE_INJECTION_CHANNEL_3        (TIMER_INJECTOR->CCMR2 |= TIM_CCMR2_OC3M)
+#define INJDRV_ARM_SPEED_TRIGGER                 (TIMER_INJECTOR->SMCR |= TIMER_SLAVE_MODE_TRIGGER)
+#define INJDRV_DISARM_SPEED_TRIGGER              (TIMER_INJECTOR->SMCR &= ~TIM_SMCR_SMS)
 
-#define INJDRV_DISABLE_INJECTION_CHANNEL_1       (TIMER_INJECTOR->CCMR1 &= ~TIM_CCMR1_OC1M)
-#define INJDRV_DISABLE_INJECTION_CHANNEL_2       (TIMER_INJECTOR->CCMR1 &= ~TIM_CCMR1_OC2M)
-#define INJDRV_DISABLE_INJECTION_CHANNEL_3       (TIMER_INJECTOR->CCMR2 &= ~TIM_CCMR2_OC3M)
+/* TIM5_UP request: DMA1 Stream6 Channel6 */
+#define INJDRV_PULSES_DMA_STREAM                 (DMA1_Stream6)
+#define INJDRV_PULSES_DMA_CHANNEL                (DMA_SxCR_CHSEL_2 | DMA_SxCR_CHSEL_1)
+#define INJDRV_PULSES_DMA_FLAGS                  (DMA_HIFCR_CTCIF6 | DMA_HIFCR_CHTIF6 | DMA_HIFCR_CTEIF6 |     \
+                                                  DMA_HIFCR_CDMEIF6 | DMA_HIFCR_CFEIF6)
+
+/* DMA burst starts at TIMx_ARR register (offset 0x2C -> 11th 32bit register) */
+#define INJDRV_PULSES_DMA_BURST_ADDRESS          (11U)
 
 /*===========================================================================*
  *
@@ -37,12 +42,29 @@
  *
  *===========================================================================*/
 
+/* Sync with timer registers order starting from TIMx_ARR */
+typedef enum InjDrv_BurstIndex_Tag
+{
+    INJDRV_BURST_INDEX_ARR = 0,
+    /* Offset 0x30 is reserved in TIM5 (RCR exists only in advanced timers), written value is ignored */
+    INJDRV_BURST_INDEX_RESERVED = 1,
+    INJDRV_BURST_INDEX_CCR1 = 2,
+    INJDRV_BURST_INDEX_CCR2 = 3,
+    INJDRV_BURST_INDEX_CCR3 = 4,
+    INJDRV_BURST_INDEX_CCR4 = 5,
+
+    INJDRV_BURST_INDEX_COUNT
+} InjDrv_BurstIndex_T;
+
 /*===========================================================================*
  *
  * GLOBAL VARIABLES AND CONSTANTS SECTION
  *
  *===========================================================================*/
 
+/* Timer periods of the 2nd and following pulses, loaded by DMA at each update event */
+static uint32_t injdrv_pulses_queue[INJDRV_PULSES_MAX - 1U][INJDRV_BURST_INDEX_COUNT];
+
 /*===========================================================================*
  *
  * LOCAL FUNCTION DECLARATION SECTION
@@ -54,10 +76,28 @@
  * param[in]:   None
  * param[out]:  None
  * return:      None
- * details:     Injection end event interrupt
+ * details:     Injection start (trigger) event and GPIO outputs interrupts
  *===========================================================================*/
 extern void TIM5_IRQHandler(void);
 
+/*===========================================================================*
+ * brief:       DMA1 Stream6 Interrupt request handler
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Last queued injection pulse has been loaded into the timer
+ *===========================================================================*/
+extern void DMA1_Stream6_IRQHandler(void);
+
+/*===========================================================================*
+ * brief:       Initialize DMA stream used to queue injection pulses
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+static void InjDrv_PulsesDmaInit(void);
+
 /*===========================================================================*
  *
  * FUNCTION DEFINITION SECTION
@@ -69,22 +109,7 @@ extern void TIM5_IRQHandler(void);
  *===========================================================================*/
 void InjDrv_Init(void)
 {
-    /* Injection timer: TIM5 CH1(PA0)-CH2(PA1)-CH3(PA2) */
-
-    /* Enable GPIOA clock */
-    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN;
-    /* Set PA0 afternative function 2 (TIM5_CH1) */
-    GPIOA->AFR[0] |= GPIO_AFRL_AFSEL0_1;
-    /* Set PA1 afternative function 2 (TIM5_CH2) */
-    GPIOA->AFR[0] |= GPIO_AFRL_AFSEL1_1;
-    /* Set PA2 afternative function 2 (TIM5_CH3) */
-    GPIOA->AFR[0] |= GPIO_AFRL_AFSEL2_1;
-    /* Set PA0 Alternative function mode */
-    GPIOA->MODER |= GPIO_MODER_MODE0_1;
-    /* Set PA1 Alternative function mode */
-    GPIOA->MODER |= GPIO_MODER_MODE1_1;
-    /* Set PA2 Alternative function mode */
-    GPIOA->MODER |= GPIO_MODER_MODE2_1;
+    /* Injection timer: TIM5, outputs are assigned in output map */
 
     /* Enable timer clock*/
     RCC->APB1ENR |= RCC_APB1ENR_TIM5EN;
@@ -92,17 +117,23 @@ void InjDrv_Init(void)
     TIMER_INJECTOR->PSC = (uint16_t)0U;
     /* Select the up counting mode */
     TIMER_INJECTOR->CR1 &= ~(TIM_CR1_DIR | TIM_CR1_CMS);
-    /* Enable injection channels outputs */
-    TIMER_INJECTOR->CCER |= TIM_CCER_CC1E;
-    TIMER_INJECTOR->CCER |= TIM_CCER_CC2E;
-    TIMER_INJECTOR->CCER |= TIM_CCER_CC3E;
+    /* Disable ARR preload, period loaded by DMA burst at the update event applies to the pulse just started */
+    TIMER_INJECTOR->CR1 &= ~TIM_CR1_ARPE;
+    /* Initialize injection outputs */
+    OutMap_Init(OUTMAP_GROUP_INJECTION);
     /* Set one-shot mode */
     TIMER_INJECTOR->CR1 |= TIM_CR1_OPM;
+    /* Select speed timer TRGO as trigger input, slave mode stays disabled until channel is prepared */
+    TIMER_INJECTOR->SMCR |= TIMER_INJECTOR_SPEED_TRIGGER;
 
-    /* Enable interrupt requests */
+    /* Enable trigger interrupt request */
     TIMER_INJECTOR->DIER |= TIM_DIER_TIE;
-    /* Enable update interrupt request */
-    TIMER_INJECTOR->DIER |= TIM_DIER_UIE;
+    /* Compare and update interrupts are enabled by output map for GPIO outputs only, */
+    /* so queued pulses on timer outputs don't wake up the CPU */
+
+    /* Set DMA burst: ARR, reserved word, CCR1, CCR2, CCR3, CCR4 registers are written at each update event */
+    TIMER_INJECTOR->DCR = ((INJDRV_BURST_INDEX_COUNT - 1U) << TIM_DCR_DBL_Pos) |
+                          (INJDRV_PULSES_DMA_BURST_ADDRESS << TIM_DCR_DBA_Pos);
 
 #ifdef DEBUG
     /* Stop timer when core is halted in debug */
@@ -112,82 +143,110 @@ void InjDrv_Init(void)
     NVIC_SetPriority(TIM5_IRQn, 1U);
     NVIC_ClearPendingIRQ(TIM5_IRQn);
     NVIC_EnableIRQ(TIM5_IRQn);
+
+    InjDrv_PulsesDmaInit();
 }
 
 /*===========================================================================*
  * Function: InjDrv_PrepareInjectionChannel
  *===========================================================================*/
-void InjDrv_PrepareInjectionChannel(EnCon_CylinderChannels_T channel, float injAngle, float startAngle,
-                                    float injOpenTimeMs)
+void InjDrv_PrepareInjectionChannel(EnCon_CylinderChannels_T channel, const InjDrv_Pulse_T* pulses,
+                                    uint8_t pulsesNo, float startAngle)
 {
-    float engineSpeedRaw;
-    float angleDifference;
+    float timerTicksPerAngle;
+    uint32_t pulseStart;
+    uint32_t pulseLength;
+    uint32_t periodStart;
+    uint32_t periodDelay;
     uint32_t tmpDelay;
+    uint8_t pulse;
 
-    if ((injAngle > ENCON_ENGINE_FULL_CYCLE_ANGLE) || (startAngle > ENCON_ENGINE_FULL_CYCLE_ANGLE) ||
-        (injAngle < 0.0F) || (startAngle < 0.0F) || (injOpenTimeMs < 0.0F))
+    if ((channel >= ENCON_CHANNEL_COUNT) || (NULL == pulses) || (0U == pulsesNo) ||
+        (pulsesNo > INJDRV_PULSES_MAX) || (startAngle > ENCON_ENGINE_FULL_CYCLE_ANGLE) || (startAngle < 0.0F))
     {
         goto injdrv_prepare_injection_channel_exit;
     }
 
-    engineSpeedRaw = EnCon_GetEngineSpeedRaw();
-    angleDifference = UTILS_CIRCULAR_DIFFERENCE(injAngle, startAngle, ENCON_ENGINE_FULL_CYCLE_ANGLE);
+    for (pulse = 0U; pulse < pulsesNo; pulse++)
+    {
+        if ((pulses[pulse].injAngle > ENCON_ENGINE_FULL_CYCLE_ANGLE) || (pulses[pulse].injAngle < 0.0F) ||
+            (pulses[pulse].openTimeMs < 0.0F))
+        {
+            goto injdrv_prepare_injection_channel_exit;
+        }
+    }
+
+    timerTicksPerAngle = (TIMER_SPEED_TIM_MULTIPLIER * (float)EnCon_GetEngineSpeedRaw()) /
+                         ENCON_ONE_TRIGGER_PULSE_ANGLE;
 
+    /* Make sure no pulses from previous cycle are loaded */
+    INJDRV_PULSES_DMA_STREAM->CR &= ~DMA_SxCR_EN;
+    TIMER_INJECTOR->DIER &= ~TIM_DIER_UDE;
     /* Make sure counter register is reset */
     TIMER_INJECTOR->CNT = 0U;
 
+    /* Every pulse is a separate timer period: */
     /* tdelay = TIMx_CCR */
-    /* injOpenTimeMs <=> tpulse = TIMx_ARR - TIMx_CCR + 1 */
+    /* tpulse = TIMx_ARR - TIMx_CCR + 1 */
+    /* Pulse start is measured from the timer start, period start from the end of previous pulse */
+    periodStart = 0U;
+    tmpDelay = 0U;
 
-    /* Set total time: tdelay + tpulse - 1 = TIMx_ARR */
-    TIMER_INJECTOR->ARR = Utils_FloatToUint32((angleDifference / ENCON_ONE_TRIGGER_PULSE_ANGLE) *
-                                              TIMER_SPEED_TIM_MULTIPLIER * engineSpeedRaw) +
-                          TIMER_MS_TO_TIMER_REG_VALUE(injOpenTimeMs) - 1U;
+    for (pulse = 0U; pulse < pulsesNo; pulse++)
+    {
+        pulseStart = Utils_FloatToUint32(UTILS_CIRCULAR_DIFFERENCE(pulses[pulse].injAngle, startAngle,
+                                                                   ENCON_ENGINE_FULL_CYCLE_ANGLE) * timerTicksPerAngle);
+        pulseLength = TIMER_MS_TO_TIMER_REG_VALUE(pulses[pulse].openTimeMs);
+        /* Overlapping pulses are started right after the previous one */
+        periodDelay = (pulseStart > periodStart) ? (pulseStart - periodStart) : 0U;
+
+        if (0U == pulse)
+        {
+            /* Set total time: tdelay + tpulse - 1 = TIMx_ARR */
+            TIMER_INJECTOR->ARR = periodDelay + pulseLength - 1U;
+            tmpDelay = periodDelay;
+        }
+        else
+        {
+            injdrv_pulses_queue[pulse - 1U][INJDRV_BURST_INDEX_ARR] = periodDelay + pulseLength - 1U;
+            injdrv_pulses_queue[pulse - 1U][INJDRV_BURST_INDEX_RESERVED] = 0U;
+            injdrv_pulses_queue[pulse - 1U][INJDRV_BURST_INDEX_CCR1] = periodDelay;
+            injdrv_pulses_queue[pulse - 1U][INJDRV_BURST_INDEX_CCR2] = periodDelay;
+            injdrv_pulses_queue[pulse - 1U][INJDRV_BURST_INDEX_CCR3] = periodDelay;
+            injdrv_pulses_queue[pulse - 1U][INJDRV_BURST_INDEX_CCR4] = periodDelay;
+        }
+
+        periodStart += periodDelay + pulseLength;
+    }
 
-    /* TIMx_CCR = TIMx_ARR + 1 - tpulse */
-    tmpDelay = (TIMER_INJECTOR->ARR + 1U) - TIMER_MS_TO_TIMER_REG_VALUE(injOpenTimeMs);
+    OutMap_SelectChannel(OUTMAP_GROUP_INJECTION, channel, tmpDelay);
 
-    switch (channel)
+    if (pulsesNo > 1U)
     {
-        case ENCON_CHANNEL_1:
-            TIMER_INJECTOR->CCR1 = tmpDelay;
-            INJDRV_ENABLE_INJECTION_CHANNEL_1;
-            INJDRV_DISABLE_INJECTION_CHANNEL_2;
-            INJDRV_DISABLE_INJECTION_CHANNEL_3;
-            break;
-
-        case ENCON_CHANNEL_2:
-            TIMER_INJECTOR->CCR2 = tmpDelay;
-            INJDRV_ENABLE_INJECTION_CHANNEL_2;
-            INJDRV_DISABLE_INJECTION_CHANNEL_1;
-            INJDRV_DISABLE_INJECTION_CHANNEL_3;
-            break;
-
-        case ENCON_CHANNEL_3:
-            TIMER_INJECTOR->CCR3 = tmpDelay;
-            INJDRV_ENABLE_INJECTION_CHANNEL_3;
-            INJDRV_DISABLE_INJECTION_CHANNEL_1;
-            INJDRV_DISABLE_INJECTION_CHANNEL_2;
-            break;
-
-        default:
-            break;
+        /* Timer runs continuously, next pulses are loaded by DMA at each update event */
+        /* One-shot mode is restored by DMA interrupt after the last pulse has been loaded */
+        TIMER_INJECTOR->CR1 &= ~TIM_CR1_OPM;
+
+        DMA1->HIFCR = INJDRV_PULSES_DMA_FLAGS;
+        INJDRV_PULSES_DMA_STREAM->NDTR = (uint32_t)(pulsesNo - 1U) * INJDRV_BURST_INDEX_COUNT;
+        INJDRV_PULSES_DMA_STREAM->M0AR = (uint32_t)&injdrv_pulses_queue[0][0];
+        INJDRV_PULSES_DMA_STREAM->CR |= DMA_SxCR_EN;
+
+        TIMER_INJECTOR->DIER |= TIM_DIER_UDE;
+    }
+    else
+    {
+        TIMER_INJECTOR->CR1 |= TIM_CR1_OPM;
     }
 
+    /* Timer will be started by hardware at the next speed signal pulse */
+    INJDRV_ARM_SPEED_TRIGGER;
+
 injdrv_prepare_injection_channel_exit:
 
     return;
 }
 
-/*===========================================================================*
- * Function: InjDrv_StartInjectionModule
- *===========================================================================*/
-void InjDrv_StartInjectionModule(void)
-{
-    /* Start the timer */
-    TIMER_INJECTOR->CR1 |= TIM_CR1_CEN;
-}
-
 /*===========================================================================*
  *
  * LOCAL FUNCTION DEFINITION SECTION
@@ -199,17 +258,67 @@ void InjDrv_StartInjectionModule(void)
  *===========================================================================*/
 extern void TIM5_IRQHandler(void)
 {
-    /* Overflow interrupt */
-    if (TIMER_INJECTOR->SR & TIM_SR_UIF)
+    /* Trigger interrupt - timer has been started by the speed signal */
+    if (TIMER_INJECTOR->SR & TIM_SR_TIF)
+    {
+        /* Disarm trigger, so next speed signal pulses won't restart finished event */
+        INJDRV_DISARM_SPEED_TRIGGER;
+        /* Clear interrupt flag */
+        TIMER_INJECTOR->SR &= ~TIM_SR_TIF;
+    }
+
+    /* Compare (start) and overflow (end) interrupts of GPIO outputs */
+    OutMap_OnTimerInterrupt(OUTMAP_GROUP_INJECTION);
+}
+
+/*===========================================================================*
+ * Function: DMA1_Stream6_IRQHandler
+ *===========================================================================*/
+extern void DMA1_Stream6_IRQHandler(void)
+{
+    if (DMA1->HISR & DMA_HISR_TCIF6)
     {
+        /* Last pulse is already running, stop the timer at its end */
+        TIMER_INJECTOR->CR1 |= TIM_CR1_OPM;
+        TIMER_INJECTOR->DIER &= ~TIM_DIER_UDE;
         /* Clear interrupt flag */
-        TIMER_INJECTOR->SR &= ~TIM_SR_UIF;
+        DMA1->HIFCR = DMA_HIFCR_CTCIF6;
     }
     else
     {
-        /* Do nothing */
+        /* Clear remaining flags */
+        DMA1->HIFCR = INJDRV_PULSES_DMA_FLAGS;
     }
 }
 
+/*===========================================================================*
+ * Function: InjDrv_PulsesDmaInit
+ *===========================================================================*/
+static void InjDrv_PulsesDmaInit(void)
+{
+    /* Enable DMA1 clock */
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+
+    /* Select channel 6 (TIM5_UP) */
+    INJDRV_PULSES_DMA_STREAM->CR |= INJDRV_PULSES_DMA_CHANNEL;
+    /* Set direction to memory to peripherial */
+    INJDRV_PULSES_DMA_STREAM->CR |= DMA_SxCR_DIR_0;
+    /* Enable memory address increment */
+    INJDRV_PULSES_DMA_STREAM->CR |= DMA_SxCR_MINC;
+    /* Set peripherial data size: 32bit */
+    INJDRV_PULSES_DMA_STREAM->CR |= DMA_SxCR_PSIZE_1;
+    /* Set memory data size: 32bit */
+    INJDRV_PULSES_DMA_STREAM->CR |= DMA_SxCR_MSIZE_1;
+    /* Enable transfer complete interrupt */
+    INJDRV_PULSES_DMA_STREAM->CR |= DMA_SxCR_TCIE;
+
+    /* Set peripherial adress - timer DMA burst register */
+    INJDRV_PULSES_DMA_STREAM->PAR = (uint32_t)&TIMER_INJECTOR->DMAR;
+
+    NVIC_SetPriority(DMA1_Stream6_IRQn, 1U);
+    NVIC_ClearPendingIRQ(DMA1_Stream6_IRQn);
+    NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+}
+
 
 /* end of file */
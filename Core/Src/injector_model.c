@@ -0,0 +1,126 @@
+/*===========================================================================*
+ * File:        injector_model.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Injector dead time and short pulse characterisation
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "injector_model.h"
+
+#include "engine_sensors.h"
+#include "tables.h"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/* Short pulse correction lookup covers pulses up to (INJMOD_SHORT_PULSE_LUT_SIZE - 1) steps */
+#define INJMOD_SHORT_PULSE_LUT_SIZE             (33U)
+#define INJMOD_SHORT_PULSE_STEP_MS              (0.05F)
+#define INJMOD_SHORT_PULSE_STEP_MULTIPLIER      (1.0F / INJMOD_SHORT_PULSE_STEP_MS)
+#define INJMOD_SHORT_PULSE_MAX_MS               ((float)(INJMOD_SHORT_PULSE_LUT_SIZE - 1U) * INJMOD_SHORT_PULSE_STEP_MS)
+
+/* Dead time used until the first update */
+#define INJMOD_NOMINAL_VOLTAGE                  (13.5F)
+
+/*===========================================================================*
+ *
+ * LOCAL TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+static float injmod_dead_time_ms;
+
+/* Correction added to the effective open time, evenly spaced by INJMOD_SHORT_PULSE_STEP_MS */
+static float injmod_short_pulse_lut[INJMOD_SHORT_PULSE_LUT_SIZE];
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: InjMod_Init
+ *===========================================================================*/
+void InjMod_Init(void)
+{
+    uint8_t index;
+
+    for (index = 0U; index < INJMOD_SHORT_PULSE_LUT_SIZE; index++)
+    {
+        injmod_short_pulse_lut[index] = Tables_Get2DTableValue(TABLES_2D_INJECTOR_SHORT_PULSE,
+                                                               (float)index * INJMOD_SHORT_PULSE_STEP_MS);
+    }
+
+    injmod_dead_time_ms = Tables_Get2DTableValue(TABLES_2D_INJECTOR_DEAD_TIME, INJMOD_NOMINAL_VOLTAGE);
+}
+
+/*===========================================================================*
+ * Function: InjMod_Update
+ *===========================================================================*/
+void InjMod_Update(void)
+{
+    injmod_dead_time_ms = Tables_Get2DTableValue(TABLES_2D_INJECTOR_DEAD_TIME, EnSens_GetBatteryVoltage());
+}
+
+/*===========================================================================*
+ * Function: InjMod_GetPulseWidth
+ *===========================================================================*/
+float InjMod_GetPulseWidth(float fuelMs)
+{
+    float position;
+    float pulseMs;
+    uint32_t index;
+
+    if (fuelMs <= 0.0F)
+    {
+        pulseMs = 0.0F;
+    }
+    else if (fuelMs >= INJMOD_SHORT_PULSE_MAX_MS)
+    {
+        /* Linear region of the injector */
+        pulseMs = fuelMs + injmod_short_pulse_lut[INJMOD_SHORT_PULSE_LUT_SIZE - 1U] + injmod_dead_time_ms;
+    }
+    else
+    {
+        position = fuelMs * INJMOD_SHORT_PULSE_STEP_MULTIPLIER;
+        index = (uint32_t)position;
+
+        pulseMs = fuelMs + injmod_short_pulse_lut[index] +
+                  ((injmod_short_pulse_lut[index + 1U] - injmod_short_pulse_lut[index]) *
+                   (position - (float)index)) + injmod_dead_time_ms;
+    }
+
+    return pulseMs;
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+
+/* end of file */
@@ -0,0 +1,235 @@
+/*===========================================================================*
+ * File:        knock.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Knock detection and spark retard
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "knock.h"
+
+#include "engine_sensors.h"
+
+#include "arm_math.h"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/* Cylinder resonance frequency, depends on the bore */
+#define KNOCK_FREQUENCY_HZ                      (7500.0F)
+
+/* Shorter windows don't resolve knock frequency */
+#define KNOCK_WINDOW_SAMPLES_MIN                (16U)
+
+/* Window is split into segments, averaged segment energies have much lower variance than one long Goertzel */
+/* 64 samples at 30kHz resolve 470Hz band, close to the width of the knock resonance */
+#define KNOCK_SEGMENT_SAMPLES                   (64U)
+
+/* Windows used only for background learning after start */
+#define KNOCK_LEARNING_WINDOWS_NO               (32U)
+/* Background energy IIR filter factor */
+#define KNOCK_BACKGROUND_FILTER_FACTOR          (0.05F)
+
+/* Window energy to background ratio detected as knock */
+#define KNOCK_THRESHOLD_RATIO                   (3.0F)
+
+#define KNOCK_RETARD_STEP_ANGLE                 (2.0F)
+/* Advance is restored by this angle every window without knock */
+#define KNOCK_RETARD_RECOVERY_ANGLE             (0.1F)
+#define KNOCK_RETARD_MAX_ANGLE                  (10.0F)
+
+/*===========================================================================*
+ *
+ * LOCAL TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+typedef struct Knock_CylinderState_Tag
+{
+    /* Learned energy of knock frequency without knock */
+    float background;
+    uint16_t windowsNo;
+    volatile float retard;
+} Knock_CylinderState_T;
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+static Knock_CylinderState_T knock_cylinders[ENCON_CHANNEL_COUNT];
+
+/* Goertzel filter coefficient for knock frequency */
+static float knock_goertzel_coeff;
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Calculate signal energy at knock frequency
+ * param[in]:   samples - knock sensor samples
+ * param[in]:   samplesNo - number of samples
+ * param[out]:  None
+ * return:      float - energy normalized to the number of samples
+ * details:     Goertzel algorithm, single frequency is cheaper than FFT. DC offset is removed.
+ *              Energies of window segments are averaged
+ *===========================================================================*/
+static float Knock_CalculateEnergy(const float* samples, uint16_t samplesNo);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Knock_Init
+ *===========================================================================*/
+void Knock_Init(void)
+{
+    EnCon_CylinderChannels_T channel;
+
+    knock_goertzel_coeff = 2.0F * arm_cos_f32((2.0F * PI * KNOCK_FREQUENCY_HZ) /
+                                              EnSens_GetKnockSamplingFrequency());
+
+    for (channel = ENCON_CHANNEL_1; channel < ENCON_CHANNEL_COUNT; channel++)
+    {
+        knock_cylinders[channel].background = 0.0F;
+        knock_cylinders[channel].windowsNo = 0U;
+        knock_cylinders[channel].retard = 0.0F;
+    }
+}
+
+/*===========================================================================*
+ * Function: Knock_OnWindowCaptured
+ *===========================================================================*/
+void Knock_OnWindowCaptured(EnCon_CylinderChannels_T channel, const float* samples, uint16_t samplesNo)
+{
+    Knock_CylinderState_T* cylinder;
+    float energy;
+    float retard;
+
+    if ((channel >= ENCON_CHANNEL_COUNT) || (samplesNo < KNOCK_WINDOW_SAMPLES_MIN))
+    {
+        goto knock_on_window_captured_exit;
+    }
+
+    cylinder = &knock_cylinders[channel];
+    energy = Knock_CalculateEnergy(samples, samplesNo);
+    retard = cylinder->retard;
+
+    if (cylinder->windowsNo < KNOCK_LEARNING_WINDOWS_NO)
+    {
+        /* Start from the first window energy */
+        if (0U == cylinder->windowsNo)
+        {
+            cylinder->background = energy;
+        }
+
+        cylinder->background += KNOCK_BACKGROUND_FILTER_FACTOR * (energy - cylinder->background);
+        cylinder->windowsNo++;
+    }
+    else if (energy > (cylinder->background * KNOCK_THRESHOLD_RATIO))
+    {
+        /* Knock windows are not learned as background */
+        retard += KNOCK_RETARD_STEP_ANGLE;
+        if (retard > KNOCK_RETARD_MAX_ANGLE)
+        {
+            retard = KNOCK_RETARD_MAX_ANGLE;
+        }
+    }
+    else
+    {
+        cylinder->background += KNOCK_BACKGROUND_FILTER_FACTOR * (energy - cylinder->background);
+
+        retard -= KNOCK_RETARD_RECOVERY_ANGLE;
+        if (retard < 0.0F)
+        {
+            retard = 0.0F;
+        }
+    }
+
+    cylinder->retard = retard;
+
+knock_on_window_captured_exit:
+
+    return;
+}
+
+/*===========================================================================*
+ * Function: Knock_GetRetard
+ *===========================================================================*/
+float Knock_GetRetard(EnCon_CylinderChannels_T channel)
+{
+    return knock_cylinders[channel].retard;
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Knock_CalculateEnergy
+ *===========================================================================*/
+static float Knock_CalculateEnergy(const float* samples, uint16_t samplesNo)
+{
+    float32_t mean;
+    float energy;
+    float s0;
+    float s1;
+    float s2;
+    uint16_t segmentSamplesNo;
+    uint16_t segmentsNo;
+    uint16_t segment;
+    uint16_t index;
+
+    arm_mean_f32((float32_t*)samples, samplesNo, &mean);
+
+    segmentsNo = samplesNo / KNOCK_SEGMENT_SAMPLES;
+    segmentSamplesNo = KNOCK_SEGMENT_SAMPLES;
+
+    /* Short window is one segment */
+    if (0U == segmentsNo)
+    {
+        segmentsNo = 1U;
+        segmentSamplesNo = samplesNo;
+    }
+
+    energy = 0.0F;
+
+    for (segment = 0U; segment < segmentsNo; segment++)
+    {
+        s1 = 0.0F;
+        s2 = 0.0F;
+
+        for (index = 0U; index < segmentSamplesNo; index++)
+        {
+            s0 = (samples[index] - mean) + (knock_goertzel_coeff * s1) - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+
+        energy += (s1 * s1) + (s2 * s2) - (knock_goertzel_coeff * s1 * s2);
+        samples += segmentSamplesNo;
+    }
+
+    return energy / ((float)segmentsNo * (float)segmentSamplesNo * (float)segmentSamplesNo);
+}
+
+
+/* end of file */
@@ -14,12 +14,19 @@
 
 #include "main.h"
 
+#include "cylinder_trim.h"
 #include "engine_sensors.h"
+#include "fuel_trim.h"
+#include "idle_control.h"
 #include "ignition_driver.h"
 #include "injection_driver.h"
+#include "injector_model.h"
+#include "knock.h"
+#include "rev_limiter.h"
 #include "speed_density.h"
 #include "swo.h"
 #include "trigger_decoder.h"
+#include "wall_wetting.h"
 
 Swo_DefineModuleTag(MAIN);
 
@@ -79,6 +86,9 @@ int main(void)
             SpDen_OnTriggerInterrupt();
             main_is_speed_trigger_occured = false;
         }
+
+        FuelTrim_OnBackgroundTask();
+        Idle_OnBackgroundTask();
     }
 }
 
@@ -96,10 +106,19 @@ void Main_CallInits(void)
     DisableIRQ();
 
     Swo_Init();
-    TrigD_Init(SpDen_TriggerCallback);
+    Utils_TimestampInit();
+    /* Ignition and injection timers are started by hardware, no trigger callback needed */
+    TrigD_Init(NULL);
     IgnDrv_Init();
     InjDrv_Init();
+    InjMod_Init();
+    CylTrim_Init();
     EnSens_Init();
+    Knock_Init();
+    WallWet_Init();
+    FuelTrim_Init();
+    RevLim_Init();
+    Idle_Init();
     SpDen_Init();
 
 #if DEBUG
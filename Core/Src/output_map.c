@@ -0,0 +1,394 @@
+/*===========================================================================*
+ * File:        output_map.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Cylinder channels to ignition and injection outputs map
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "output_map.h"
+
+#include "engine_sensors.h"
+#include "timers.h"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+#define OUTMAP_GPIO_MODE_OUTPUT                 (0x01U)
+#define OUTMAP_GPIO_MODE_ALTERNATE              (0x02U)
+
+#define OUTMAP_GPIO_PORT_INDEX(_PORT_)          (((uint32_t)(_PORT_) - GPIOA_BASE) / (GPIOB_BASE - GPIOA_BASE))
+
+#define OUTMAP_GPIO_SET(_OUTPUT_)               ((_OUTPUT_)->port->BSRR = (1UL << (_OUTPUT_)->pin))
+#define OUTMAP_GPIO_RESET(_OUTPUT_)             ((_OUTPUT_)->port->BSRR = (1UL << ((_OUTPUT_)->pin + 16U)))
+
+/* TIMx_CCR1 - TIMx_CCR4 registers are placed one after another */
+#define OUTMAP_TIMER_CCR(_TIMER_, _CHANNEL_)    ((&(_TIMER_)->CCR1)[(_CHANNEL_)])
+#define OUTMAP_TIMER_CCER_CCE(_CHANNEL_)        (TIM_CCER_CC1E << (4U * (uint32_t)(_CHANNEL_)))
+#define OUTMAP_TIMER_DIER_CCIE(_CHANNEL_)       (TIM_DIER_CC1IE << (uint32_t)(_CHANNEL_))
+#define OUTMAP_TIMER_SR_CCIF(_CHANNEL_)         (TIM_SR_CC1IF << (uint32_t)(_CHANNEL_))
+
+/*===========================================================================*
+ *
+ * LOCAL TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+typedef enum OutMap_TimerChannel_Tag
+{
+    OUTMAP_TIMER_CHANNEL_1 = 0,
+    OUTMAP_TIMER_CHANNEL_2 = 1,
+    OUTMAP_TIMER_CHANNEL_3 = 2,
+    OUTMAP_TIMER_CHANNEL_4 = 3,
+
+    OUTMAP_TIMER_CHANNEL_COUNT
+} OutMap_TimerChannel_T;
+
+typedef enum OutMap_OutputType_Tag
+{
+    /* Pin is driven directly by the timer channel (PWM mode 2) */
+    OUTMAP_OUTPUT_TYPE_TIMER,
+    /* Pin is toggled from the timer channel compare and timer update interrupts */
+    OUTMAP_OUTPUT_TYPE_GPIO,
+
+    OUTMAP_OUTPUT_TYPE_COUNT
+} OutMap_OutputType_T;
+
+typedef struct OutMap_Output_Tag
+{
+    OutMap_OutputType_T type;
+    OutMap_TimerChannel_T timerChannel;
+    GPIO_TypeDef* port;
+    uint8_t pin;
+    /* Used only with OUTMAP_OUTPUT_TYPE_TIMER */
+    uint8_t alternateFunction;
+} OutMap_Output_T;
+
+typedef struct OutMap_GroupConfig_Tag
+{
+    TIM_TypeDef* timer;
+    /* Outputs in the firing order */
+    OutMap_Output_T outputs[ENCON_CHANNELS_MAX];
+} OutMap_GroupConfig_T;
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+/* Only one event of the group is scheduled at a time, so GPIO outputs share one spare timer channel. */
+/* Timer outputs are exact to one timer tick. GPIO outputs are set and reset in the group timer interrupt, */
+/* so their edges are late by the interrupt latency: TIM3 capture handler (priority 0) and other priority 1 */
+/* handlers may run first. Worst case is estimated at 4us (0.2 deg at 8000 RPM), see test_output_map */
+static const OutMap_GroupConfig_T outmap_groups[OUTMAP_GROUP_COUNT] =
+{
+    [OUTMAP_GROUP_IGNITION] =
+    {
+        .timer = TIMER_IGNITION,
+        .outputs =
+        {
+            { OUTMAP_OUTPUT_TYPE_TIMER, OUTMAP_TIMER_CHANNEL_1, GPIOA, 15U, 1U },
+            { OUTMAP_OUTPUT_TYPE_TIMER, OUTMAP_TIMER_CHANNEL_3, GPIOB, 10U, 1U },
+#if ENSENS_OIL_PRESSURE_SENSOR_ENABLED
+            /* PA3 is used by oil pressure sensor */
+            { OUTMAP_OUTPUT_TYPE_GPIO, OUTMAP_TIMER_CHANNEL_2, GPIOB, 2U, 0U },
+#else
+            { OUTMAP_OUTPUT_TYPE_TIMER, OUTMAP_TIMER_CHANNEL_4, GPIOA, 3U, 1U },
+#endif
+            /* TIM2_CH2 pins are taken (PA1 - injector, PB3 - SWO), channel is used only internally */
+            { OUTMAP_OUTPUT_TYPE_GPIO, OUTMAP_TIMER_CHANNEL_2, GPIOB, 12U, 0U },
+            { OUTMAP_OUTPUT_TYPE_GPIO, OUTMAP_TIMER_CHANNEL_2, GPIOB, 13U, 0U },
+            { OUTMAP_OUTPUT_TYPE_GPIO, OUTMAP_TIMER_CHANNEL_2, GPIOB, 14U, 0U },
+            { OUTMAP_OUTPUT_TYPE_GPIO, OUTMAP_TIMER_CHANNEL_2, GPIOB, 15U, 0U },
+            { OUTMAP_OUTPUT_TYPE_GPIO, OUTMAP_TIMER_CHANNEL_2, GPIOA, 12U, 0U }
+        }
+    },
+    [OUTMAP_GROUP_INJECTION] =
+    {
+        .timer = TIMER_INJECTOR,
+        .outputs =
+        {
+            { OUTMAP_OUTPUT_TYPE_TIMER, OUTMAP_TIMER_CHANNEL_1, GPIOA, 0U, 2U },
+            { OUTMAP_OUTPUT_TYPE_TIMER, OUTMAP_TIMER_CHANNEL_2, GPIOA, 1U, 2U },
+#if ENSENS_KNOCK_SENSOR_ENABLED
+            /* PA2 is used by knock sensor */
+            { OUTMAP_OUTPUT_TYPE_GPIO, OUTMAP_TIMER_CHANNEL_4, GPIOB, 7U, 0U },
+#else
+            { OUTMAP_OUTPUT_TYPE_TIMER, OUTMAP_TIMER_CHANNEL_3, GPIOA, 2U, 2U },
+#endif
+            /* TIM5_CH4 pin (PA3) is used by ignition, channel is used only internally */
+            { OUTMAP_OUTPUT_TYPE_GPIO, OUTMAP_TIMER_CHANNEL_4, GPIOA, 8U, 0U },
+            { OUTMAP_OUTPUT_TYPE_GPIO, OUTMAP_TIMER_CHANNEL_4, GPIOA, 9U, 0U },
+            { OUTMAP_OUTPUT_TYPE_GPIO, OUTMAP_TIMER_CHANNEL_4, GPIOA, 10U, 0U },
+            { OUTMAP_OUTPUT_TYPE_GPIO, OUTMAP_TIMER_CHANNEL_4, GPIOA, 11U, 0U },
+            { OUTMAP_OUTPUT_TYPE_GPIO, OUTMAP_TIMER_CHANNEL_4, GPIOB, 6U, 0U }
+        }
+    }
+};
+
+/* Output selected for the current group timer event */
+static const OutMap_Output_T* volatile outmap_active_outputs[OUTMAP_GROUP_COUNT];
+
+/* Delay of GPIO outputs set after the compare event, in timer ticks (equal to core cycles) */
+static Utils_CyclesStats_T outmap_gpio_latencies[OUTMAP_GROUP_COUNT];
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Set timer channel output compare mode
+ * param[in]:   timer - timer containing the channel
+ * param[in]:   timerChannel - timer channel
+ * param[in]:   isEnabled - true sets PWM mode 2, false sets frozen mode
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+static void OutMap_SetOutputCompareMode(TIM_TypeDef* timer, OutMap_TimerChannel_T timerChannel, bool isEnabled);
+
+/*===========================================================================*
+ * brief:       Select group output driven by the next timer event
+ * param[in]:   group - outputs group
+ * param[in]:   output - output to be selected
+ * param[in]:   compareValue - timer compare value at which output is activated
+ * param[out]:  None
+ * return:      None
+ * details:     Parameters are not checked
+ *===========================================================================*/
+static void OutMap_SelectOutput(OutMap_Group_T group, const OutMap_Output_T* output, uint32_t compareValue);
+
+/*===========================================================================*
+ * brief:       Disable output, so it won't be driven by the next timer event
+ * param[in]:   timer - group timer
+ * param[in]:   output - output to be disabled
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+static void OutMap_DisableOutput(TIM_TypeDef* timer, const OutMap_Output_T* output);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: OutMap_Init
+ *===========================================================================*/
+void OutMap_Init(OutMap_Group_T group)
+{
+    const OutMap_GroupConfig_T* config;
+    const OutMap_Output_T* output;
+    uint8_t channel;
+
+    if (group >= OUTMAP_GROUP_COUNT)
+    {
+        goto outmap_init_exit;
+    }
+
+    config = &outmap_groups[group];
+
+    /* Disable compare preload of all channels. Injection DMA burst writes CCRx at the update event, */
+    /* with preload the value would be applied one period (pulse) too late */
+    config->timer->CCMR1 &= ~(TIM_CCMR1_OC1PE | TIM_CCMR1_OC2PE);
+    config->timer->CCMR2 &= ~(TIM_CCMR2_OC3PE | TIM_CCMR2_OC4PE);
+
+    for (channel = 0U; channel < ENCON_CHANNEL_COUNT; channel++)
+    {
+        output = &config->outputs[channel];
+
+        /* Enable GPIO port clock */
+        RCC->AHB1ENR |= (RCC_AHB1ENR_GPIOAEN << OUTMAP_GPIO_PORT_INDEX(output->port));
+        /* Disable pull-up and pull-down */
+        output->port->PUPDR &= ~(GPIO_PUPDR_PUPD0 << (2U * output->pin));
+        output->port->MODER &= ~(GPIO_MODER_MODE0 << (2U * output->pin));
+
+        if (OUTMAP_OUTPUT_TYPE_TIMER == output->type)
+        {
+            /* Set alternative function */
+            output->port->AFR[output->pin / 8U] |= ((uint32_t)output->alternateFunction <<
+                                                   (4U * (output->pin % 8U)));
+            /* Set Alternative function mode */
+            output->port->MODER |= (OUTMAP_GPIO_MODE_ALTERNATE << (2U * output->pin));
+            /* Enable timer channel output */
+            config->timer->CCER |= OUTMAP_TIMER_CCER_CCE(output->timerChannel);
+        }
+        else
+        {
+            OUTMAP_GPIO_RESET(output);
+            /* Set general purpose output mode */
+            output->port->MODER |= (OUTMAP_GPIO_MODE_OUTPUT << (2U * output->pin));
+        }
+    }
+
+    outmap_active_outputs[group] = NULL;
+
+outmap_init_exit:
+
+    return;
+}
+
+/*===========================================================================*
+ * Function: OutMap_SelectChannel
+ *===========================================================================*/
+void OutMap_SelectChannel(OutMap_Group_T group, EnCon_CylinderChannels_T channel, uint32_t compareValue)
+{
+    if ((group >= OUTMAP_GROUP_COUNT) || (channel >= ENCON_CHANNEL_COUNT))
+    {
+        goto outmap_select_channel_exit;
+    }
+
+    OutMap_SelectOutput(group, &outmap_groups[group].outputs[channel], compareValue);
+
+outmap_select_channel_exit:
+
+    return;
+}
+
+/*===========================================================================*
+ * Function: OutMap_OnTimerInterrupt
+ *===========================================================================*/
+void OutMap_OnTimerInterrupt(OutMap_Group_T group)
+{
+    const OutMap_Output_T* output;
+    TIM_TypeDef* timer;
+    uint32_t latency;
+
+    if (group >= OUTMAP_GROUP_COUNT)
+    {
+        goto outmap_on_timer_interrupt_exit;
+    }
+
+    output = outmap_active_outputs[group];
+    timer = outmap_groups[group].timer;
+
+    if ((NULL == output) || (output->type != OUTMAP_OUTPUT_TYPE_GPIO))
+    {
+        goto outmap_on_timer_interrupt_exit;
+    }
+
+    /* Update event ends the pulse - handled first, as the next pulse may start at the same time */
+    if (timer->SR & TIM_SR_UIF)
+    {
+        OUTMAP_GPIO_RESET(output);
+        /* Clear interrupt flag */
+        timer->SR &= ~TIM_SR_UIF;
+    }
+
+    /* Compare event starts the pulse */
+    if (timer->SR & OUTMAP_TIMER_SR_CCIF(output->timerChannel))
+    {
+        /* Compare match at counter reset of stopped one-shot timer is not a pulse */
+        if (timer->CR1 & TIM_CR1_CEN)
+        {
+            OUTMAP_GPIO_SET(output);
+
+            /* Pulse end is delayed the same way, but stopped one-shot timer doesn't keep the update time */
+            latency = timer->CNT - OUTMAP_TIMER_CCR(timer, output->timerChannel);
+            outmap_gpio_latencies[group].last = latency;
+            if (latency > outmap_gpio_latencies[group].max)
+            {
+                outmap_gpio_latencies[group].max = latency;
+            }
+        }
+        /* Clear interrupt flag */
+        timer->SR &= ~OUTMAP_TIMER_SR_CCIF(output->timerChannel);
+    }
+
+outmap_on_timer_interrupt_exit:
+
+    return;
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: OutMap_SetOutputCompareMode
+ *===========================================================================*/
+static void OutMap_SetOutputCompareMode(TIM_TypeDef* timer, OutMap_TimerChannel_T timerChannel, bool isEnabled)
+{
+    volatile uint32_t* ccmr;
+    uint32_t mode;
+
+    /* TIMx_CCMR1 -> channels 1 and 2, TIMx_CCMR2 -> channels 3 and 4 */
+    ccmr = (timerChannel < OUTMAP_TIMER_CHANNEL_3) ? &timer->CCMR1 : &timer->CCMR2;
+    mode = TIM_CCMR1_OC1M << (8U * ((uint32_t)timerChannel % 2U));
+
+    if (isEnabled)
+    {
+        *ccmr |= mode;
+    }
+    else
+    {
+        *ccmr &= ~mode;
+    }
+}
+
+/*===========================================================================*
+ * Function: OutMap_SelectOutput
+ *===========================================================================*/
+static void OutMap_SelectOutput(OutMap_Group_T group, const OutMap_Output_T* output, uint32_t compareValue)
+{
+    const OutMap_GroupConfig_T* config;
+    uint8_t otherChannel;
+
+    config = &outmap_groups[group];
+
+    for (otherChannel = 0U; otherChannel < ENCON_CHANNEL_COUNT; otherChannel++)
+    {
+        OutMap_DisableOutput(config->timer, &config->outputs[otherChannel]);
+    }
+
+    OUTMAP_TIMER_CCR(config->timer, output->timerChannel) = compareValue;
+
+    if (OUTMAP_OUTPUT_TYPE_TIMER == output->type)
+    {
+        OutMap_SetOutputCompareMode(config->timer, output->timerChannel, true);
+        /* Update interrupt is needed only for GPIO outputs */
+        config->timer->DIER &= ~TIM_DIER_UIE;
+    }
+    else
+    {
+        config->timer->SR &= ~(OUTMAP_TIMER_SR_CCIF(output->timerChannel) | TIM_SR_UIF);
+        /* Set output at compare event, reset it at update event */
+        config->timer->DIER |= OUTMAP_TIMER_DIER_CCIE(output->timerChannel) | TIM_DIER_UIE;
+    }
+
+    outmap_active_outputs[group] = output;
+}
+
+/*===========================================================================*
+ * Function: OutMap_DisableOutput
+ *===========================================================================*/
+static void OutMap_DisableOutput(TIM_TypeDef* timer, const OutMap_Output_T* output)
+{
+    if (OUTMAP_OUTPUT_TYPE_TIMER == output->type)
+    {
+        OutMap_SetOutputCompareMode(timer, output->timerChannel, false);
+    }
+    else
+    {
+        timer->DIER &= ~OUTMAP_TIMER_DIER_CCIE(output->timerChannel);
+    }
+}
+
+
+/* end of file */
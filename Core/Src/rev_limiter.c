@@ -0,0 +1,277 @@
+/*===========================================================================*
+ * File:        rev_limiter.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Engine speed limiter and launch control
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "rev_limiter.h"
+
+#include "engine_constants.h"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+#define REVLIM_CUT_MODE                         (REVLIM_CUT_MODE_FUEL)
+#define REVLIM_LAUNCH_CUT_MODE                  (REVLIM_CUT_MODE_SOFT)
+
+#define REVLIM_LIMIT_RPM                        (6800.0F)
+#define REVLIM_LAUNCH_LIMIT_RPM                 (4000.0F)
+
+/* Cut level rises by one every step above the limit */
+#define REVLIM_LEVEL_STEP_RPM                   (25.0F)
+#define REVLIM_LEVEL_STEP_MULTIPLIER            (1.0F / REVLIM_LEVEL_STEP_RPM)
+
+/* Level 0 is no cut, level N cuts N/REVLIM_CUT_LEVELS_NO of events */
+#define REVLIM_CUT_LEVELS_NO                    (8U)
+
+/* Soft cut retards spark on the first levels, then cut pattern starts from the lowest level */
+#define REVLIM_SOFT_RETARD_LEVELS_NO            (4U)
+#define REVLIM_SOFT_RETARD_STEP_ANGLE           (3.0F)
+
+/* Events in one pattern, prime length is not a multiple of any cylinders number, */
+/* so cut events rotate over all cylinders. Pattern is a bitmap, 32 events at most */
+#define REVLIM_PATTERN_LENGTH                   (17U)
+
+#if ((REVLIM_PATTERN_LENGTH % ENCON_ENGINE_PISTONS_NO) == 0U)
+#error "REVLIM_PATTERN_LENGTH can't be a multiple of ENCON_ENGINE_PISTONS_NO, the same cylinders would be cut"
+#endif
+#if (REVLIM_PATTERN_LENGTH > 32U)
+#error "REVLIM_PATTERN_LENGTH doesn't fit in the pattern bitmap"
+#endif
+
+/* Clutch switch to the ground, pulled up internally */
+#define REVLIM_LAUNCH_PORT                      (GPIOB)
+#define REVLIM_LAUNCH_PIN                       (8U)
+#define REVLIM_IS_LAUNCH_ACTIVE                 (0U == (REVLIM_LAUNCH_PORT->IDR & (1UL << REVLIM_LAUNCH_PIN)))
+
+/*===========================================================================*
+ *
+ * LOCAL TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+typedef struct RevLim_State_Tag
+{
+    RevLim_CutMode_T mode;
+    /* Index of revlim_patterns used for ignition and injection events */
+    uint8_t sparkCutLevel;
+    uint8_t fuelCutLevel;
+    /* Pattern positions */
+    uint8_t sparkEvent;
+    uint8_t fuelEvent;
+    float retard;
+} RevLim_State_T;
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+/* Bit set means the event is cut */
+static uint32_t revlim_patterns[REVLIM_CUT_LEVELS_NO + 1U];
+
+static RevLim_State_T revlim_state;
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Build cut patterns of all levels
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Cut events are spread evenly over the pattern
+ *===========================================================================*/
+static void RevLim_BuildPatterns(void);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: RevLim_Init
+ *===========================================================================*/
+void RevLim_Init(void)
+{
+    RevLim_BuildPatterns();
+
+    revlim_state.mode = REVLIM_CUT_MODE;
+    revlim_state.sparkCutLevel = 0U;
+    revlim_state.fuelCutLevel = 0U;
+    revlim_state.sparkEvent = 0U;
+    revlim_state.fuelEvent = 0U;
+    revlim_state.retard = 0.0F;
+
+    /* Enable GPIOB clock */
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOBEN;
+    /* Input mode with pull-up */
+    REVLIM_LAUNCH_PORT->MODER &= ~(GPIO_MODER_MODE0 << (REVLIM_LAUNCH_PIN * 2U));
+    REVLIM_LAUNCH_PORT->PUPDR &= ~(GPIO_PUPDR_PUPD0 << (REVLIM_LAUNCH_PIN * 2U));
+    REVLIM_LAUNCH_PORT->PUPDR |= GPIO_PUPDR_PUPD0_0 << (REVLIM_LAUNCH_PIN * 2U);
+}
+
+/*===========================================================================*
+ * Function: RevLim_Update
+ *===========================================================================*/
+void RevLim_Update(float speed)
+{
+    RevLim_CutMode_T mode;
+    float limit;
+    float levelValue;
+    uint8_t level;
+
+    if (REVLIM_IS_LAUNCH_ACTIVE)
+    {
+        mode = REVLIM_LAUNCH_CUT_MODE;
+        limit = REVLIM_LAUNCH_LIMIT_RPM;
+    }
+    else
+    {
+        mode = REVLIM_CUT_MODE;
+        limit = REVLIM_LIMIT_RPM;
+    }
+
+    if (speed < limit)
+    {
+        level = 0U;
+    }
+    else
+    {
+        levelValue = ((speed - limit) * REVLIM_LEVEL_STEP_MULTIPLIER) + 1.0F;
+        level = (levelValue >= (float)REVLIM_CUT_LEVELS_NO) ? REVLIM_CUT_LEVELS_NO : (uint8_t)levelValue;
+    }
+
+    revlim_state.mode = mode;
+    revlim_state.sparkCutLevel = 0U;
+    revlim_state.fuelCutLevel = 0U;
+    revlim_state.retard = 0.0F;
+
+    switch (mode)
+    {
+        case REVLIM_CUT_MODE_SPARK:
+            revlim_state.sparkCutLevel = level;
+            break;
+
+        case REVLIM_CUT_MODE_FUEL:
+            revlim_state.fuelCutLevel = level;
+            break;
+
+        case REVLIM_CUT_MODE_SOFT:
+            if (level > REVLIM_SOFT_RETARD_LEVELS_NO)
+            {
+                revlim_state.sparkCutLevel = level - REVLIM_SOFT_RETARD_LEVELS_NO;
+                revlim_state.retard = (float)REVLIM_SOFT_RETARD_LEVELS_NO * REVLIM_SOFT_RETARD_STEP_ANGLE;
+            }
+            else
+            {
+                revlim_state.retard = (float)level * REVLIM_SOFT_RETARD_STEP_ANGLE;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*===========================================================================*
+ * Function: RevLim_IsSparkCut
+ *===========================================================================*/
+bool RevLim_IsSparkCut(void)
+{
+    bool result;
+
+    result = (0U != (revlim_patterns[revlim_state.sparkCutLevel] & (1UL << revlim_state.sparkEvent)));
+    revlim_state.sparkEvent++;
+
+    if (revlim_state.sparkEvent >= REVLIM_PATTERN_LENGTH)
+    {
+        revlim_state.sparkEvent = 0U;
+    }
+
+    return result;
+}
+
+/*===========================================================================*
+ * Function: RevLim_IsFuelCut
+ *===========================================================================*/
+bool RevLim_IsFuelCut(void)
+{
+    bool result;
+
+    result = (0U != (revlim_patterns[revlim_state.fuelCutLevel] & (1UL << revlim_state.fuelEvent)));
+    revlim_state.fuelEvent++;
+
+    if (revlim_state.fuelEvent >= REVLIM_PATTERN_LENGTH)
+    {
+        revlim_state.fuelEvent = 0U;
+    }
+
+    return result;
+}
+
+/*===========================================================================*
+ * Function: RevLim_IsCutActive
+ *===========================================================================*/
+bool RevLim_IsCutActive(void)
+{
+    return (0U != revlim_state.sparkCutLevel) || (0U != revlim_state.fuelCutLevel);
+}
+
+/*===========================================================================*
+ * Function: RevLim_GetRetard
+ *===========================================================================*/
+float RevLim_GetRetard(void)
+{
+    return revlim_state.retard;
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: RevLim_BuildPatterns
+ *===========================================================================*/
+static void RevLim_BuildPatterns(void)
+{
+    uint8_t level;
+    uint8_t event;
+    uint32_t cutEvents;
+
+    for (level = 0U; level <= REVLIM_CUT_LEVELS_NO; level++)
+    {
+        revlim_patterns[level] = 0U;
+        cutEvents = ((uint32_t)level * REVLIM_PATTERN_LENGTH) / REVLIM_CUT_LEVELS_NO;
+
+        for (event = 0U; event < REVLIM_PATTERN_LENGTH; event++)
+        {
+            /* Event is cut when the cut count rounded down increases, as in line drawing */
+            if ((((event + 1U) * cutEvents) / REVLIM_PATTERN_LENGTH) > ((event * cutEvents) / REVLIM_PATTERN_LENGTH))
+            {
+                revlim_patterns[level] |= (1UL << event);
+            }
+        }
+    }
+}
+
+
+/* end of file */
@@ -14,11 +14,18 @@
 
 #include "speed_density.h"
 
+#include "cylinder_trim.h"
 #include "engine_constants.h"
 #include "engine_sensors.h"
+#include "fuel_trim.h"
+#include "idle_control.h"
 #include "ignition_driver.h"
 #include "injection_driver.h"
+#include "injector_model.h"
+#include "knock.h"
+#include "rev_limiter.h"
 #include "tables.h"
+#include "wall_wetting.h"
 
 /*===========================================================================*
  *
@@ -30,7 +37,8 @@
 
 #define SPDEN_INJECTOR_FLOW_RATE_CC_SEC    (ENCON_INJECTOR_FLOW_RATE_CC_MIN / 60.0F)
 
-#define SPDEN_TARGET_AFR                   (14.7F)
+/* Gasoline AFR at lambda 1.0, target mixture comes from TABLES_3D_TARGET_LAMBDA_RECIPROCAL */
+#define SPDEN_STOICHIOMETRIC_AFR           (14.7F)
 
 /* Density in g/cm^3 */
 #define SPDEN_FUEL_DENSITY                 (0.75F)
@@ -41,43 +49,96 @@
 /* J/(mol*K) */
 #define SPDEN_GAS_CONSTANT                 (8.314F)
 
-/* Value is normalized to use in SPDEN_AIR_MASS, where pressure is given in kPa (kilo prefix is represented as 1000) */
+/* Value is normalized to use with pressure given in kPa (kilo prefix is represented as 1000) */
 #define SPDEN_CYLINDER_VOLUME               ((ENCON_ENGINE_DISPLACEMENT_M3 * 1000.0F) / (float)ENCON_ENGINE_PISTONS_NO)
 
-#define SPDEN_AIR_MASS(_PRESS_, _TEMP_)    (((_PRESS_) / (_TEMP_)) * spden_air_mass_helper)
+/* Air mass in g is pressure in kPa divided by temperature in K and multiplied by this value */
+#define SPDEN_AIR_MASS_MULTIPLIER          ((SPDEN_CYLINDER_VOLUME * SPDEN_AIR_MOLAR_MASS) / SPDEN_GAS_CONSTANT)
 
-#define SPDEN_PISTON_1_INTAKE_ANGLE        (UTILS_CIRCULAR_ADDITION(ENCON_ENGINE_PISTON_1_OFFSET,           \
-                                            ENCON_ENGINE_INTAKE_ANGLE, ENCON_ENGINE_FULL_CYCLE_ANGLE))
-#define SPDEN_PISTON_2_INTAKE_ANGLE        (UTILS_CIRCULAR_ADDITION(ENCON_ENGINE_PISTON_2_OFFSET,           \
-                                            ENCON_ENGINE_INTAKE_ANGLE, ENCON_ENGINE_FULL_CYCLE_ANGLE))
-#define SPDEN_PISTON_3_INTAKE_ANGLE        (UTILS_CIRCULAR_ADDITION(ENCON_ENGINE_PISTON_3_OFFSET,           \
-                                            ENCON_ENGINE_INTAKE_ANGLE, ENCON_ENGINE_FULL_CYCLE_ANGLE))
+/* Percentage is converted by multiplication, float division is not replaced by the compiler */
+#define SPDEN_PERCENTAGE_MULTIPLIER        (1.0F / (float)UTILS_PERCENTAGE_CONVERTER)
 
-#define SPDEN_PISTON_1_INTAKE_END_ANGLE    (UTILS_CIRCULAR_ADDITION(ENCON_ENGINE_PISTON_1_OFFSET,           \
-                                            ENCON_ENGINE_COMPRESSION_ANGLE, ENCON_ENGINE_FULL_CYCLE_ANGLE))
-#define SPDEN_PISTON_2_INTAKE_END_ANGLE    (UTILS_CIRCULAR_ADDITION(ENCON_ENGINE_PISTON_2_OFFSET,           \
-                                            ENCON_ENGINE_COMPRESSION_ANGLE, ENCON_ENGINE_FULL_CYCLE_ANGLE))
-#define SPDEN_PISTON_3_INTAKE_END_ANGLE    (UTILS_CIRCULAR_ADDITION(ENCON_ENGINE_PISTON_3_OFFSET,           \
-                                            ENCON_ENGINE_COMPRESSION_ANGLE, ENCON_ENGINE_FULL_CYCLE_ANGLE))
+#define SPDEN_PREVIOUS_CHANNEL(_CHANNEL_)  (((_CHANNEL_) + ENCON_CHANNEL_COUNT - 1U) % ENCON_CHANNEL_COUNT)
+#define SPDEN_NEXT_CHANNEL(_CHANNEL_)      (((_CHANNEL_) + 1U) % ENCON_CHANNEL_COUNT)
 
-#define SPDEN_IGNITION_ANGLE_LOCK          (true)
+/* false -> injection starts at spden_intake_beggining_angles */
+/* true -> injection start is calculated backwards, so the injection ends at spden_injection_end_angles */
+#define SPDEN_INJECTION_END_ANGLE_MODE     (true)
+
+/* true -> spark is fixed at SPDEN_LOCKED_ANGLE for ignition timing check */
+#define SPDEN_IGNITION_ANGLE_LOCK          (false)
+/* Spark angle used in lock mode and during cranking */
 #define SPDEN_LOCKED_ANGLE                 (10.0F)
 
+/* MAP history holds one sample per injection event, size has to be a power of 2 */
+#define SPDEN_MAP_HISTORY_SIZE             (16U)
+#define SPDEN_MAP_HISTORY_MASK             (SPDEN_MAP_HISTORY_SIZE - 1U)
+
+/* Pressure change rate is calculated over one engine cycle */
+#define SPDEN_MAP_DERIVATIVE_SAMPLES       (ENCON_ENGINE_PISTONS_NO)
+
+/* Number of engine cycles over which acceleration enrichment decays to 0 */
+#define SPDEN_ACCEL_ENRICHMENT_DECAY_CYCLES (4U)
+
+/* Minimum engine cycles of the prime state, it lasts until every cylinder got the prime pulse */
+#define SPDEN_PRIME_CYCLES                  (1U)
+
+/* Cranking states use the fixed spark angle */
+#define SPDEN_IS_CRANKING_STATE(_STATE_)    ((SPDEN_ENGINE_STATE_PRIME == (_STATE_)) ||                      \
+                                             (SPDEN_ENGINE_STATE_CRANKING == (_STATE_)))
+/* States after the engine start, above ENCON_RUNNING_FLOOR_RPM */
+#define SPDEN_IS_RUNNING_STATE(_STATE_)     ((_STATE_) >= SPDEN_ENGINE_STATE_AFTER_START)
+
+#if (SPDEN_MAP_DERIVATIVE_SAMPLES >= SPDEN_MAP_HISTORY_SIZE)
+#error "MAP history is too short for the engine cycle"
+#endif
+
+#if ((SPDEN_LOAD_MODEL != SPDEN_LOAD_MODEL_SPEED_DENSITY) && !ENSENS_TPS_LAMBDA_SENSORS_ENABLED)
+#error "Alpha-N and blended load models need TPS sensor"
+#endif
+
 /*===========================================================================*
  *
  * LOCAL TYPES AND ENUMERATION SECTION
  *
  *===========================================================================*/
 
+/* Order matters, see SPDEN_IS_RUNNING_STATE */
 typedef enum SpDen_EngineState_Tag
 {
     SPDEN_ENGINE_STATE_NOT_RUNNING,
+    /* First cycle after the engine starts to rotate, prime pulse is injected */
+    SPDEN_ENGINE_STATE_PRIME,
     SPDEN_ENGINE_STATE_CRANKING,
+    /* After start enrichment decays over TABLES_2D_AFTER_START_CYCLES cycles */
+    SPDEN_ENGINE_STATE_AFTER_START,
+    /* CLT enrichment until the engine is warm */
+    SPDEN_ENGINE_STATE_WARM_UP,
     SPDEN_ENGINE_STATE_RUNING,
 
     SPDEN_ENGINE_STATE_COUNT
 } SpDen_EngineState_T;
 
+typedef struct SpDen_EngineStateData_Tag
+{
+    SpDen_EngineState_T state;
+    /* Engine cycles spent in the current state */
+    uint32_t stateCycles;
+    /* Engine angle of the previous speed signal pulse, used to detect the cycle beggining */
+    float previousAngle;
+    /* State fuel enrichment in %, calculated once per cycle */
+    float enrichment;
+    /* After start enrichment at the beggining of the state and its duration */
+    float afterStartEnrichment;
+    float afterStartCycles;
+    /* Effective open time added to the first injection of every cylinder */
+    float primePulseMs;
+    /* Bit set -> cylinder still waits for the prime pulse */
+    uint32_t primePendingMask;
+    /* After start enrichment already ran since the engine stop, stumble doesn't repeat it */
+    bool isAfterStartDone;
+} SpDen_EngineStateData_T;
+
 typedef enum SpDen_ChannelCheckEvent_Tag
 {
     SPDEN_CHANNEL_CHECK_EVENT_IGNITION,
@@ -86,51 +147,85 @@ typedef enum SpDen_ChannelCheckEvent_Tag
     SPDEN_CHANNEL_CHECK_EVENT_COUNT
 } SpDen_ChannelCheckEvent_T;
 
+typedef struct SpDen_MapSample_Tag
+{
+    /* Absolute pressure in kPa */
+    float pressure;
+    /* Core cycles counter value */
+    uint32_t timestamp;
+} SpDen_MapSample_T;
+
+typedef struct SpDen_AccelEnrichment_Tag
+{
+    SpDen_MapSample_T history[SPDEN_MAP_HISTORY_SIZE];
+    /* Index of the next sample to be written */
+    uint32_t index;
+    /* Number of valid samples, saturated at SPDEN_MAP_HISTORY_SIZE */
+    uint32_t samplesNo;
+    /* Current enrichment in % */
+    float enrichment;
+    /* Enrichment decrease per injection event in % */
+    float decayStep;
+} SpDen_AccelEnrichment_T;
+
 /*===========================================================================*
  *
  * GLOBAL VARIABLES AND CONSTANTS SECTION
  *
  *===========================================================================*/
 
-/* Use only in SPDEN_AIR_MASS macro */
-static const float spden_air_mass_helper = (SPDEN_CYLINDER_VOLUME * SPDEN_AIR_MOLAR_MASS) / SPDEN_GAS_CONSTANT;
-
-static volatile EnCon_CylinderChannels_T spden_pending_injection_event;
-static volatile EnCon_CylinderChannels_T spden_pending_ignition_event;
+/* All constant factors of the fuel equation folded together: VE percentage, air mass, AFR, fuel density */
+/* and injector flow. Multiplied by VE in %, pressure in kPa, IAT reciprocal and target lambda reciprocal */
+/* gives fuel pulse in ms */
+static const float spden_fuel_multiplier = ((SPDEN_AIR_MASS_MULTIPLIER * SPDEN_PERCENTAGE_MULTIPLIER) /
+                                            (SPDEN_STOICHIOMETRIC_AFR * SPDEN_FUEL_DENSITY *
+                                             SPDEN_INJECTOR_FLOW_RATE_CC_SEC)) * UTILS_CONVERT_TO_MILI_MULTIPL;
 
 static SpDen_EngineState_T spden_engine_state;
 
+static SpDen_EngineStateData_T spden_engine_state_data;
+
+static SpDen_AccelEnrichment_T spden_accel_enrichment;
+
+/* Per event calculation times, see UTILS_CYCLES_STATS_UPDATE */
+static Utils_CyclesStats_T spden_fuel_cycles;
+static Utils_CyclesStats_T spden_spark_cycles;
+
+/* Spark advance of slowly changing corrections, calculated once per engine cycle */
+static float spden_spark_advances[ENCON_CHANNEL_COUNT];
+static bool spden_spark_advances_valid;
+
+/* First piston MAP sample angle, other pistons are sampled every intake stroke */
+static const float spden_map_sample_angle = ENCON_ENGINE_INTAKE_ANGLE + ENCON_MAP_SAMPLE_OFFSET_ANGLE;
+
+/* All angles below are calculated at initialization for ENCON_ENGINE_PISTONS_NO pistons */
+
 /* Cylinders work TDC angle compared to the first piston TDC angle */
-static const float spden_work_tdc_angles[ENCON_ENGINE_PISTONS_NO] =
-{
-    ENCON_ENGINE_PISTON_1_OFFSET,
-    ENCON_ENGINE_PISTON_2_OFFSET,
-    ENCON_ENGINE_PISTON_3_OFFSET
-};
+static float spden_work_tdc_angles[ENCON_CHANNEL_COUNT];
 
 /* Cylinders intake beggining angle compared to the first piston TDC angle */
-static const float spden_intake_beggining_angles[ENCON_ENGINE_PISTONS_NO] =
-{
-    SPDEN_PISTON_1_INTAKE_ANGLE + ENCON_FUEL_DELIVERY_OFFSET_ANGLE,
-    SPDEN_PISTON_2_INTAKE_ANGLE + ENCON_FUEL_DELIVERY_OFFSET_ANGLE,
-    SPDEN_PISTON_3_INTAKE_ANGLE + ENCON_FUEL_DELIVERY_OFFSET_ANGLE
-};
+static float spden_intake_beggining_angles[ENCON_CHANNEL_COUNT];
+
+/* Cylinders injection end angle compared to the first piston TDC angle */
+static float spden_injection_end_angles[ENCON_CHANNEL_COUNT];
+
+/* MAP averaging window: intake stroke beggining and end, aligned to speed signal pulses */
+static float spden_map_window_start_angles[ENCON_CHANNEL_COUNT];
+static float spden_map_window_end_angles[ENCON_CHANNEL_COUNT];
+
+/* Knock sensor window after work TDC, aligned to speed signal pulses */
+static float spden_knock_window_start_angles[ENCON_CHANNEL_COUNT];
+static float spden_knock_window_end_angles[ENCON_CHANNEL_COUNT];
 
 /* Ignition event is calculated when previous piston work cycle ends */
-static const float spden_ignition_calc_angles[ENCON_ENGINE_PISTONS_NO] =
-{
-    ENCON_ENGINE_PISTON_3_OFFSET,
-    ENCON_ENGINE_PISTON_1_OFFSET,
-    ENCON_ENGINE_PISTON_2_OFFSET
-};
+static float spden_ignition_calc_angles[ENCON_CHANNEL_COUNT];
 
 /* Injection event is calculated when previous piston intake cycle ends */
-static const float spden_injection_calc_angles[ENCON_ENGINE_PISTONS_NO] =
-{
-    SPDEN_PISTON_3_INTAKE_END_ANGLE,
-    SPDEN_PISTON_1_INTAKE_END_ANGLE,
-    SPDEN_PISTON_2_INTAKE_END_ANGLE
-};
+static float spden_injection_calc_angles[ENCON_CHANNEL_COUNT];
+
+/* In end of injection mode, injection event is calculated when previous piston injection ends */
+/* It gives almost 720/ENCON_ENGINE_PISTONS_NO degrees of look-ahead for the injection start */
+static float spden_injection_end_calc_angles[ENCON_CHANNEL_COUNT];
 
 /*===========================================================================*
  *
@@ -138,15 +233,43 @@ static const float spden_injection_calc_angles[ENCON_ENGINE_PISTONS_NO] =
  *
  *===========================================================================*/
 
+/*===========================================================================*
+ * brief:       Align angle to the next speed signal pulse
+ * param[in]:   angle - engine angle in degrees
+ * param[out]:  None
+ * return:      float - first speed signal pulse angle not lower than given angle
+ * details:     Events are calculated at speed signal pulses, so calculation angles need to be aligned
+ *===========================================================================*/
+static float SpDen_AlignToTrigger(float angle);
+
 /*===========================================================================*
  * brief:       Check current engine state
  * param[in]:   None
  * param[out]:  None
  * return:      None
- * details:     This function sets global spden_engine_state variable
+ * details:     This function sets global spden_engine_state variable. Engine stop and start are
+ *              checked at every speed signal pulse, other transitions once per engine cycle
  *===========================================================================*/
 static void SpDen_CheckCurrentEngineState(void);
 
+/*===========================================================================*
+ * brief:       Change engine state
+ * param[in]:   state - new engine state
+ * param[out]:  None
+ * return:      None
+ * details:     Initializes state counters and per state corrections
+ *===========================================================================*/
+static void SpDen_EnterEngineState(SpDen_EngineState_T state);
+
+/*===========================================================================*
+ * brief:       Evaluate engine state transitions and state enrichment
+ * param[in]:   speed - engine speed in RPM
+ * param[out]:  None
+ * return:      None
+ * details:     Needs to be called once per engine cycle
+ *===========================================================================*/
+static void SpDen_OnEngineCycle(float speed);
+
 /*===========================================================================*
  * brief:       Finds if any of the cylinders needs to be prepared for given event
  * param[in]:   event - specifies which event need to be checked
@@ -157,26 +280,92 @@ static void SpDen_CheckCurrentEngineState(void);
  *===========================================================================*/
 static EnCon_CylinderChannels_T SpDen_GetPendingChannel(SpDen_ChannelCheckEvent_T event);
 
+/*===========================================================================*
+ * brief:       Mark MAP averaging window edges
+ * param[in]:   engineAngle - current engine angle
+ * param[out]:  None
+ * return:      None
+ * details:     Window covers intake stroke of every cylinder
+ *===========================================================================*/
+static void SpDen_UpdateMapWindow(float engineAngle);
+
+/*===========================================================================*
+ * brief:       Mark knock sensor window edges
+ * param[in]:   engineAngle - current engine angle
+ * param[out]:  None
+ * return:      None
+ * details:     Window covers beggining of the work stroke of every cylinder
+ *===========================================================================*/
+static void SpDen_UpdateKnockWindow(float engineAngle);
+
+/*===========================================================================*
+ * brief:       Update acceleration enrichment with the newest MAP sample
+ * param[in]:   speed - engine speed in RPM
+ * param[in]:   pressure - engine absolute pressure in kPa
+ * param[out]:  None
+ * return:      None
+ * details:     Needs to be called once per injection event. Pressure change rate is calculated
+ *              against the sample taken one engine cycle before. New enrichment peak is taken from
+ *              the table and decays linearly over SPDEN_ACCEL_ENRICHMENT_DECAY_CYCLES engine cycles
+ *===========================================================================*/
+static void SpDen_UpdateAccelEnrichment(float speed, float pressure);
+
 /*===========================================================================*
  * brief:       Calculate fuel injection duration
  * param[in]:   speed - engine speed in RPM
  * param[in]:   pressure - engine absolute pressure in kPa
+ * param[in]:   channel - current engine channel
  * param[out]:  None
- * return:      float - fuel duration pulse in ms
- * details:     None
+ * return:      float - effective injector open time in ms, without injector characterisation
+ * details:     Fuel is compensated for the intake port film, so the call updates the film state
  *===========================================================================*/
-static float SpDen_CalculateFuel(float speed, float pressure);
+static float SpDen_CalculateFuel(float speed, float pressure, EnCon_CylinderChannels_T channel);
 
 /*===========================================================================*
- * brief:       Calculate spark angle
+ * brief:       Calculate spark advance of all cylinders
  * param[in]:   speed - engine speed in RPM
  * param[in]:   pressure - engine absolute pressure in kPa
+ * param[out]:  None
+ * return:      None
+ * details:     Spark table, CLT, IAT and cylinder trim corrections are cached in spden_spark_advances.
+ *              Needs to be called once per engine cycle
+ *===========================================================================*/
+static void SpDen_UpdateSparkAdvances(float speed, float pressure);
+
+/*===========================================================================*
+ * brief:       Calculate spark angle
+ * param[in]:   speed - engine speed in RPM
  * param[in]:   channel - current engine channel
  * param[out]:  None
  * return:      float - spark fire angle
- * details:     None
+ * details:     Cached advance is corrected only by the fast changing idle, knock and limiter terms
+ *===========================================================================*/
+static float SpDen_CalculateSpark(float speed, EnCon_CylinderChannels_T channel);
+
+/*===========================================================================*
+ * brief:       Calculate coil dwell
+ * param[in]:   speed - engine speed in RPM
+ * param[out]:  None
+ * return:      float - dwell angle in degrees
+ * details:     Dwell time depends on battery voltage and is limited by the engine speed duty cap
+ *===========================================================================*/
+static float SpDen_CalculateDwell(float speed);
+
+/*===========================================================================*
+ * brief:       Split fuel injection into pulses
+ * param[in]:   speed - engine speed in RPM
+ * param[in]:   pressure - engine absolute pressure in kPa
+ * param[in]:   fuelMs - total effective injector open time in ms
+ * param[in]:   channel - current engine channel
+ * param[out]:  pulses - injection pulses, table of ENCON_INJECTION_PULSES_NO size
+ * return:      uint8_t - number of pulses to be injected
+ * details:     First pulse delivers split ratio part of the fuel, rest is equally divided between
+ *              next pulses. Every pulse goes through the injector model. In end of injection mode
+ *              pulses are placed backwards from the injection end angle. Injection which doesn't fit
+ *              before the next channel calculation angle is merged into one pulse limited to that angle
  *===========================================================================*/
-static float SpDen_CalculateSpark(float speed, float pressure, EnCon_CylinderChannels_T channel);
+static uint8_t SpDen_CalculateInjectionPulses(float speed, float pressure, float fuelMs,
+                                              EnCon_CylinderChannels_T channel, InjDrv_Pulse_T* pulses);
 
 /*===========================================================================*
  *
@@ -189,9 +378,54 @@ static float SpDen_CalculateSpark(float speed, float pressure, EnCon_CylinderCha
  *===========================================================================*/
 void SpDen_Init(void)
 {
-    spden_engine_state = SPDEN_ENGINE_STATE_NOT_RUNNING;
-    spden_pending_ignition_event = SPDEN_NO_PENDING_CHANNEL;
-    spden_pending_injection_event = SPDEN_NO_PENDING_CHANNEL;
+    EnCon_CylinderChannels_T channel;
+    float intakeAngle;
+
+    spden_engine_state_data.previousAngle = ENCON_ANGLE_UNKNOWN;
+    SpDen_EnterEngineState(SPDEN_ENGINE_STATE_NOT_RUNNING);
+    spden_spark_advances_valid = false;
+    spden_accel_enrichment.index = 0U;
+    spden_accel_enrichment.samplesNo = 0U;
+    spden_accel_enrichment.enrichment = 0.0F;
+    spden_accel_enrichment.decayStep = 0.0F;
+
+    for (channel = ENCON_CHANNEL_1; channel < ENCON_CHANNEL_COUNT; channel++)
+    {
+        intakeAngle = UTILS_CIRCULAR_ADDITION(ENCON_ENGINE_PISTON_OFFSET(channel), ENCON_ENGINE_INTAKE_ANGLE,
+                                              ENCON_ENGINE_FULL_CYCLE_ANGLE);
+
+        spden_work_tdc_angles[channel] = ENCON_ENGINE_PISTON_OFFSET(channel);
+        spden_intake_beggining_angles[channel] = UTILS_CIRCULAR_ADDITION(intakeAngle, ENCON_FUEL_DELIVERY_OFFSET_ANGLE,
+                                                                         ENCON_ENGINE_FULL_CYCLE_ANGLE);
+        spden_injection_end_angles[channel] = UTILS_CIRCULAR_ADDITION(intakeAngle,
+                                                                      ENCON_FUEL_DELIVERY_END_OFFSET_ANGLE,
+                                                                      ENCON_ENGINE_FULL_CYCLE_ANGLE);
+        spden_map_window_start_angles[channel] = SpDen_AlignToTrigger(intakeAngle);
+        spden_map_window_end_angles[channel] =
+            SpDen_AlignToTrigger(UTILS_CIRCULAR_ADDITION(ENCON_ENGINE_PISTON_OFFSET(channel),
+                                                         ENCON_ENGINE_COMPRESSION_ANGLE,
+                                                         ENCON_ENGINE_FULL_CYCLE_ANGLE));
+        spden_knock_window_start_angles[channel] =
+            SpDen_AlignToTrigger(UTILS_CIRCULAR_ADDITION(ENCON_ENGINE_PISTON_OFFSET(channel),
+                                                         ENCON_KNOCK_WINDOW_START_ANGLE,
+                                                         ENCON_ENGINE_FULL_CYCLE_ANGLE));
+        spden_knock_window_end_angles[channel] =
+            SpDen_AlignToTrigger(UTILS_CIRCULAR_ADDITION(ENCON_ENGINE_PISTON_OFFSET(channel),
+                                                         ENCON_KNOCK_WINDOW_END_ANGLE,
+                                                         ENCON_ENGINE_FULL_CYCLE_ANGLE));
+    }
+
+    for (channel = ENCON_CHANNEL_1; channel < ENCON_CHANNEL_COUNT; channel++)
+    {
+        spden_ignition_calc_angles[channel] =
+            SpDen_AlignToTrigger(spden_work_tdc_angles[SPDEN_PREVIOUS_CHANNEL(channel)]);
+        spden_injection_calc_angles[channel] =
+            SpDen_AlignToTrigger(UTILS_CIRCULAR_ADDITION(spden_work_tdc_angles[SPDEN_PREVIOUS_CHANNEL(channel)],
+                                                         ENCON_ENGINE_COMPRESSION_ANGLE,
+                                                         ENCON_ENGINE_FULL_CYCLE_ANGLE));
+        spden_injection_end_calc_angles[channel] =
+            SpDen_AlignToTrigger(spden_injection_end_angles[SPDEN_PREVIOUS_CHANNEL(channel)]);
+    }
 }
 
 /*===========================================================================*
@@ -205,35 +439,49 @@ void SpDen_OnTriggerInterrupt(void)
     float engineAngle;
     float fuelPulseMs;
     float sparkAngle;
-    bool isSensorsMeasureRequired;
-
-    isSensorsMeasureRequired = true;
+    float dwellAngle;
+    InjDrv_Pulse_T injectionPulses[ENCON_INJECTION_PULSES_NO];
+    uint8_t injectionPulsesNo;
+    uint32_t timestamp;
 
     SpDen_CheckCurrentEngineState();
 
+    EnSens_AlignMapSampling(EnCon_GetEngineAngle(), spden_map_sample_angle);
+    SpDen_UpdateMapWindow(EnCon_GetEngineAngle());
+    SpDen_UpdateKnockWindow(EnCon_GetEngineAngle());
+
     if (spden_engine_state != SPDEN_ENGINE_STATE_NOT_RUNNING)
     {
+        RevLim_Update(EnCon_GetEngineSpeed());
+
         /* Check for ignition event */
         channel = SpDen_GetPendingChannel(SPDEN_CHANNEL_CHECK_EVENT_IGNITION);
-        if (channel != SPDEN_NO_PENDING_CHANNEL)
+        if ((channel != SPDEN_NO_PENDING_CHANNEL) &&
+            ((ENCON_CHANNEL_1 == channel) || (false == spden_spark_advances_valid)))
         {
             engineSpeed = EnCon_GetEngineSpeed();
-            enginePressure = EnSens_GetMap();
-            sparkAngle = SpDen_CalculateSpark(engineSpeed, enginePressure, channel);
+            SpDen_UpdateSparkAdvances(engineSpeed, SpDen_GetEngineLoad(engineSpeed));
+        }
+
+        /* Cut event is not prepared, so the coil is not charged */
+        if ((channel != SPDEN_NO_PENDING_CHANNEL) && (false == RevLim_IsSparkCut()))
+        {
+            engineSpeed = EnCon_GetEngineSpeed();
+            timestamp = UTILS_GET_TIMESTAMP();
+            sparkAngle = SpDen_CalculateSpark(engineSpeed, channel);
+            UTILS_CYCLES_STATS_UPDATE(&spden_spark_cycles, timestamp);
+            dwellAngle = SpDen_CalculateDwell(engineSpeed);
 
             DisableIRQ();
 
             /* Get engine angle one more time in case interrupt occured meantime */
             engineAngle = EnCon_GetEngineAngle();
-            /* Event timers will be triggered after next interrupt */
+            /* Event timers will be started by hardware at the next speed signal pulse */
             engineAngle += ENCON_ONE_TRIGGER_PULSE_ANGLE;
 
-            IgnDrv_PrepareIgnitionChannel(channel, sparkAngle, engineAngle);
-            spden_pending_ignition_event = channel;
+            IgnDrv_PrepareIgnitionChannel(channel, sparkAngle, dwellAngle, engineAngle);
 
             EnableIRQ();
-
-            isSensorsMeasureRequired = false;
         }
 
         /* Check for injection event */
@@ -241,47 +489,88 @@ void SpDen_OnTriggerInterrupt(void)
         if (channel != SPDEN_NO_PENDING_CHANNEL)
         {
             engineSpeed = EnCon_GetEngineSpeed();
-            enginePressure = EnSens_GetMap();
-            fuelPulseMs = SpDen_CalculateFuel(engineSpeed, enginePressure);
-
-            DisableIRQ();
-
-            /* Get engine angle one more time in case interrupt occured meantime */
-            engineAngle = EnCon_GetEngineAngle();
-            /* Event timers will be triggered after next interrupt */
-            engineAngle += ENCON_ONE_TRIGGER_PULSE_ANGLE;
-
-            InjDrv_PrepareInjectionChannel(channel, spden_intake_beggining_angles[channel], engineAngle, fuelPulseMs);
-            spden_pending_injection_event = channel;
-
-            EnableIRQ();
-
-            isSensorsMeasureRequired = false;
+            enginePressure = SpDen_GetEngineLoad(engineSpeed);
+            /* Models run on every event, so history and film stay valid during the cut */
+            SpDen_UpdateAccelEnrichment(engineSpeed, enginePressure);
+
+            if (ENCON_CHANNEL_1 == channel)
+            {
+                /* Battery voltage, film parameters and cylinder trims change slowly, */
+                /* they are updated once per engine cycle */
+                InjMod_Update();
+                WallWet_Update(engineSpeed);
+                CylTrim_Update(engineSpeed, enginePressure);
+            }
+
+            if (false == RevLim_IsFuelCut())
+            {
+                timestamp = UTILS_GET_TIMESTAMP();
+                fuelPulseMs = SpDen_CalculateFuel(engineSpeed, enginePressure, channel);
+                UTILS_CYCLES_STATS_UPDATE(&spden_fuel_cycles, timestamp);
+                injectionPulsesNo = SpDen_CalculateInjectionPulses(engineSpeed, enginePressure, fuelPulseMs,
+                                                                   channel, injectionPulses);
+
+                DisableIRQ();
+
+                /* Get engine angle one more time in case interrupt occured meantime */
+                engineAngle = EnCon_GetEngineAngle();
+                /* Event timers will be started by hardware at the next speed signal pulse */
+                engineAngle += ENCON_ONE_TRIGGER_PULSE_ANGLE;
+
+                InjDrv_PrepareInjectionChannel(channel, injectionPulses, injectionPulsesNo, engineAngle);
+
+                EnableIRQ();
+            }
+            else
+            {
+                /* Cut event leaves the injector closed, the film only evaporates */
+                (void)WallWet_Compensate(channel, 0.0F);
+            }
         }
     }
-
-    if (isSensorsMeasureRequired)
+    else
     {
-        EnSens_StartMeasurement();
+        /* History is not valid after engine stop */
+        spden_accel_enrichment.samplesNo = 0U;
+        spden_accel_enrichment.enrichment = 0.0F;
+        spden_spark_advances_valid = false;
+        WallWet_Reset();
     }
 }
 
 /*===========================================================================*
- * Function: SpDen_TriggerCallback
+ * Function: SpDen_GetEngineLoad
  *===========================================================================*/
-void SpDen_TriggerCallback(void)
+float SpDen_GetEngineLoad(float speed)
 {
-    if (spden_pending_ignition_event != SPDEN_NO_PENDING_CHANNEL)
-    {
-        IgnDrv_StartIgnitionModule();
-        spden_pending_ignition_event = SPDEN_NO_PENDING_CHANNEL;
-    }
+#if (SPDEN_LOAD_MODEL == SPDEN_LOAD_MODEL_SPEED_DENSITY)
+    (void)speed;
+
+    return EnSens_GetMap();
+#elif (SPDEN_LOAD_MODEL == SPDEN_LOAD_MODEL_ALPHA_N)
+    return Tables_Get3DTableValue(TABLES_3D_ALPHA_N_LOAD, speed, EnSens_GetTps());
+#elif (SPDEN_LOAD_MODEL == SPDEN_LOAD_MODEL_BLENDED)
+    float throttle;
+    float alphaNShare;
+    float pressure;
+
+    throttle = EnSens_GetTps();
+    alphaNShare = Tables_Get3DTableValue(TABLES_3D_LOAD_BLEND, speed, throttle) * SPDEN_PERCENTAGE_MULTIPLIER;
+    pressure = EnSens_GetMap();
+
+    return pressure + (alphaNShare * (Tables_Get3DTableValue(TABLES_3D_ALPHA_N_LOAD, speed, throttle) - pressure));
+#else
+#error "Unknown SPDEN_LOAD_MODEL"
+#endif
+}
 
-    if (spden_pending_injection_event != SPDEN_NO_PENDING_CHANNEL)
-    {
-        InjDrv_StartInjectionModule();
-        spden_pending_injection_event = SPDEN_NO_PENDING_CHANNEL;
-    }
+/*===========================================================================*
+ * Function: SpDen_IsEnrichmentActive
+ *===========================================================================*/
+bool SpDen_IsEnrichmentActive(void)
+{
+    return (spden_engine_state != SPDEN_ENGINE_STATE_RUNING) || (0.0F != spden_engine_state_data.enrichment) ||
+           (0.0F != spden_accel_enrichment.enrichment);
 }
 
 /*===========================================================================*
@@ -290,30 +579,212 @@ void SpDen_TriggerCallback(void)
  *
  *===========================================================================*/
 
+/*===========================================================================*
+ * Function: SpDen_AlignToTrigger
+ *===========================================================================*/
+static float SpDen_AlignToTrigger(float angle)
+{
+    uint32_t pulses;
+    float alignedAngle;
+
+    pulses = (uint32_t)(angle / ENCON_ONE_TRIGGER_PULSE_ANGLE);
+    alignedAngle = (float)pulses * ENCON_ONE_TRIGGER_PULSE_ANGLE;
+
+    if (alignedAngle < angle)
+    {
+        alignedAngle += ENCON_ONE_TRIGGER_PULSE_ANGLE;
+    }
+
+    if (alignedAngle >= ENCON_ENGINE_FULL_CYCLE_ANGLE)
+    {
+        alignedAngle -= ENCON_ENGINE_FULL_CYCLE_ANGLE;
+    }
+
+    return alignedAngle;
+}
+
 /*===========================================================================*
  * Function: SpDen_CheckCurrentEngineState
  *===========================================================================*/
 static void SpDen_CheckCurrentEngineState(void)
 {
+    SpDen_EngineStateData_T* data;
     float engineSpeed;
+    float engineAngle;
+    bool isNewCycle;
 
+    data = &spden_engine_state_data;
     engineSpeed = EnCon_GetEngineSpeed();
+    engineAngle = EnCon_GetEngineAngle();
 
-    if (ENCON_SPEED_UNKNOWN == engineSpeed)
+    /* Angle wraps around at the beggining of every engine cycle */
+    isNewCycle = (ENCON_ANGLE_UNKNOWN != engineAngle) && (ENCON_ANGLE_UNKNOWN != data->previousAngle) &&
+                 (engineAngle < data->previousAngle);
+    data->previousAngle = engineAngle;
+
+    /* Stall can't wait for the cycle end */
+    if ((ENCON_SPEED_UNKNOWN == engineSpeed) || (engineSpeed <= ENCON_CRANKING_FLOOR_RPM))
     {
-        spden_engine_state = SPDEN_ENGINE_STATE_NOT_RUNNING;
+        if (SPDEN_ENGINE_STATE_NOT_RUNNING != data->state)
+        {
+            SpDen_EnterEngineState(SPDEN_ENGINE_STATE_NOT_RUNNING);
+        }
     }
-    else if (engineSpeed >= ENCON_RUNNING_FLOOR_RPM)
+    else if ((SPDEN_ENGINE_STATE_NOT_RUNNING == data->state) && (ENCON_ANGLE_UNKNOWN != engineAngle))
     {
-        spden_engine_state = SPDEN_ENGINE_STATE_RUNING;
+        /* Prime pulse has to be injected with the first injection events, they need known angle */
+        SpDen_EnterEngineState(SPDEN_ENGINE_STATE_PRIME);
+        SpDen_OnEngineCycle(engineSpeed);
     }
-    else if (engineSpeed > ENCON_CRANKING_FLOOR_RPM)
+    else if ((SPDEN_ENGINE_STATE_NOT_RUNNING != data->state) && isNewCycle)
     {
-        spden_engine_state = SPDEN_ENGINE_STATE_CRANKING;
+        data->stateCycles++;
+        SpDen_OnEngineCycle(engineSpeed);
     }
     else
     {
-        spden_engine_state = SPDEN_ENGINE_STATE_NOT_RUNNING;
+        /* Transitions are evaluated only at the cycle beggining */
+    }
+
+    spden_engine_state = data->state;
+}
+
+/*===========================================================================*
+ * Function: SpDen_EnterEngineState
+ *===========================================================================*/
+static void SpDen_EnterEngineState(SpDen_EngineState_T state)
+{
+    SpDen_EngineStateData_T* data;
+    float coolantTemp;
+
+    data = &spden_engine_state_data;
+    coolantTemp = UTILS_CONVERT_K_TO_C(EnSens_GetClt(ENSENS_CLT_RESULT_TYPE_TEMPERATURE));
+
+    data->state = state;
+    data->stateCycles = 0U;
+    data->enrichment = 0.0F;
+    data->primePendingMask = 0U;
+
+    switch (state)
+    {
+        case SPDEN_ENGINE_STATE_NOT_RUNNING:
+            /* Next start runs the whole sequence */
+            data->isAfterStartDone = false;
+            break;
+
+        case SPDEN_ENGINE_STATE_PRIME:
+            data->primePulseMs = Tables_Get2DTableValue(TABLES_2D_PRIME_PULSE, coolantTemp);
+            data->primePendingMask = (1UL << ENCON_CHANNEL_COUNT) - 1U;
+            break;
+
+        case SPDEN_ENGINE_STATE_AFTER_START:
+            data->afterStartEnrichment = Tables_Get2DTableValue(TABLES_2D_AFTER_START_ENRICHMENT, coolantTemp);
+            data->afterStartCycles = Tables_Get2DTableValue(TABLES_2D_AFTER_START_CYCLES, coolantTemp);
+            data->isAfterStartDone = true;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*===========================================================================*
+ * Function: SpDen_OnEngineCycle
+ *===========================================================================*/
+static void SpDen_OnEngineCycle(float speed)
+{
+    SpDen_EngineStateData_T* data;
+    float coolantTemp;
+    float warmUpEnrichment;
+    float remainingCycles;
+
+    data = &spden_engine_state_data;
+    coolantTemp = UTILS_CONVERT_K_TO_C(EnSens_GetClt(ENSENS_CLT_RESULT_TYPE_TEMPERATURE));
+    warmUpEnrichment = EnSens_GetClt(ENSENS_CLT_RESULT_TYPE_ENRICHEMENT);
+
+    switch (data->state)
+    {
+        case SPDEN_ENGINE_STATE_PRIME:
+            /* Cylinder without injection event in the first cycle still gets its prime pulse */
+            if ((data->stateCycles >= SPDEN_PRIME_CYCLES) && (0U == data->primePendingMask))
+            {
+                SpDen_EnterEngineState(SPDEN_ENGINE_STATE_CRANKING);
+            }
+            break;
+
+        case SPDEN_ENGINE_STATE_CRANKING:
+            if (speed < ENCON_RUNNING_FLOOR_RPM)
+            {
+                /* Still cranking */
+            }
+            else if (false == data->isAfterStartDone)
+            {
+                SpDen_EnterEngineState(SPDEN_ENGINE_STATE_AFTER_START);
+            }
+            else
+            {
+                /* Recovered from the stumble, running state is chosen as after the after start */
+                SpDen_EnterEngineState((warmUpEnrichment > 0.0F) ? SPDEN_ENGINE_STATE_WARM_UP :
+                                                                   SPDEN_ENGINE_STATE_RUNING);
+            }
+            break;
+
+        case SPDEN_ENGINE_STATE_AFTER_START:
+            if ((float)data->stateCycles >= data->afterStartCycles)
+            {
+                SpDen_EnterEngineState(SPDEN_ENGINE_STATE_WARM_UP);
+            }
+            break;
+
+        case SPDEN_ENGINE_STATE_WARM_UP:
+            if (warmUpEnrichment <= 0.0F)
+            {
+                SpDen_EnterEngineState(SPDEN_ENGINE_STATE_RUNING);
+            }
+            break;
+
+        case SPDEN_ENGINE_STATE_RUNING:
+            if (warmUpEnrichment > 0.0F)
+            {
+                SpDen_EnterEngineState(SPDEN_ENGINE_STATE_WARM_UP);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    /* Engine not able to keep the running speed goes back to cranking */
+    if (SPDEN_IS_RUNNING_STATE(data->state) && (speed < ENCON_RUNNING_FLOOR_RPM))
+    {
+        SpDen_EnterEngineState(SPDEN_ENGINE_STATE_CRANKING);
+    }
+
+    switch (data->state)
+    {
+        case SPDEN_ENGINE_STATE_PRIME:
+        case SPDEN_ENGINE_STATE_CRANKING:
+            data->enrichment = Tables_Get2DTableValue(TABLES_2D_CRANKING_ENRICHMENT, coolantTemp);
+            break;
+
+        case SPDEN_ENGINE_STATE_AFTER_START:
+            /* Linear decay, warm up enrichment is continued after the state ends */
+            remainingCycles = data->afterStartCycles - (float)data->stateCycles;
+            data->enrichment = warmUpEnrichment;
+
+            if ((remainingCycles > 0.0F) && (data->afterStartCycles > 0.0F))
+            {
+                data->enrichment += data->afterStartEnrichment * (remainingCycles / data->afterStartCycles);
+            }
+            break;
+
+        case SPDEN_ENGINE_STATE_WARM_UP:
+            data->enrichment = warmUpEnrichment;
+            break;
+
+        default:
+            data->enrichment = 0.0F;
+            break;
     }
 }
 
@@ -333,7 +804,14 @@ static EnCon_CylinderChannels_T SpDen_GetPendingChannel(SpDen_ChannelCheckEvent_
             break;
 
         case SPDEN_CHANNEL_CHECK_EVENT_INJECTION:
-            calcStartAngles = spden_injection_calc_angles;
+            if (SPDEN_INJECTION_END_ANGLE_MODE)
+            {
+                calcStartAngles = spden_injection_end_calc_angles;
+            }
+            else
+            {
+                calcStartAngles = spden_injection_calc_angles;
+            }
             break;
     
         default:
@@ -359,45 +837,346 @@ sp_den_get_pending_channel_exit:
     return channel;
 }
 
+/*===========================================================================*
+ * Function: SpDen_UpdateMapWindow
+ *===========================================================================*/
+static void SpDen_UpdateMapWindow(float engineAngle)
+{
+    EnCon_CylinderChannels_T channel;
+
+    if (ENCON_ANGLE_UNKNOWN == engineAngle)
+    {
+        EnSens_CancelMapWindow();
+        goto spden_update_map_window_exit;
+    }
+
+    for (channel = ENCON_CHANNEL_1; channel < ENCON_CHANNEL_COUNT; channel++)
+    {
+        /* End is checked first, as next intake stroke may start at the same angle */
+        if (spden_map_window_end_angles[channel] == engineAngle)
+        {
+            EnSens_EndMapWindow();
+        }
+    }
+
+    for (channel = ENCON_CHANNEL_1; channel < ENCON_CHANNEL_COUNT; channel++)
+    {
+        if (spden_map_window_start_angles[channel] == engineAngle)
+        {
+            EnSens_StartMapWindow();
+        }
+    }
+
+spden_update_map_window_exit:
+
+    return;
+}
+
+/*===========================================================================*
+ * Function: SpDen_UpdateKnockWindow
+ *===========================================================================*/
+static void SpDen_UpdateKnockWindow(float engineAngle)
+{
+    EnCon_CylinderChannels_T channel;
+
+    if (ENCON_ANGLE_UNKNOWN == engineAngle)
+    {
+        EnSens_CancelKnockWindow();
+        goto spden_update_knock_window_exit;
+    }
+
+    for (channel = ENCON_CHANNEL_1; channel < ENCON_CHANNEL_COUNT; channel++)
+    {
+        if (spden_knock_window_end_angles[channel] == engineAngle)
+        {
+            EnSens_EndKnockWindow();
+        }
+    }
+
+    for (channel = ENCON_CHANNEL_1; channel < ENCON_CHANNEL_COUNT; channel++)
+    {
+        if (spden_knock_window_start_angles[channel] == engineAngle)
+        {
+            EnSens_StartKnockWindow(channel);
+        }
+    }
+
+spden_update_knock_window_exit:
+
+    return;
+}
+
+/*===========================================================================*
+ * Function: SpDen_UpdateAccelEnrichment
+ *===========================================================================*/
+static void SpDen_UpdateAccelEnrichment(float speed, float pressure)
+{
+    SpDen_AccelEnrichment_T* accel;
+    SpDen_MapSample_T* oldSample;
+    uint32_t timestamp;
+    float timeMs;
+    float pressureRate;
+    float tableEnrichment;
+
+    accel = &spden_accel_enrichment;
+    timestamp = UTILS_GET_TIMESTAMP();
+
+    /* Linear decay of the previous enrichment */
+    if (accel->enrichment > accel->decayStep)
+    {
+        accel->enrichment -= accel->decayStep;
+    }
+    else
+    {
+        accel->enrichment = 0.0F;
+    }
+
+    accel->history[accel->index].pressure = pressure;
+    accel->history[accel->index].timestamp = timestamp;
+    accel->index = (accel->index + 1U) & SPDEN_MAP_HISTORY_MASK;
+
+    if (accel->samplesNo < SPDEN_MAP_HISTORY_SIZE)
+    {
+        accel->samplesNo++;
+    }
+
+    /* Cranking enrichment already covers unstable pressure, whole engine cycle of samples is needed */
+    if ((false == SPDEN_IS_RUNNING_STATE(spden_engine_state)) || (accel->samplesNo <= SPDEN_MAP_DERIVATIVE_SAMPLES))
+    {
+        goto spden_update_accel_enrichment_exit;
+    }
+
+    oldSample = &accel->history[(accel->index - 1U - SPDEN_MAP_DERIVATIVE_SAMPLES) & SPDEN_MAP_HISTORY_MASK];
+    /* Unsigned difference handles counter wrap around */
+    timeMs = UTILS_TIMESTAMP_TO_MS(timestamp - oldSample->timestamp);
+
+    if (timeMs <= 0.0F)
+    {
+        goto spden_update_accel_enrichment_exit;
+    }
+
+    /* kPa/s, only pressure increase is enriched */
+    pressureRate = ((pressure - oldSample->pressure) * UTILS_CONVERT_TO_MILI_MULTIPL) / timeMs;
+
+    if (pressureRate <= 0.0F)
+    {
+        goto spden_update_accel_enrichment_exit;
+    }
+
+    tableEnrichment = Tables_Get3DTableValue(TABLES_3D_ACCEL_ENRICHMENT, speed, pressureRate);
+
+    if (tableEnrichment > accel->enrichment)
+    {
+        accel->enrichment = tableEnrichment;
+        accel->decayStep = tableEnrichment /
+                           (float)(SPDEN_ACCEL_ENRICHMENT_DECAY_CYCLES * ENCON_ENGINE_PISTONS_NO);
+    }
+
+spden_update_accel_enrichment_exit:
+
+    return;
+}
+
 /*===========================================================================*
  * Function: SpDen_CalculateFuel
  *===========================================================================*/
-static float SpDen_CalculateFuel(float speed, float pressure)
+static float SpDen_CalculateFuel(float speed, float pressure, EnCon_CylinderChannels_T channel)
 {
-    float correctionMultiplier;
+    Tables_3DCell_T cell;
+    float enrichment;
+    float fuelMs;
+
+    /* Enrichments are summed in %, converted once */
+    enrichment = spden_engine_state_data.enrichment + spden_accel_enrichment.enrichment;
+
+    /* VE, target lambda and long term trim maps share axes, so the cell is searched once */
+    Tables_Get3DTableCell(TABLES_3D_VE, speed, pressure, &cell);
 
-    correctionMultiplier = 1.0F;
+    fuelMs = Tables_Get3DCellValue(TABLES_3D_VE, &cell) * pressure * EnSens_GetIatReciprocal() *
+             spden_fuel_multiplier * Tables_Get3DCellValue(TABLES_3D_TARGET_LAMBDA_RECIPROCAL, &cell) *
+             (1.0F + (enrichment * SPDEN_PERCENTAGE_MULTIPLIER)) * FuelTrim_GetMultiplier(&cell) *
+             CylTrim_GetFuelMultiplier(channel);
 
-    if (SPDEN_ENGINE_STATE_CRANKING == spden_engine_state)
+    fuelMs = WallWet_Compensate(channel, fuelMs);
+
+    /* Prime pulse wets the dry intake port, it is not a part of the film model */
+    if (0U != (spden_engine_state_data.primePendingMask & (1UL << channel)))
     {
-        correctionMultiplier += ENCON_CRANKING_ENRICHMENT;
+        spden_engine_state_data.primePendingMask &= ~(1UL << channel);
+        fuelMs += spden_engine_state_data.primePulseMs;
     }
 
-    correctionMultiplier += EnSens_GetClt(ENSENS_CLT_RESULT_TYPE_ENRICHEMENT);
+    return fuelMs;
+}
+
+/*===========================================================================*
+ * Function: SpDen_UpdateSparkAdvances
+ *===========================================================================*/
+static void SpDen_UpdateSparkAdvances(float speed, float pressure)
+{
+    EnCon_CylinderChannels_T channel;
+    float advanceAngle;
+
+    advanceAngle = Tables_Get3DTableValue(TABLES_3D_SPARK, speed, pressure) +
+                   Tables_Get2DTableValue(TABLES_2D_SPARK_CLT_CORRECTION,
+                                          UTILS_CONVERT_K_TO_C(EnSens_GetClt(ENSENS_CLT_RESULT_TYPE_TEMPERATURE))) +
+                   Tables_Get2DTableValue(TABLES_2D_SPARK_IAT_CORRECTION, UTILS_CONVERT_K_TO_C(EnSens_GetIat()));
+
+    for (channel = ENCON_CHANNEL_1; channel < ENCON_CHANNEL_COUNT; channel++)
+    {
+        spden_spark_advances[channel] = advanceAngle + CylTrim_GetSparkAdvance(channel);
+    }
 
-    return ((((Tables_Get3DTableValue(TABLES_3D_VE, speed, pressure) / (float)UTILS_PERCENTAGE_CONVERTER) *
-              (SPDEN_AIR_MASS(EnSens_GetMap(), EnSens_GetIat()) / SPDEN_TARGET_AFR)) /
-              (SPDEN_FUEL_DENSITY * SPDEN_INJECTOR_FLOW_RATE_CC_SEC)) * 1000.0F + ENCON_INJECTOR_DEAD_TIME_MS) *
-              correctionMultiplier;
+    spden_spark_advances_valid = true;
 }
 
 /*===========================================================================*
  * Function: SpDen_CalculateSpark
  *===========================================================================*/
-static float SpDen_CalculateSpark(float speed, float pressure, EnCon_CylinderChannels_T channel)
+static float SpDen_CalculateSpark(float speed, EnCon_CylinderChannels_T channel)
 {
-    float tableAngle;
+    float advanceAngle;
 
-    if (SPDEN_IGNITION_ANGLE_LOCK)
+    if (SPDEN_IGNITION_ANGLE_LOCK || SPDEN_IS_CRANKING_STATE(spden_engine_state))
     {
-        tableAngle = SPDEN_LOCKED_ANGLE;
+        advanceAngle = SPDEN_LOCKED_ANGLE;
     }
     else
     {
-        tableAngle = Tables_Get3DTableValue(TABLES_3D_SPARK, speed, pressure);
+        advanceAngle = spden_spark_advances[channel] + Idle_GetSparkCorrection(speed) - Knock_GetRetard(channel) -
+                       RevLim_GetRetard();
+    }
+
+    return UTILS_CIRCULAR_DIFFERENCE(spden_work_tdc_angles[channel], advanceAngle, ENCON_ENGINE_FULL_CYCLE_ANGLE);
+}
+
+/*===========================================================================*
+ * Function: SpDen_CalculateDwell
+ *===========================================================================*/
+static float SpDen_CalculateDwell(float speed)
+{
+    float dwellAngle;
+    float maxDwellAngle;
+
+    dwellAngle = EnCon_ConvertTimeToAngle(Tables_Get2DTableValue(TABLES_2D_DWELL, EnSens_GetBatteryVoltage()));
+    /* Duty is related to the angle between consecutive sparks, as all coils share one timer */
+    maxDwellAngle = (Tables_Get2DTableValue(TABLES_2D_DWELL_DUTY_LIMIT, speed) * SPDEN_PERCENTAGE_MULTIPLIER) *
+                    (ENCON_ENGINE_FULL_CYCLE_ANGLE / (float)ENCON_ENGINE_PISTONS_NO);
+
+    if (dwellAngle > maxDwellAngle)
+    {
+        dwellAngle = maxDwellAngle;
+    }
+
+    return dwellAngle;
+}
+
+/*===========================================================================*
+ * Function: SpDen_CalculateInjectionPulses
+ *===========================================================================*/
+static uint8_t SpDen_CalculateInjectionPulses(float speed, float pressure, float fuelMs,
+                                              EnCon_CylinderChannels_T channel, InjDrv_Pulse_T* pulses)
+{
+    float splitRatio;
+    float splitAngle;
+    float firstPulseAngle;
+    float injectionAngle;
+    float lookAheadAngle;
+    float earliestAngle;
+    float availableAngle;
+    float anglePerMs;
+    float maxOpenTimeMs;
+    const float* calcAngles;
+    uint8_t pulse;
+    uint8_t pulsesNo;
+
+    splitRatio = Tables_Get3DTableValue(TABLES_3D_INJECTION_SPLIT_RATIO, speed, pressure) *
+                 SPDEN_PERCENTAGE_MULTIPLIER;
+    splitAngle = 0.0F;
+
+    if ((splitRatio >= 1.0F) || (ENCON_INJECTION_PULSES_NO < 2U))
+    {
+        pulses[0].openTimeMs = InjMod_GetPulseWidth(fuelMs);
+        pulsesNo = 1U;
+    }
+    else
+    {
+        splitAngle = Tables_Get3DTableValue(TABLES_3D_INJECTION_SPLIT_ANGLE, speed, pressure);
+        /* Only effective open time is split, dead time and short pulse correction apply to every pulse */
+        pulses[0].openTimeMs = InjMod_GetPulseWidth(fuelMs * splitRatio);
+
+        for (pulse = 1U; pulse < ENCON_INJECTION_PULSES_NO; pulse++)
+        {
+            pulses[pulse].openTimeMs =
+                InjMod_GetPulseWidth((fuelMs * (1.0F - splitRatio)) / (float)(ENCON_INJECTION_PULSES_NO - 1U));
+        }
+
+        pulsesNo = ENCON_INJECTION_PULSES_NO;
+    }
+
+    /* Angle from the first pulse beggining to the last pulse end */
+    injectionAngle = ((float)(pulsesNo - 1U) * splitAngle) +
+                     EnCon_ConvertTimeToAngle(pulses[pulsesNo - 1U].openTimeMs);
+
+    if (SPDEN_INJECTION_END_ANGLE_MODE)
+    {
+        calcAngles = spden_injection_end_calc_angles;
+        /* Injection timer is started at the speed signal pulse following the calculation angle */
+        earliestAngle = UTILS_CIRCULAR_ADDITION(spden_injection_end_calc_angles[channel],
+                                                ENCON_ONE_TRIGGER_PULSE_ANGLE, ENCON_ENGINE_FULL_CYCLE_ANGLE);
+        lookAheadAngle = UTILS_CIRCULAR_DIFFERENCE(spden_injection_end_angles[channel], earliestAngle,
+                                                   ENCON_ENGINE_FULL_CYCLE_ANGLE);
+
+        if (injectionAngle < lookAheadAngle)
+        {
+            firstPulseAngle = UTILS_CIRCULAR_DIFFERENCE(spden_injection_end_angles[channel], injectionAngle,
+                                                        ENCON_ENGINE_FULL_CYCLE_ANGLE);
+        }
+        else if (ENCON_ANGLE_UNKNOWN == injectionAngle)
+        {
+            /* Pulse can't be placed backwards without engine speed, use start of injection timing */
+            firstPulseAngle = spden_intake_beggining_angles[channel];
+        }
+        else
+        {
+            /* Not enough time to finish injection at the target angle, start as soon as possible */
+            firstPulseAngle = earliestAngle;
+        }
+    }
+    else
+    {
+        calcAngles = spden_injection_calc_angles;
+        firstPulseAngle = spden_intake_beggining_angles[channel];
+    }
+
+    /* Injection timer is shared, next channel preparation at its calculation angle ends a running pulse */
+    availableAngle = UTILS_CIRCULAR_DIFFERENCE(calcAngles[SPDEN_NEXT_CHANNEL(channel)], firstPulseAngle,
+                                               ENCON_ENGINE_FULL_CYCLE_ANGLE);
+    anglePerMs = EnCon_ConvertTimeToAngle(1.0F);
+
+    if ((injectionAngle > availableAngle) && (ENCON_ANGLE_UNKNOWN != anglePerMs))
+    {
+        /* Single pulse saves dead time of the others, it's shortened to end before the next channel */
+        /* preparation, so the delivered fuel is known instead of being truncated at a random point */
+        pulses[0].openTimeMs = InjMod_GetPulseWidth(fuelMs);
+        maxOpenTimeMs = availableAngle / anglePerMs;
+        pulsesNo = 1U;
+
+        if (pulses[0].openTimeMs > maxOpenTimeMs)
+        {
+            pulses[0].openTimeMs = maxOpenTimeMs;
+        }
+    }
+
+    pulses[0].injAngle = firstPulseAngle;
+
+    for (pulse = 1U; pulse < pulsesNo; pulse++)
+    {
+        pulses[pulse].injAngle = UTILS_CIRCULAR_ADDITION(pulses[pulse - 1U].injAngle, splitAngle,
+                                                         ENCON_ENGINE_FULL_CYCLE_ANGLE);
     }
 
-    return UTILS_CIRCULAR_DIFFERENCE(spden_work_tdc_angles[channel], tableAngle, ENCON_ENGINE_FULL_CYCLE_ANGLE);
+    return pulsesNo;
 }
 
 
@@ -14,20 +14,21 @@
 
 #include "tables.h"
 
+#include "engine_constants.h"
+
 /*===========================================================================*
  *
  * DEFINES AND MACRO SECTION
  *
  *===========================================================================*/
 
-#define TABLES_3D_ROWS                                  (16u)
-#define TABLES_3D_COLUMNS                               (16u)
 
 #define TABLES_2D_X_VALUES                              (16u)
 #define TABLES_2D_Y_VALUES                              (16u)
 
 #define TABLES_3D_LAST_INDEX                            (TABLES_3D_COLUMNS - 1U)
 #define TABLES_2D_LAST_INDEX                            (TABLES_2D_X_VALUES - 1U)
+#define TABLES_TRIM_LAST_INDEX                          (TABLES_TRIM_COLUMNS - 1U)
 #define TABLES_FIRST_INDEX                              (0U)
 
 /*===========================================================================*
@@ -51,10 +52,20 @@ typedef struct Tables_2dTable_Tag
 
 } Tables_2dTable_T;
 
+typedef struct Tables_TrimTable_Tag
+{
+    /* Tables of cylinders not defined are zeroed, so they have no trim */
+    const float zTable[ENCON_CHANNELS_MAX][TABLES_TRIM_ROWS][TABLES_TRIM_COLUMNS];
+    const float xTable[TABLES_TRIM_COLUMNS];
+    const float yTable[TABLES_TRIM_ROWS];
+
+} Tables_TrimTable_T;
+
 typedef enum Tables_Types_Tag
 {
     TABLES_TYPES_2D,
     TABLES_TYPES_3D,
+    TABLES_TYPES_TRIM,
 
     TABLES_TYPES_COUNT
 } Tables_Types_T;
@@ -101,6 +112,116 @@ static const Tables_3dTable_T tables_ve =
     }
 };
 
+/* Axes have to be the same as in tables_ve, both tables are interpolated with one cell lookup */
+static const Tables_3dTable_T tables_target_lambda_reciprocal =
+{
+    /* Speed [RPM] */
+    .xTable =
+    {
+        600.0F, 1100.0F, 1500.0F, 1900.0F, 2400.0F, 2800.0F, 3200.0F, 3600.0F, 4100.0F, 4500.0F, 4900.0F, 5300.0F,
+        5700.0F, 6200.0F, 6600.0F, 7000.0F
+    },
+    /* Absolute pressure [kPa] */
+    .yTable =
+    {
+        25.0F, 30.0F, 36.0F, 40.0F, 46.0F, 50.0F, 56.0F, 60.0F, 66.0F, 70.0F, 76.0F, 80.0F, 86.0F, 92.0F, 96.0F, 101.0F
+    },
+    /* This table is written as it's natural for humans, point 0.0 is in the bottom left corner of the table */
+    /* Fuel multiplier 1 / target lambda, so fuel calculation doesn't divide: 1.163 -> lambda 0.86, 1.111 -> 0.90, */
+    /* 1.064 -> 0.94, 1.053 -> 0.95, 1.000 -> stoichiometric mixture, 0.952 -> 1.05 */
+    .zTable =
+    {
+        { 1.111F, 1.111F, 1.111F, 1.111F, 1.111F, 1.111F, 1.111F, 1.163F, 1.163F, 1.163F, 1.163F, 1.163F, 1.163F, 1.163F, 1.163F, 1.163F },
+        { 1.111F, 1.111F, 1.111F, 1.111F, 1.111F, 1.111F, 1.111F, 1.163F, 1.163F, 1.163F, 1.163F, 1.163F, 1.163F, 1.163F, 1.163F, 1.163F },
+        { 1.111F, 1.111F, 1.111F, 1.111F, 1.111F, 1.111F, 1.111F, 1.163F, 1.163F, 1.163F, 1.163F, 1.163F, 1.163F, 1.163F, 1.163F, 1.163F },
+        { 1.064F, 1.064F, 1.064F, 1.064F, 1.064F, 1.064F, 1.064F, 1.111F, 1.111F, 1.111F, 1.111F, 1.111F, 1.111F, 1.111F, 1.111F, 1.111F },
+        { 1.053F, 1.053F, 1.053F, 1.053F, 1.053F, 1.053F, 1.053F, 1.053F, 1.053F, 1.053F, 1.053F, 1.053F, 1.053F, 1.053F, 1.053F, 1.053F },
+        { 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F },
+        { 1.000F, 1.000F, 1.000F, 0.952F, 0.952F, 0.952F, 0.952F, 0.952F, 0.952F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F },
+        { 1.000F, 1.000F, 1.000F, 0.952F, 0.952F, 0.952F, 0.952F, 0.952F, 0.952F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F },
+        { 1.000F, 1.000F, 1.000F, 0.952F, 0.952F, 0.952F, 0.952F, 0.952F, 0.952F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F },
+        { 1.000F, 1.000F, 1.000F, 0.952F, 0.952F, 0.952F, 0.952F, 0.952F, 0.952F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F },
+        { 1.000F, 1.000F, 1.000F, 0.952F, 0.952F, 0.952F, 0.952F, 0.952F, 0.952F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F },
+        { 1.000F, 1.000F, 1.000F, 0.952F, 0.952F, 0.952F, 0.952F, 0.952F, 0.952F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F },
+        { 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F },
+        { 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F },
+        { 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F },
+        { 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F, 1.000F }
+    }
+};
+
+static const Tables_3dTable_T tables_alpha_n_load =
+{
+    /* Speed [RPM] */
+    .xTable =
+    {
+        600.0F, 1100.0F, 1500.0F, 1900.0F, 2400.0F, 2800.0F, 3200.0F, 3600.0F, 4100.0F, 4500.0F, 4900.0F, 5300.0F,
+        5700.0F, 6200.0F, 6600.0F, 7000.0F
+    },
+    /* Throttle position [%] */
+    .yTable =
+    {
+        0.0F, 2.0F, 4.0F, 6.0F, 8.0F, 10.0F, 13.0F, 16.0F, 20.0F, 25.0F, 30.0F, 40.0F, 50.0F, 65.0F, 80.0F, 100.0F
+    },
+    /* This table is written as it's natural for humans, point 0.0 is in the bottom left corner of the table */
+    /* Absolute pressure equivalent of the cylinder filling [kPa] */
+    .zTable =
+    {
+        { 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 100.0F },
+        { 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 100.0F, 100.0F, 100.0F, 99.0F, 99.0F, 99.0F, 98.0F },
+        { 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 101.0F, 100.0F, 100.0F, 99.0F, 99.0F, 98.0F, 98.0F, 97.0F, 96.0F, 96.0F, 95.0F },
+        { 101.0F, 101.0F, 101.0F, 101.0F, 100.0F, 100.0F, 99.0F, 99.0F, 98.0F, 97.0F, 96.0F, 95.0F, 94.0F, 93.0F, 92.0F, 91.0F },
+        { 101.0F, 101.0F, 100.0F, 100.0F, 99.0F, 98.0F, 97.0F, 95.0F, 94.0F, 92.0F, 91.0F, 90.0F, 88.0F, 87.0F, 85.0F, 84.0F },
+        { 101.0F, 100.0F, 100.0F, 99.0F, 97.0F, 96.0F, 94.0F, 92.0F, 90.0F, 89.0F, 87.0F, 85.0F, 84.0F, 82.0F, 81.0F, 79.0F },
+        { 100.0F, 99.0F, 98.0F, 96.0F, 94.0F, 92.0F, 90.0F, 88.0F, 85.0F, 83.0F, 81.0F, 80.0F, 78.0F, 76.0F, 74.0F, 73.0F },
+        { 100.0F, 97.0F, 95.0F, 93.0F, 89.0F, 87.0F, 84.0F, 82.0F, 79.0F, 77.0F, 75.0F, 73.0F, 72.0F, 70.0F, 68.0F, 67.0F },
+        { 98.0F, 95.0F, 92.0F, 88.0F, 85.0F, 82.0F, 79.0F, 76.0F, 74.0F, 71.0F, 70.0F, 68.0F, 66.0F, 64.0F, 63.0F, 61.0F },
+        { 95.0F, 90.0F, 86.0F, 82.0F, 78.0F, 74.0F, 72.0F, 69.0F, 66.0F, 64.0F, 62.0F, 61.0F, 59.0F, 57.0F, 56.0F, 55.0F },
+        { 91.0F, 84.0F, 80.0F, 76.0F, 71.0F, 68.0F, 66.0F, 63.0F, 60.0F, 59.0F, 57.0F, 55.0F, 54.0F, 52.0F, 51.0F, 50.0F },
+        { 84.0F, 77.0F, 72.0F, 68.0F, 63.0F, 61.0F, 58.0F, 56.0F, 54.0F, 52.0F, 50.0F, 49.0F, 48.0F, 47.0F, 46.0F, 45.0F },
+        { 73.0F, 66.0F, 61.0F, 57.0F, 54.0F, 51.0F, 49.0F, 47.0F, 45.0F, 44.0F, 43.0F, 42.0F, 41.0F, 40.0F, 39.0F, 39.0F },
+        { 55.0F, 49.0F, 46.0F, 43.0F, 41.0F, 39.0F, 38.0F, 37.0F, 36.0F, 35.0F, 35.0F, 34.0F, 34.0F, 33.0F, 33.0F, 32.0F },
+        { 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F }
+    }
+};
+
+static const Tables_3dTable_T tables_load_blend =
+{
+    /* Speed [RPM] */
+    .xTable =
+    {
+        600.0F, 1100.0F, 1500.0F, 1900.0F, 2400.0F, 2800.0F, 3200.0F, 3600.0F, 4100.0F, 4500.0F, 4900.0F, 5300.0F,
+        5700.0F, 6200.0F, 6600.0F, 7000.0F
+    },
+    /* Throttle position [%] */
+    .yTable =
+    {
+        0.0F, 2.0F, 4.0F, 6.0F, 8.0F, 10.0F, 13.0F, 16.0F, 20.0F, 25.0F, 30.0F, 40.0F, 50.0F, 65.0F, 80.0F, 100.0F
+    },
+    /* This table is written as it's natural for humans, point 0.0 is in the bottom left corner of the table */
+    /* Alpha-N load share in the blended load [%], rest is taken from MAP */
+    .zTable =
+    {
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 85.0F, 85.0F, 85.0F, 85.0F, 85.0F, 85.0F, 85.0F, 85.0F, 85.0F, 85.0F, 85.0F, 85.0F, 85.0F, 85.0F, 85.0F, 85.0F },
+        { 65.0F, 65.0F, 65.0F, 65.0F, 65.0F, 65.0F, 65.0F, 65.0F, 65.0F, 65.0F, 65.0F, 65.0F, 65.0F, 65.0F, 65.0F, 65.0F },
+        { 50.0F, 50.0F, 50.0F, 50.0F, 50.0F, 50.0F, 50.0F, 50.0F, 50.0F, 50.0F, 50.0F, 50.0F, 50.0F, 50.0F, 50.0F, 50.0F },
+        { 35.0F, 35.0F, 35.0F, 35.0F, 35.0F, 35.0F, 35.0F, 35.0F, 35.0F, 35.0F, 35.0F, 35.0F, 35.0F, 35.0F, 35.0F, 35.0F },
+        { 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F, 25.0F },
+        { 15.0F, 15.0F, 15.0F, 15.0F, 15.0F, 15.0F, 15.0F, 15.0F, 15.0F, 15.0F, 15.0F, 15.0F, 15.0F, 15.0F, 15.0F, 15.0F },
+        { 10.0F, 10.0F, 10.0F, 10.0F, 10.0F, 10.0F, 10.0F, 10.0F, 10.0F, 10.0F, 10.0F, 10.0F, 10.0F, 10.0F, 10.0F, 10.0F },
+        { 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F },
+        { 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F },
+        { 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F }
+    }
+};
+
 static const Tables_3dTable_T tables_spark =
 {
     /* Speed [RPM] */
@@ -137,6 +258,189 @@ static const Tables_3dTable_T tables_spark =
     }
 };
 
+static const Tables_3dTable_T tables_injection_split_ratio =
+{
+    /* Speed [RPM] */
+    .xTable =
+    {
+        600.0F, 1100.0F, 1500.0F, 1900.0F, 2400.0F, 2800.0F, 3200.0F, 3600.0F, 4100.0F, 4500.0F, 4900.0F, 5300.0F,
+        5700.0F, 6200.0F, 6600.0F, 7000.0F
+    },
+    /* Absolute pressure [kPa] */
+    .yTable =
+    {
+        25.0F, 30.0F, 36.0F, 40.0F, 46.0F, 50.0F, 56.0F, 60.0F, 66.0F, 70.0F, 76.0F, 80.0F, 86.0F, 92.0F, 96.0F, 101.0F
+    },
+    /* This table is written as it's natural for humans, point 0.0 is in the bottom left corner of the table */
+    /* Fuel mass injected by the first pulse in %, 100% means single pulse */
+    .zTable =
+    {
+        { 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 80.0F, 80.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 80.0F, 80.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 80.0F, 80.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 80.0F, 80.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F },
+        { 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F, 100.0F }
+    }
+};
+
+static const Tables_3dTable_T tables_injection_split_angle =
+{
+    /* Speed [RPM] */
+    .xTable =
+    {
+        600.0F, 1100.0F, 1500.0F, 1900.0F, 2400.0F, 2800.0F, 3200.0F, 3600.0F, 4100.0F, 4500.0F, 4900.0F, 5300.0F,
+        5700.0F, 6200.0F, 6600.0F, 7000.0F
+    },
+    /* Absolute pressure [kPa] */
+    .yTable =
+    {
+        25.0F, 30.0F, 36.0F, 40.0F, 46.0F, 50.0F, 56.0F, 60.0F, 66.0F, 70.0F, 76.0F, 80.0F, 86.0F, 92.0F, 96.0F, 101.0F
+    },
+    /* This table is written as it's natural for humans, point 0.0 is in the bottom left corner of the table */
+    /* Angle between consecutive injection pulses beginnings in degrees */
+    .zTable =
+    {
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F },
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F },
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F },
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F },
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F },
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F },
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F },
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F },
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F },
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F },
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F },
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F },
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F },
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F },
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F },
+        { 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F, 90.0F }
+    }
+};
+
+static const Tables_3dTable_T tables_accel_enrichment =
+{
+    /* Speed [RPM] */
+    .xTable =
+    {
+        600.0F, 1100.0F, 1500.0F, 1900.0F, 2400.0F, 2800.0F, 3200.0F, 3600.0F, 4100.0F, 4500.0F, 4900.0F, 5300.0F,
+        5700.0F, 6200.0F, 6600.0F, 7000.0F
+    },
+    /* Absolute pressure change rate [kPa/s] */
+    .yTable =
+    {
+        0.0F, 25.0F, 50.0F, 75.0F, 100.0F, 150.0F, 200.0F, 300.0F, 400.0F, 500.0F, 600.0F, 800.0F, 1000.0F, 1250.0F,
+        1500.0F, 2000.0F
+    },
+    /* This table is written as it's natural for humans, point 0.0 is in the bottom left corner of the table */
+    /* Fuel enrichment in %, decays over the next engine cycles */
+    .zTable =
+    {
+        { 60.0F, 57.0F, 55.0F, 53.0F, 50.0F, 48.0F, 45.0F, 43.0F, 40.0F, 38.0F, 36.0F, 34.0F, 31.0F, 28.0F, 26.0F, 24.0F },
+        { 60.0F, 57.0F, 55.0F, 53.0F, 50.0F, 48.0F, 45.0F, 43.0F, 40.0F, 38.0F, 36.0F, 34.0F, 31.0F, 28.0F, 26.0F, 24.0F },
+        { 60.0F, 57.0F, 55.0F, 53.0F, 50.0F, 48.0F, 45.0F, 43.0F, 40.0F, 38.0F, 36.0F, 34.0F, 31.0F, 28.0F, 26.0F, 24.0F },
+        { 49.0F, 46.0F, 45.0F, 43.0F, 41.0F, 39.0F, 37.0F, 35.0F, 33.0F, 31.0F, 29.0F, 27.0F, 25.0F, 23.0F, 21.0F, 20.0F },
+        { 39.0F, 37.0F, 35.0F, 34.0F, 32.0F, 31.0F, 29.0F, 28.0F, 26.0F, 25.0F, 23.0F, 22.0F, 20.0F, 18.0F, 17.0F, 16.0F },
+        { 29.0F, 27.0F, 26.0F, 25.0F, 24.0F, 23.0F, 22.0F, 21.0F, 19.0F, 18.0F, 17.0F, 16.0F, 15.0F, 14.0F, 13.0F, 12.0F },
+        { 24.0F, 23.0F, 22.0F, 21.0F, 20.0F, 19.0F, 18.0F, 17.0F, 16.0F, 15.0F, 14.0F, 13.0F, 12.0F, 11.0F, 10.0F, 10.0F },
+        { 19.0F, 18.0F, 17.0F, 16.0F, 16.0F, 15.0F, 14.0F, 13.0F, 13.0F, 12.0F, 11.0F, 10.0F, 10.0F, 9.0F, 8.0F, 8.0F },
+        { 14.0F, 13.0F, 13.0F, 12.0F, 11.0F, 11.0F, 10.0F, 10.0F, 9.0F, 9.0F, 8.0F, 8.0F, 7.0F, 7.0F, 6.0F, 6.0F },
+        { 9.0F, 8.0F, 8.0F, 8.0F, 7.0F, 7.0F, 7.0F, 6.0F, 6.0F, 6.0F, 5.0F, 5.0F, 5.0F, 4.0F, 4.0F, 4.0F },
+        { 6.0F, 6.0F, 6.0F, 5.0F, 5.0F, 5.0F, 5.0F, 4.0F, 4.0F, 4.0F, 4.0F, 3.0F, 3.0F, 3.0F, 3.0F, 2.0F },
+        { 4.0F, 4.0F, 3.0F, 3.0F, 3.0F, 3.0F, 3.0F, 3.0F, 3.0F, 2.0F, 2.0F, 2.0F, 2.0F, 2.0F, 2.0F, 2.0F },
+        { 2.0F, 2.0F, 2.0F, 2.0F, 2.0F, 2.0F, 2.0F, 2.0F, 2.0F, 2.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F },
+        { 1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 0.0F },
+        { 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F },
+        { 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F }
+    }
+};
+
+static const Tables_3dTable_T tables_wall_wetting_x =
+{
+    /* Speed [RPM] */
+    .xTable =
+    {
+        600.0F, 1100.0F, 1500.0F, 1900.0F, 2400.0F, 2800.0F, 3200.0F, 3600.0F, 4100.0F, 4500.0F, 4900.0F, 5300.0F,
+        5700.0F, 6200.0F, 6600.0F, 7000.0F
+    },
+    /* Coolant temperature [oC] */
+    .yTable =
+    {
+        -40.0F, -30.0F, -20.0F, -10.0F, 0.0F, 10.0F, 20.0F, 30.0F, 40.0F, 50.0F, 60.0F, 70.0F, 80.0F, 90.0F, 100.0F,
+        110.0F
+    },
+    /* This table is written as it's natural for humans, point 0.0 is in the bottom left corner of the table */
+    /* Part of the injected fuel deposited on the intake port walls [%] */
+    .zTable =
+    {
+        { 20.0F, 19.0F, 19.0F, 18.0F, 18.0F, 17.0F, 17.0F, 16.0F, 16.0F, 15.0F, 15.0F, 14.0F, 14.0F, 13.0F, 12.0F, 12.0F },
+        { 20.0F, 19.0F, 19.0F, 18.0F, 18.0F, 17.0F, 17.0F, 16.0F, 16.0F, 15.0F, 15.0F, 14.0F, 14.0F, 13.0F, 12.0F, 12.0F },
+        { 20.0F, 19.0F, 19.0F, 18.0F, 18.0F, 17.0F, 17.0F, 16.0F, 16.0F, 15.0F, 15.0F, 14.0F, 14.0F, 13.0F, 12.0F, 12.0F },
+        { 23.0F, 22.0F, 22.0F, 21.0F, 21.0F, 20.0F, 20.0F, 19.0F, 19.0F, 18.0F, 18.0F, 17.0F, 17.0F, 16.0F, 16.0F, 15.0F },
+        { 26.0F, 26.0F, 25.0F, 25.0F, 24.0F, 23.0F, 23.0F, 22.0F, 22.0F, 21.0F, 21.0F, 20.0F, 20.0F, 19.0F, 19.0F, 18.0F },
+        { 29.0F, 29.0F, 28.0F, 28.0F, 27.0F, 26.0F, 26.0F, 25.0F, 25.0F, 24.0F, 24.0F, 23.0F, 23.0F, 22.0F, 22.0F, 21.0F },
+        { 32.0F, 32.0F, 31.0F, 31.0F, 30.0F, 30.0F, 29.0F, 29.0F, 28.0F, 27.0F, 27.0F, 26.0F, 26.0F, 25.0F, 25.0F, 24.0F },
+        { 35.0F, 35.0F, 34.0F, 34.0F, 33.0F, 33.0F, 32.0F, 32.0F, 31.0F, 31.0F, 30.0F, 30.0F, 29.0F, 28.0F, 28.0F, 27.0F },
+        { 38.0F, 38.0F, 37.0F, 37.0F, 36.0F, 36.0F, 35.0F, 35.0F, 34.0F, 34.0F, 33.0F, 33.0F, 32.0F, 31.0F, 31.0F, 30.0F },
+        { 42.0F, 41.0F, 40.0F, 40.0F, 39.0F, 39.0F, 38.0F, 38.0F, 37.0F, 37.0F, 36.0F, 36.0F, 35.0F, 35.0F, 34.0F, 34.0F },
+        { 45.0F, 44.0F, 43.0F, 43.0F, 42.0F, 42.0F, 41.0F, 41.0F, 40.0F, 40.0F, 39.0F, 39.0F, 38.0F, 38.0F, 37.0F, 37.0F },
+        { 48.0F, 47.0F, 47.0F, 46.0F, 45.0F, 45.0F, 44.0F, 44.0F, 43.0F, 43.0F, 42.0F, 42.0F, 41.0F, 41.0F, 40.0F, 40.0F },
+        { 51.0F, 50.0F, 50.0F, 49.0F, 49.0F, 48.0F, 48.0F, 47.0F, 46.0F, 46.0F, 45.0F, 45.0F, 44.0F, 44.0F, 43.0F, 43.0F },
+        { 54.0F, 53.0F, 53.0F, 52.0F, 52.0F, 51.0F, 51.0F, 50.0F, 49.0F, 49.0F, 48.0F, 48.0F, 47.0F, 47.0F, 46.0F, 46.0F },
+        { 57.0F, 56.0F, 56.0F, 55.0F, 55.0F, 54.0F, 54.0F, 53.0F, 53.0F, 52.0F, 52.0F, 51.0F, 51.0F, 50.0F, 49.0F, 49.0F },
+        { 60.0F, 59.0F, 59.0F, 58.0F, 58.0F, 57.0F, 57.0F, 56.0F, 56.0F, 55.0F, 55.0F, 54.0F, 54.0F, 53.0F, 52.0F, 52.0F }
+    }
+};
+
+static const Tables_3dTable_T tables_wall_wetting_tau =
+{
+    /* Speed [RPM] */
+    .xTable =
+    {
+        600.0F, 1100.0F, 1500.0F, 1900.0F, 2400.0F, 2800.0F, 3200.0F, 3600.0F, 4100.0F, 4500.0F, 4900.0F, 5300.0F,
+        5700.0F, 6200.0F, 6600.0F, 7000.0F
+    },
+    /* Coolant temperature [oC] */
+    .yTable =
+    {
+        -40.0F, -30.0F, -20.0F, -10.0F, 0.0F, 10.0F, 20.0F, 30.0F, 40.0F, 50.0F, 60.0F, 70.0F, 80.0F, 90.0F, 100.0F,
+        110.0F
+    },
+    /* This table is written as it's natural for humans, point 0.0 is in the bottom left corner of the table */
+    /* Fuel film evaporation time constant [ms] */
+    .zTable =
+    {
+        { 100.0F, 95.0F, 95.0F, 90.0F, 85.0F, 85.0F, 80.0F, 75.0F, 75.0F, 70.0F, 65.0F, 65.0F, 60.0F, 55.0F, 55.0F, 50.0F },
+        { 100.0F, 95.0F, 95.0F, 90.0F, 85.0F, 85.0F, 80.0F, 75.0F, 75.0F, 70.0F, 65.0F, 65.0F, 60.0F, 55.0F, 55.0F, 50.0F },
+        { 100.0F, 95.0F, 95.0F, 90.0F, 85.0F, 85.0F, 80.0F, 75.0F, 75.0F, 70.0F, 65.0F, 65.0F, 60.0F, 55.0F, 55.0F, 50.0F },
+        { 115.0F, 110.0F, 105.0F, 105.0F, 100.0F, 95.0F, 90.0F, 90.0F, 85.0F, 80.0F, 75.0F, 75.0F, 70.0F, 65.0F, 60.0F, 55.0F },
+        { 140.0F, 135.0F, 130.0F, 130.0F, 120.0F, 120.0F, 115.0F, 110.0F, 105.0F, 100.0F, 95.0F, 90.0F, 85.0F, 80.0F, 75.0F, 70.0F },
+        { 180.0F, 170.0F, 165.0F, 160.0F, 155.0F, 145.0F, 140.0F, 135.0F, 130.0F, 125.0F, 120.0F, 110.0F, 105.0F, 100.0F, 95.0F, 90.0F },
+        { 220.0F, 210.0F, 205.0F, 195.0F, 190.0F, 180.0F, 175.0F, 170.0F, 160.0F, 155.0F, 145.0F, 140.0F, 130.0F, 125.0F, 115.0F, 110.0F },
+        { 265.0F, 255.0F, 250.0F, 240.0F, 230.0F, 220.0F, 215.0F, 205.0F, 195.0F, 185.0F, 175.0F, 170.0F, 160.0F, 150.0F, 140.0F, 135.0F },
+        { 320.0F, 305.0F, 295.0F, 285.0F, 275.0F, 265.0F, 255.0F, 245.0F, 230.0F, 220.0F, 210.0F, 200.0F, 190.0F, 180.0F, 170.0F, 160.0F },
+        { 375.0F, 360.0F, 350.0F, 340.0F, 325.0F, 310.0F, 300.0F, 290.0F, 275.0F, 260.0F, 250.0F, 240.0F, 225.0F, 210.0F, 200.0F, 190.0F },
+        { 440.0F, 420.0F, 405.0F, 395.0F, 375.0F, 365.0F, 350.0F, 335.0F, 320.0F, 305.0F, 290.0F, 275.0F, 265.0F, 245.0F, 235.0F, 220.0F },
+        { 505.0F, 485.0F, 470.0F, 450.0F, 430.0F, 415.0F, 400.0F, 385.0F, 365.0F, 350.0F, 335.0F, 320.0F, 305.0F, 285.0F, 265.0F, 250.0F },
+        { 570.0F, 550.0F, 530.0F, 515.0F, 490.0F, 475.0F, 455.0F, 440.0F, 415.0F, 400.0F, 380.0F, 360.0F, 345.0F, 320.0F, 305.0F, 285.0F },
+        { 645.0F, 620.0F, 600.0F, 580.0F, 555.0F, 535.0F, 515.0F, 495.0F, 470.0F, 450.0F, 430.0F, 410.0F, 390.0F, 365.0F, 345.0F, 320.0F },
+        { 720.0F, 695.0F, 670.0F, 650.0F, 620.0F, 595.0F, 575.0F, 550.0F, 525.0F, 500.0F, 480.0F, 455.0F, 435.0F, 405.0F, 385.0F, 360.0F },
+        { 800.0F, 770.0F, 745.0F, 720.0F, 690.0F, 660.0F, 640.0F, 610.0F, 580.0F, 555.0F, 530.0F, 505.0F, 480.0F, 450.0F, 425.0F, 400.0F }
+    }
+};
+
 /* Bosh NTC M12-L */
 static const Tables_2dTable_T tables_iat =
 {
@@ -171,19 +475,268 @@ static const Tables_2dTable_T tables_clt =
     }
 };
 
+/* x-axis values have to be in ascending order */
 static const Tables_2dTable_T tables_clt_enrichment =
 {
     /* Temperature [oC] */
     .xTable =
     {
-        250.0F, 163.0F, 125.0F, 106.0F, 90.0F, 78.0F, 70.0F, 62.0F, 42.0F, 26.0F, 13.0F, 0.0F, -8.0F, -18.0F, -33.0F,
-        -40.0F
+        -40.0F, -33.0F, -18.0F, -8.0F, 0.0F, 13.0F, 26.0F, 42.0F, 62.0F, 70.0F, 78.0F, 90.0F, 106.0F, 125.0F, 163.0F,
+        250.0F
     },
     /* Enrichment [%] */
     .yTable = 
     {
-        0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 2.0F, 6.0F, 8.0F, 10.0F, 20.0F, 30.0F, 40.0F, 45.0F,
-        50.0F
+        50.0F, 45.0F, 40.0F, 30.0F, 20.0F, 10.0F, 8.0F, 6.0F, 2.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F,
+        0.0F
+    }
+};
+
+static const Tables_2dTable_T tables_dwell =
+{
+    /* Battery voltage [V] */
+    .xTable =
+    {
+        6.0F, 7.0F, 8.0F, 9.0F, 10.0F, 10.5F, 11.0F, 11.5F, 12.0F, 12.5F, 13.0F, 13.5F, 14.0F, 14.5F, 15.0F, 16.0F
+    },
+    /* Coil dwell time [ms] */
+    .yTable =
+    {
+        9.0F, 8.0F, 7.2F, 6.5F, 5.9F, 5.6F, 5.3F, 5.1F, 5.0F, 4.8F, 4.6F, 4.4F, 4.2F, 4.0F, 3.8F, 3.5F
+    }
+};
+
+static const Tables_2dTable_T tables_dwell_duty_limit =
+{
+    /* Speed [RPM] */
+    .xTable =
+    {
+        600.0F, 1100.0F, 1500.0F, 1900.0F, 2400.0F, 2800.0F, 3200.0F, 3600.0F, 4100.0F, 4500.0F, 4900.0F, 5300.0F,
+        5700.0F, 6200.0F, 6600.0F, 7000.0F
+    },
+    /* Maximum dwell time in % of the time between consecutive sparks */
+    .yTable =
+    {
+        60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 60.0F, 65.0F, 70.0F, 75.0F, 75.0F, 80.0F, 80.0F,
+        80.0F
+    }
+};
+
+static const Tables_2dTable_T tables_injector_dead_time =
+{
+    /* Battery voltage [V] */
+    .xTable =
+    {
+        6.0F, 7.0F, 8.0F, 9.0F, 10.0F, 10.5F, 11.0F, 11.5F, 12.0F, 12.5F, 13.0F, 13.5F, 14.0F, 14.5F, 15.0F, 16.0F
+    },
+    /* Injector opening delay [ms] */
+    .yTable =
+    {
+        2.60F, 2.05F, 1.65F, 1.36F, 1.15F, 1.06F, 0.99F, 0.92F, 0.86F, 0.81F, 0.76F, 0.72F, 0.68F, 0.65F, 0.62F,
+        0.56F
+    }
+};
+
+/* x-axis values have to be in ascending order */
+static const Tables_2dTable_T tables_injector_short_pulse =
+{
+    /* Effective open time [ms] */
+    .xTable =
+    {
+        0.0F, 0.1F, 0.2F, 0.3F, 0.4F, 0.5F, 0.6F, 0.7F, 0.8F, 0.9F, 1.0F, 1.1F, 1.2F, 1.3F, 1.4F, 1.6F
+    },
+    /* Additional open time compensating not fully opened injector [ms] */
+    .yTable =
+    {
+        0.120F, 0.100F, 0.082F, 0.066F, 0.052F, 0.040F, 0.030F, 0.022F, 0.015F, 0.010F, 0.006F, 0.003F, 0.001F,
+        0.0F, 0.0F, 0.0F
+    }
+};
+
+static const Tables_2dTable_T tables_idle_target_speed =
+{
+    /* Temperature [oC] */
+    .xTable =
+    {
+        -40.0F, -30.0F, -20.0F, -10.0F, 0.0F, 10.0F, 20.0F, 30.0F, 40.0F, 50.0F, 60.0F, 70.0F, 80.0F, 90.0F, 100.0F,
+        110.0F
+    },
+    /* Target idle speed [RPM] */
+    .yTable =
+    {
+        1500.0F, 1450.0F, 1400.0F, 1350.0F, 1300.0F, 1250.0F, 1200.0F, 1150.0F, 1100.0F, 1050.0F, 1000.0F, 950.0F,
+        900.0F, 900.0F, 900.0F, 950.0F
+    }
+};
+
+static const Tables_2dTable_T tables_idle_base_duty =
+{
+    /* Temperature [oC] */
+    .xTable =
+    {
+        -40.0F, -30.0F, -20.0F, -10.0F, 0.0F, 10.0F, 20.0F, 30.0F, 40.0F, 50.0F, 60.0F, 70.0F, 80.0F, 90.0F, 100.0F,
+        110.0F
+    },
+    /* Idle air valve open-loop duty [%] */
+    .yTable =
+    {
+        70.0F, 66.0F, 62.0F, 58.0F, 54.0F, 50.0F, 46.0F, 42.0F, 39.0F, 36.0F, 33.0F, 31.0F, 30.0F, 30.0F, 30.0F, 32.0F
+    }
+};
+
+static const Tables_2dTable_T tables_spark_clt_correction =
+{
+    /* Temperature [oC] */
+    .xTable =
+    {
+        -40.0F, -30.0F, -20.0F, -10.0F, 0.0F, 10.0F, 20.0F, 30.0F, 40.0F, 50.0F, 60.0F, 70.0F, 80.0F, 90.0F, 100.0F,
+        110.0F
+    },
+    /* Spark advance added to the spark table [deg] */
+    .yTable =
+    {
+        6.0F, 5.5F, 5.0F, 4.5F, 4.0F, 3.5F, 3.0F, 2.5F, 2.0F, 1.0F, 0.5F, 0.0F, 0.0F, 0.0F, -1.0F, -3.0F
+    }
+};
+
+static const Tables_2dTable_T tables_spark_iat_correction =
+{
+    /* Temperature [oC] */
+    .xTable =
+    {
+        -40.0F, -30.0F, -20.0F, -10.0F, 0.0F, 10.0F, 20.0F, 30.0F, 40.0F, 50.0F, 60.0F, 70.0F, 80.0F, 90.0F, 100.0F,
+        110.0F
+    },
+    /* Spark advance added to the spark table [deg] */
+    .yTable =
+    {
+        2.0F, 2.0F, 1.5F, 1.5F, 1.0F, 0.5F, 0.0F, 0.0F, -0.5F, -1.0F, -2.0F, -3.0F, -4.0F, -5.0F, -6.0F, -7.0F
+    }
+};
+
+static const Tables_2dTable_T tables_prime_pulse =
+{
+    /* Temperature [oC] */
+    .xTable =
+    {
+        -40.0F, -30.0F, -20.0F, -10.0F, 0.0F, 10.0F, 20.0F, 30.0F, 40.0F, 50.0F, 60.0F, 70.0F, 80.0F, 90.0F, 100.0F,
+        110.0F
+    },
+    /* Effective injector open time added to the first injection of every cylinder [ms] */
+    .yTable =
+    {
+        30.0F, 25.0F, 20.0F, 16.0F, 12.0F, 9.0F, 7.0F, 5.5F, 4.5F, 3.5F, 3.0F, 2.5F, 2.0F, 2.0F, 2.0F, 2.0F
+    }
+};
+
+static const Tables_2dTable_T tables_cranking_enrichment =
+{
+    /* Temperature [oC] */
+    .xTable =
+    {
+        -40.0F, -30.0F, -20.0F, -10.0F, 0.0F, 10.0F, 20.0F, 30.0F, 40.0F, 50.0F, 60.0F, 70.0F, 80.0F, 90.0F, 100.0F,
+        110.0F
+    },
+    /* Fuel enrichment during cranking [%] */
+    .yTable =
+    {
+        300.0F, 260.0F, 220.0F, 180.0F, 150.0F, 120.0F, 100.0F, 80.0F, 65.0F, 50.0F, 40.0F, 35.0F, 30.0F, 30.0F,
+        30.0F, 30.0F
+    }
+};
+
+static const Tables_2dTable_T tables_after_start_enrichment =
+{
+    /* Temperature [oC] */
+    .xTable =
+    {
+        -40.0F, -30.0F, -20.0F, -10.0F, 0.0F, 10.0F, 20.0F, 30.0F, 40.0F, 50.0F, 60.0F, 70.0F, 80.0F, 90.0F, 100.0F,
+        110.0F
+    },
+    /* Fuel enrichment at the beggining of after start state [%] */
+    .yTable =
+    {
+        80.0F, 70.0F, 60.0F, 50.0F, 45.0F, 40.0F, 35.0F, 30.0F, 25.0F, 20.0F, 15.0F, 12.0F, 10.0F, 10.0F, 10.0F,
+        10.0F
+    }
+};
+
+static const Tables_2dTable_T tables_after_start_cycles =
+{
+    /* Temperature [oC] */
+    .xTable =
+    {
+        -40.0F, -30.0F, -20.0F, -10.0F, 0.0F, 10.0F, 20.0F, 30.0F, 40.0F, 50.0F, 60.0F, 70.0F, 80.0F, 90.0F, 100.0F,
+        110.0F
+    },
+    /* After start enrichment decay duration [engine cycles] */
+    .yTable =
+    {
+        600.0F, 550.0F, 500.0F, 450.0F, 400.0F, 350.0F, 300.0F, 250.0F, 200.0F, 160.0F, 120.0F, 100.0F, 80.0F, 80.0F,
+        80.0F, 80.0F
+    }
+};
+
+/* Axes have to be the same as in tables_trim_spark, cell is searched once for both */
+static const Tables_TrimTable_T tables_trim_fuel =
+{
+    /* Speed [RPM] */
+    .xTable = { 1000.0F, 2500.0F, 4500.0F, 6500.0F },
+    /* Absolute pressure [kPa] */
+    .yTable = { 30.0F, 55.0F, 80.0F, 101.0F },
+    /* This table is written as it's natural for humans, point 0.0 is in the bottom left corner of the table */
+    /* Fuel trim [%] */
+    .zTable =
+    {
+        /* Cylinder 1, shortest runner */
+        {
+            { 1.0F, 1.5F, 2.0F, 2.0F },
+            { 1.0F, 1.0F, 1.5F, 2.0F },
+            { 0.5F, 1.0F, 1.0F, 1.5F },
+            { 0.0F, 0.5F, 0.5F, 1.0F }
+        },
+        /* Cylinder 2, reference */
+        {
+            { 0.0F }
+        },
+        /* Cylinder 3, farthest from the throttle */
+        {
+            { -1.0F, -1.5F, -1.5F, -2.0F },
+            { -0.5F, -1.0F, -1.0F, -1.5F },
+            { -0.5F, -0.5F, -1.0F, -1.0F },
+            { 0.0F, -0.5F, -0.5F, -0.5F }
+        }
+    }
+};
+
+static const Tables_TrimTable_T tables_trim_spark =
+{
+    /* Speed [RPM] */
+    .xTable = { 1000.0F, 2500.0F, 4500.0F, 6500.0F },
+    /* Absolute pressure [kPa] */
+    .yTable = { 30.0F, 55.0F, 80.0F, 101.0F },
+    /* This table is written as it's natural for humans, point 0.0 is in the bottom left corner of the table */
+    /* Spark advance trim [deg] */
+    .zTable =
+    {
+        /* Cylinder 1, shortest runner */
+        {
+            { 0.0F, 0.0F, -0.5F, -1.0F },
+            { 0.0F, 0.0F, 0.0F, -0.5F },
+            { 0.0F, 0.0F, 0.0F, 0.0F },
+            { 0.0F, 0.0F, 0.0F, 0.0F }
+        },
+        /* Cylinder 2, reference */
+        {
+            { 0.0F }
+        },
+        /* Cylinder 3, farthest from the throttle */
+        {
+            { 0.0F, 0.5F, 0.5F, 0.5F },
+            { 0.0F, 0.0F, 0.5F, 0.5F },
+            { 0.0F, 0.0F, 0.0F, 0.0F },
+            { 0.0F, 0.0F, 0.0F, 0.0F }
+        }
     }
 };
 
@@ -193,6 +746,50 @@ static const Tables_2dTable_T tables_clt_enrichment =
  *
  *===========================================================================*/
 
+/*===========================================================================*
+ * brief:       Gets 3D table structure
+ * param[in]:   tableType - specifies which table will be returned
+ * param[out]:  None
+ * return:      const Tables_3dTable_T* - pointer to the table, NULL for unknown type
+ * details:     None
+ *===========================================================================*/
+const Tables_3dTable_T* Tables_Select3DTable(Tables_3D_T tableType);
+
+/*===========================================================================*
+ * brief:       Gets trim table structure
+ * param[in]:   tableType - specifies which table will be returned
+ * param[out]:  None
+ * return:      const Tables_TrimTable_T* - pointer to the table, NULL for unknown type
+ * details:     None
+ *===========================================================================*/
+const Tables_TrimTable_T* Tables_SelectTrimTable(Tables_Trim_T tableType);
+
+/*===========================================================================*
+ * brief:       Gets cell of the table axes containing given x-axis and y-axis values
+ * param[in]:   tableType - table type
+ * param[in]:   xValue - x-axis value
+ * param[in]:   yValue - y-axis value
+ * param[in]:   xTable - a pointer to the x-axis values
+ * param[in]:   yTable - a pointer to the y-axis values
+ * param[out]:  cell - cell indexes and position inside the cell
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+void Tables_GetCell(Tables_Types_T tableType, float xValue, float yValue, const float* xTable, const float* yTable,
+                    Tables_3DCell_T* cell);
+
+/*===========================================================================*
+ * brief:       Bilinear interpolation of the four cell corners
+ * param[in]:   zTable - a pointer to the first z-value of the table
+ * param[in]:   rowsNo - number of the table rows
+ * param[in]:   columnsNo - number of the table columns
+ * param[in]:   cell - cell indexes and position inside the cell
+ * param[out]:  None
+ * return:      float - interpolated z-value
+ * details:     Rows are stored from the top, as the table is written
+ *===========================================================================*/
+float Tables_GetCellValue(const float* zTable, uint8_t rowsNo, uint8_t columnsNo, const Tables_3DCell_T* cell);
+
 /*===========================================================================*
  * brief:       Bilinear interpolation for 3D table
  * param[in]:   x - an x-value of searched point
@@ -243,19 +840,11 @@ float Tables_Get3DTableValue(Tables_3D_T tableType, float xValue, float yValue)
     uint8_t yIndex;
     const Tables_3dTable_T* table;
 
-    switch (tableType)
-    {
-        case TABLES_3D_VE:
-            table = &tables_ve;
-            break;
+    table = Tables_Select3DTable(tableType);
 
-        case TABLES_3D_SPARK:
-            table = &tables_spark;
-            break;
-
-        default:
-            return 0.0F;
-            break;
+    if (NULL == table)
+    {
+        return 0.0F;
     }
 
     xIndex = Tables_GetIndexFromTable(TABLES_TYPES_3D, xValue, table->xTable);
@@ -286,6 +875,54 @@ float Tables_Get2DTableValue(Tables_2D_T tableType, float xValue)
             table = &tables_clt_enrichment;
             break;
 
+        case TABLES_2D_DWELL:
+            table = &tables_dwell;
+            break;
+
+        case TABLES_2D_DWELL_DUTY_LIMIT:
+            table = &tables_dwell_duty_limit;
+            break;
+
+        case TABLES_2D_INJECTOR_DEAD_TIME:
+            table = &tables_injector_dead_time;
+            break;
+
+        case TABLES_2D_INJECTOR_SHORT_PULSE:
+            table = &tables_injector_short_pulse;
+            break;
+
+        case TABLES_2D_IDLE_TARGET_SPEED:
+            table = &tables_idle_target_speed;
+            break;
+
+        case TABLES_2D_IDLE_BASE_DUTY:
+            table = &tables_idle_base_duty;
+            break;
+
+        case TABLES_2D_SPARK_CLT_CORRECTION:
+            table = &tables_spark_clt_correction;
+            break;
+
+        case TABLES_2D_SPARK_IAT_CORRECTION:
+            table = &tables_spark_iat_correction;
+            break;
+
+        case TABLES_2D_PRIME_PULSE:
+            table = &tables_prime_pulse;
+            break;
+
+        case TABLES_2D_CRANKING_ENRICHMENT:
+            table = &tables_cranking_enrichment;
+            break;
+
+        case TABLES_2D_AFTER_START_ENRICHMENT:
+            table = &tables_after_start_enrichment;
+            break;
+
+        case TABLES_2D_AFTER_START_CYCLES:
+            table = &tables_after_start_cycles;
+            break;
+
         default:
             return 0.0F;
             break;
@@ -296,12 +933,212 @@ float Tables_Get2DTableValue(Tables_2D_T tableType, float xValue)
     return Tables_LinearInterpolation(xValue, xIndex, table);
 }
 
+/*===========================================================================*
+ * Function: Tables_Get3DTableCell
+ *===========================================================================*/
+void Tables_Get3DTableCell(Tables_3D_T tableType, float xValue, float yValue, Tables_3DCell_T* cell)
+{
+    const Tables_3dTable_T* table;
+
+    table = Tables_Select3DTable(tableType);
+
+    if ((NULL == table) || (NULL == cell))
+    {
+        goto tables_get_3d_table_cell_exit;
+    }
+
+    Tables_GetCell(TABLES_TYPES_3D, xValue, yValue, table->xTable, table->yTable, cell);
+
+tables_get_3d_table_cell_exit:
+
+    return;
+}
+
+/*===========================================================================*
+ * Function: Tables_Get3DCellValue
+ *===========================================================================*/
+float Tables_Get3DCellValue(Tables_3D_T tableType, const Tables_3DCell_T* cell)
+{
+    const Tables_3dTable_T* table;
+
+    table = Tables_Select3DTable(tableType);
+
+    if ((NULL == table) || (NULL == cell))
+    {
+        return 0.0F;
+    }
+
+    return Tables_GetCellValue(&table->zTable[0][0], TABLES_3D_ROWS, TABLES_3D_COLUMNS, cell);
+}
+
+/*===========================================================================*
+ * Function: Tables_GetTrimTableCell
+ *===========================================================================*/
+void Tables_GetTrimTableCell(Tables_Trim_T tableType, float xValue, float yValue, Tables_3DCell_T* cell)
+{
+    const Tables_TrimTable_T* table;
+
+    table = Tables_SelectTrimTable(tableType);
+
+    if ((NULL == table) || (NULL == cell))
+    {
+        goto tables_get_trim_table_cell_exit;
+    }
+
+    Tables_GetCell(TABLES_TYPES_TRIM, xValue, yValue, table->xTable, table->yTable, cell);
+
+tables_get_trim_table_cell_exit:
+
+    return;
+}
+
+/*===========================================================================*
+ * Function: Tables_GetTrimCellValue
+ *===========================================================================*/
+float Tables_GetTrimCellValue(Tables_Trim_T tableType, uint8_t cylinder, const Tables_3DCell_T* cell)
+{
+    const Tables_TrimTable_T* table;
+
+    table = Tables_SelectTrimTable(tableType);
+
+    if ((NULL == table) || (NULL == cell) || (cylinder >= ENCON_CHANNELS_MAX))
+    {
+        return 0.0F;
+    }
+
+    return Tables_GetCellValue(&table->zTable[cylinder][0][0], TABLES_TRIM_ROWS, TABLES_TRIM_COLUMNS, cell);
+}
+
 /*===========================================================================*
  *
  * LOCAL FUNCTION DEFINITION SECTION
  *
  *===========================================================================*/
 
+/*===========================================================================*
+ * Function: Tables_Select3DTable
+ *===========================================================================*/
+const Tables_3dTable_T* Tables_Select3DTable(Tables_3D_T tableType)
+{
+    const Tables_3dTable_T* table;
+
+    switch (tableType)
+    {
+        case TABLES_3D_VE:
+            table = &tables_ve;
+            break;
+
+        case TABLES_3D_TARGET_LAMBDA_RECIPROCAL:
+            table = &tables_target_lambda_reciprocal;
+            break;
+
+        case TABLES_3D_SPARK:
+            table = &tables_spark;
+            break;
+
+        case TABLES_3D_ALPHA_N_LOAD:
+            table = &tables_alpha_n_load;
+            break;
+
+        case TABLES_3D_LOAD_BLEND:
+            table = &tables_load_blend;
+            break;
+
+        case TABLES_3D_INJECTION_SPLIT_RATIO:
+            table = &tables_injection_split_ratio;
+            break;
+
+        case TABLES_3D_INJECTION_SPLIT_ANGLE:
+            table = &tables_injection_split_angle;
+            break;
+
+        case TABLES_3D_ACCEL_ENRICHMENT:
+            table = &tables_accel_enrichment;
+            break;
+
+        case TABLES_3D_WALL_WETTING_X:
+            table = &tables_wall_wetting_x;
+            break;
+
+        case TABLES_3D_WALL_WETTING_TAU:
+            table = &tables_wall_wetting_tau;
+            break;
+
+        default:
+            table = NULL;
+            break;
+    }
+
+    return table;
+}
+
+/*===========================================================================*
+ * Function: Tables_SelectTrimTable
+ *===========================================================================*/
+const Tables_TrimTable_T* Tables_SelectTrimTable(Tables_Trim_T tableType)
+{
+    const Tables_TrimTable_T* table;
+
+    switch (tableType)
+    {
+        case TABLES_TRIM_FUEL:
+            table = &tables_trim_fuel;
+            break;
+
+        case TABLES_TRIM_SPARK:
+            table = &tables_trim_spark;
+            break;
+
+        default:
+            table = NULL;
+            break;
+    }
+
+    return table;
+}
+
+/*===========================================================================*
+ * Function: Tables_GetCell
+ *===========================================================================*/
+void Tables_GetCell(Tables_Types_T tableType, float xValue, float yValue, const float* xTable, const float* yTable,
+                    Tables_3DCell_T* cell)
+{
+    uint8_t x0;
+    uint8_t y0;
+    float u;
+    float v;
+
+    x0 = Tables_GetIndexFromTable(tableType, xValue, xTable);
+    y0 = Tables_GetIndexFromTable(tableType, yValue, yTable);
+
+    u = (xValue - xTable[x0]) / (xTable[x0 + 1U] - xTable[x0]);
+    v = (yValue - yTable[y0]) / (yTable[y0 + 1U] - yTable[y0]);
+
+    /* Values outside of the table are saturated to the table edges */
+    cell->u = UTILS_LIMIT(u, 0.0F, 1.0F);
+    cell->v = UTILS_LIMIT(v, 0.0F, 1.0F);
+    cell->xIndex = x0;
+    cell->yIndex = y0;
+}
+
+/*===========================================================================*
+ * Function: Tables_GetCellValue
+ *===========================================================================*/
+float Tables_GetCellValue(const float* zTable, uint8_t rowsNo, uint8_t columnsNo, const Tables_3DCell_T* cell)
+{
+    const float* lowerRow;
+    const float* upperRow;
+    uint8_t x0;
+
+    x0 = cell->xIndex;
+    /* Z table rows are stored from the top, see Tables_BilinearInterpolation */
+    lowerRow = &zTable[(uint32_t)((rowsNo - 1U) - cell->yIndex) * columnsNo];
+    upperRow = lowerRow - columnsNo;
+
+    return (1.0F - cell->u) * (((1.0F - cell->v) * lowerRow[x0]) + (cell->v * upperRow[x0])) +
+           (cell->u * (((1.0F - cell->v) * lowerRow[x0 + 1U]) + (cell->v * upperRow[x0 + 1U])));
+}
+
 /*===========================================================================*
  * Function: Tables_BilinearInterpolation
  *===========================================================================*/
@@ -320,12 +1157,16 @@ float Tables_BilinearInterpolation(float x, float y, uint8_t x0, uint8_t y0, con
     u = (x - table->xTable[x0]) / (table->xTable[x0 + 1U] - table->xTable[x0]);
     v = (y - table->yTable[y0]) / (table->yTable[y0 + 1U] - table->yTable[y0]);
 
+    /* Values outside of the table are saturated to the table edges */
+    u = (u < 0.0F) ? 0.0F : ((u > 1.0F) ? 1.0F : u);
+    v = (v < 0.0F) ? 0.0F : ((v > 1.0F) ? 1.0F : v);
+
     /* Z table is written in cartesian coordinate (0,0 is in bottom left corner) */
-    /* In C (0,0) is top left corner, so y index need to be flipped */
-    y0 = TABLES_3D_ROWS - y0;
+    /* In C (0,0) is top left corner, so y index need to be flipped: y0 row is above y0 + 1 row */
+    y0 = (TABLES_3D_ROWS - 1U) - y0;
 
-    return (1.0F - u) * (((1.0F - v) * table->zTable[y0][x0]) + (v * table->zTable[y0 + 1U][x0])) +
-           (u * (((1.0F - v) * table->zTable[y0][x0 + 1U]) + (v * table->zTable[y0 + 1U][x0 + 1U])));
+    return (1.0F - u) * (((1.0F - v) * table->zTable[y0][x0]) + (v * table->zTable[y0 - 1U][x0])) +
+           (u * (((1.0F - v) * table->zTable[y0][x0 + 1U]) + (v * table->zTable[y0 - 1U][x0 + 1U])));
 }
 
 /*===========================================================================*
@@ -333,8 +1174,13 @@ float Tables_BilinearInterpolation(float x, float y, uint8_t x0, uint8_t y0, con
  *===========================================================================*/
 float Tables_LinearInterpolation(float x, uint8_t x0, const Tables_2dTable_T* table)
 {
-    return (((x - table->xTable[x0]) * (table->yTable[x0 + 1U] - table->yTable[x0])) /
-           (table->xTable[x0 + 1U] - table->xTable[x0])) + table->yTable[x0];
+    float u;
+
+    u = (x - table->xTable[x0]) / (table->xTable[x0 + 1U] - table->xTable[x0]);
+    /* Values outside of the table are saturated to the table edges */
+    u = (u < 0.0F) ? 0.0F : ((u > 1.0F) ? 1.0F : u);
+
+    return (u * (table->yTable[x0 + 1U] - table->yTable[x0])) + table->yTable[x0];
 }
 
 /*===========================================================================*
@@ -362,29 +1208,36 @@ uint8_t Tables_GetIndexFromTable(Tables_Types_T tableType, float value, const fl
             lastIndex = TABLES_3D_LAST_INDEX;
             break;
 
+        case TABLES_TYPES_TRIM:
+            lastIndex = TABLES_TRIM_LAST_INDEX;
+            break;
+
         default:
             result = 0U;
             goto tables_get_index_from_speed_pressure_table_exit;
             break;
     }
 
+    /* Returned index is always the lower point of the interpolated segment */
     if (value <= table[TABLES_FIRST_INDEX])
     {
         result = TABLES_FIRST_INDEX;
     }
     else if (value >= table[lastIndex])
     {
-        result = lastIndex;
+        result = lastIndex - 1U;
     }
     else
     {
         for (index = 0; index < (lastIndex - 1U); index++)
         {
-            if ((value >= table[index]) && (value < table[index + 1U]))
+            if (value < table[index + 1U])
             {
-                result = index;
+                break;
             }
         }
+
+        result = index;
     }
 
 tables_get_index_from_speed_pressure_table_exit:
@@ -15,6 +15,7 @@
 #include "trigger_decoder.h"
 
 #include "engine_constants.h"
+#include "engine_sensors.h"
 #include "swo.h"
 #include "timers.h"
 
@@ -55,6 +56,16 @@ extern bool main_is_speed_trigger_occured;
  *
  *===========================================================================*/
 
+#if ENSENS_TPS_LAMBDA_SENSORS_ENABLED
+/*===========================================================================*
+ * brief:       EXTI9_5 Interrupt request handler
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Sync signal conditioning ISR
+ *===========================================================================*/
+extern void EXTI9_5_IRQHandler(void);
+#else
 /*===========================================================================*
  * brief:       EXTI4 Interrupt request handler
  * param[in]:   None
@@ -63,6 +74,7 @@ extern bool main_is_speed_trigger_occured;
  * details:     Sync signal conditioning ISR
  *===========================================================================*/
 extern void EXTI4_IRQHandler(void);
+#endif
 
 /*===========================================================================*
  * brief:       TIM3 Interrupt request handler
@@ -104,11 +116,7 @@ void TrigD_Init(Trigd_IsrCallback callback)
 {
     trigd_engine_angle = ENCON_ANGLE_UNKNOWN;
     trigd_is_sync_pending = false;
-
-    if (callback != NULL)
-    {
-        trigd_trigger_callback = callback;
-    }
+    trigd_trigger_callback = callback;
 
     TrigD_SyncPinInit();
     TrigD_SpeedPinInit();
@@ -120,6 +128,19 @@ void TrigD_Init(Trigd_IsrCallback callback)
  *
  *===========================================================================*/
 
+#if ENSENS_TPS_LAMBDA_SENSORS_ENABLED
+/*===========================================================================*
+ * Function: EXTI9_5_IRQHandler
+ *===========================================================================*/
+void EXTI9_5_IRQHandler(void)
+{
+    if (EXTI_GetPendingTrigger(EXTI_PR_PR5))
+    {
+        EXTI_ClearPendingTrigger(EXTI_PR_PR5);
+        trigd_is_sync_pending= true;
+    }
+}
+#else
 /*===========================================================================*
  * Function: EXTI4_IRQHandler
  *===========================================================================*/
@@ -131,6 +152,7 @@ void EXTI4_IRQHandler(void)
         trigd_is_sync_pending= true;
     }
 }
+#endif
 
 /*===========================================================================*
  * Function: TIM3_IRQHandler
@@ -144,8 +166,10 @@ void TIM3_IRQHandler(void)
     /* Capture interrupt */
     if (TIMER_SPEED->SR & TIM_SR_CC1IF)
     {
-        /* Start scheduled actions */
-        trigd_trigger_callback();
+        if (trigd_trigger_callback != NULL)
+        {
+            trigd_trigger_callback();
+        }
 
         /* Clear interrupt flag */
         TIMER_SPEED->SR &= ~TIM_SR_CC1IF;
@@ -209,6 +233,34 @@ void TIM3_IRQHandler(void)
  *===========================================================================*/
 static void TrigD_SyncPinInit(void)
 {
+#if ENSENS_TPS_LAMBDA_SENSORS_ENABLED
+    /* Sync input pin: PB5 (PA4 is used by TPS) */
+
+    /* Enable SYSCFG clock */
+    RCC->APB2ENR |= RCC_APB2ENR_SYSCFGEN;
+    /* Enable GPIOB clock */
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOBEN;
+    /* Set GPIOB port 5 as input */
+    GPIOB->MODER &= ~GPIO_MODER_MODER5;
+    /* Disable pull-up and pull-down for GPIOB port 5 */
+    GPIOB->PUPDR &= ~GPIO_PUPDR_PUPD5;
+
+    /* Connect PB5 pin to the EXTI5 interrupt */
+    SYSCFG->EXTICR[1] &= ~SYSCFG_EXTICR2_EXTI5;
+    SYSCFG->EXTICR[1] |= SYSCFG_EXTICR2_EXTI5_PB;
+    /* Don't mask EXTI5 interrupt */
+    EXTI->IMR |= EXTI_IMR_IM5;
+    /* Disable rising edge trigger */
+    EXTI->RTSR &= ~EXTI_RTSR_TR5;
+    /* Enble falling edge trigger */
+    EXTI->FTSR |= EXTI_FTSR_TR5;
+
+    /* Enable interrupt request */
+    NVIC_SetPriority(EXTI9_5_IRQn, 1U);
+    EXTI_ClearPendingTrigger(EXTI_PR_PR5);
+    NVIC_ClearPendingIRQ(EXTI9_5_IRQn);
+    NVIC_EnableIRQ(EXTI9_5_IRQn);
+#else
     /* Sync input pin: PA4 */
 
     /* Enable SYSCFG clock */
@@ -234,6 +286,7 @@ static void TrigD_SyncPinInit(void)
     EXTI_ClearPendingTrigger(EXTI_PR_PR4);
     NVIC_ClearPendingIRQ(EXTI4_IRQn);
     NVIC_EnableIRQ(EXTI4_IRQn);
+#endif
 }
 
 /*===========================================================================*
@@ -241,6 +294,21 @@ static void TrigD_SyncPinInit(void)
  *===========================================================================*/
 static void TrigD_SpeedPinInit(void)
 {
+#if ENSENS_TPS_LAMBDA_SENSORS_ENABLED
+    /* Speed input pin: PB4 (PA6 is used by lambda) */
+    /* Speed input timer: TIM3 CH1 */
+
+    /* Enable GPIOB clock */
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOBEN;
+    /* Disable PB4 pull-up enabled after reset for JTAG NJTRST */
+    GPIOB->PUPDR &= ~GPIO_PUPDR_PUPD4;
+    /* Set PB4 afternative function 2 (TIM3_CH1) */
+    GPIOB->AFR[0] &= ~GPIO_AFRL_AFSEL4;
+    GPIOB->AFR[0] |= GPIO_AFRL_AFSEL4_1;
+    /* Set PB4 Alternative function mode */
+    GPIOB->MODER &= ~GPIO_MODER_MODE4;
+    GPIOB->MODER |= GPIO_MODER_MODE4_1;
+#else
     /* Speed input pin: PA6 */
     /* Speed input timer: TIM3 CH1 */
 
@@ -250,6 +318,7 @@ static void TrigD_SpeedPinInit(void)
     GPIOA->AFR[0] |= GPIO_AFRL_AFSEL6_1;
     /* Set PA6 Alternative function mode */
     GPIOA->MODER |= GPIO_MODER_MODE6_1;
+#endif
     /* Enable timer clock*/
     RCC->APB1ENR |= RCC_APB1ENR_TIM3EN;
 
@@ -265,6 +334,9 @@ static void TrigD_SpeedPinInit(void)
     TIMER_SPEED->CCER &= ~TIM_CCER_CC1NP;
     /* Enable capture */
     TIMER_SPEED->CCER |= TIM_CCER_CC1E;
+    /* Set master mode compare pulse: TRGO pulse on every capture */
+    /* TRGO starts armed ignition and injection timers without ISR latency */
+    TIMER_SPEED->CR2 |= (TIM_CR2_MMS_1 | TIM_CR2_MMS_0);
 
     /* Enable interrupt requests */
     TIMER_SPEED->DIER |= TIM_DIER_TIE;
@@ -87,6 +87,18 @@ uint32_t Utils_FloatToUint32(float inValue)
     return result;
 }
 
+/*===========================================================================*
+ * Function: Utils_TimestampInit
+ *===========================================================================*/
+void Utils_TimestampInit(void)
+{
+    /* Enable DWT unit */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    /* Start cycles counter */
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
 /*===========================================================================*
  *
  * LOCAL FUNCTION DEFINITION SECTION
@@ -0,0 +1,154 @@
+/*===========================================================================*
+ * File:        wall_wetting.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Intake port fuel film (X-tau) transient compensation
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "wall_wetting.h"
+
+#include "engine_sensors.h"
+#include "tables.h"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/* Engine cycle time in ms at given speed in RPM */
+#define WALLWET_CYCLE_TIME_MS(_SPEED_)          ((2.0F * 60.0F * UTILS_CONVERT_TO_MILI_MULTIPL) / (_SPEED_))
+
+/* Deposited fraction is limited, so the requested fuel can always be delivered */
+#define WALLWET_DEPOSIT_FRACTION_MAX            (0.9F)
+
+/*===========================================================================*
+ *
+ * LOCAL TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+typedef struct WallWet_Parameters_Tag
+{
+    /* Fraction of injected fuel deposited on the wall (X) */
+    float depositFraction;
+    /* Fraction of the film evaporated over one engine cycle */
+    float evaporatedFraction;
+    /* 1 / (1 - X), injected fuel needed to deliver unit of fuel directly to the cylinder */
+    float directReciprocal;
+} WallWet_Parameters_T;
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+/* Fuel film in the intake port of every cylinder, as effective injector open time in ms */
+static float wallwet_film[ENCON_CHANNEL_COUNT];
+
+/* Film parameters change slowly, they are calculated once per engine cycle */
+static WallWet_Parameters_T wallwet_parameters;
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: WallWet_Init
+ *===========================================================================*/
+void WallWet_Init(void)
+{
+    /* No compensation until the first update */
+    wallwet_parameters.depositFraction = 0.0F;
+    wallwet_parameters.evaporatedFraction = 0.0F;
+    wallwet_parameters.directReciprocal = 1.0F;
+
+    WallWet_Reset();
+}
+
+/*===========================================================================*
+ * Function: WallWet_Reset
+ *===========================================================================*/
+void WallWet_Reset(void)
+{
+    EnCon_CylinderChannels_T channel;
+
+    for (channel = ENCON_CHANNEL_1; channel < ENCON_CHANNEL_COUNT; channel++)
+    {
+        wallwet_film[channel] = 0.0F;
+    }
+}
+
+/*===========================================================================*
+ * Function: WallWet_Update
+ *===========================================================================*/
+void WallWet_Update(float speed)
+{
+    float coolantTemp;
+    float depositFraction;
+    float tauMs;
+
+    coolantTemp = UTILS_CONVERT_K_TO_C(EnSens_GetClt(ENSENS_CLT_RESULT_TYPE_TEMPERATURE));
+    depositFraction = Tables_Get3DTableValue(TABLES_3D_WALL_WETTING_X, speed, coolantTemp) /
+                      (float)UTILS_PERCENTAGE_CONVERTER;
+    tauMs = Tables_Get3DTableValue(TABLES_3D_WALL_WETTING_TAU, speed, coolantTemp);
+
+    if (depositFraction > WALLWET_DEPOSIT_FRACTION_MAX)
+    {
+        depositFraction = WALLWET_DEPOSIT_FRACTION_MAX;
+    }
+
+    wallwet_parameters.depositFraction = depositFraction;
+    /* Backward Euler discretization of film evaporation over one engine cycle, stays in <0; 1> range */
+    wallwet_parameters.evaporatedFraction = WALLWET_CYCLE_TIME_MS(speed) / (tauMs + WALLWET_CYCLE_TIME_MS(speed));
+    wallwet_parameters.directReciprocal = 1.0F / (1.0F - depositFraction);
+}
+
+/*===========================================================================*
+ * Function: WallWet_Compensate
+ *===========================================================================*/
+float WallWet_Compensate(EnCon_CylinderChannels_T channel, float fuelMs)
+{
+    float evaporatedMs;
+    float injectedMs;
+
+    evaporatedMs = wallwet_parameters.evaporatedFraction * wallwet_film[channel];
+
+    /* Cylinder gets (1 - X) of injected fuel and evaporated part of the film */
+    injectedMs = (fuelMs - evaporatedMs) * wallwet_parameters.directReciprocal;
+
+    if (injectedMs < 0.0F)
+    {
+        /* Film alone delivers more than requested, it can't be taken back */
+        injectedMs = 0.0F;
+    }
+
+    wallwet_film[channel] += (wallwet_parameters.depositFraction * injectedMs) - evaporatedMs;
+
+    return injectedMs;
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+
+/* end of file */
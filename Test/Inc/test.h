@@ -0,0 +1,97 @@
+/*===========================================================================*
+ * File:        test.h
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Minimal host test framework
+ *===========================================================================*/
+#ifndef _TEST_H_
+#define _TEST_H_
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "stdbool.h"
+#include "stdint.h"
+#include "stdio.h"
+
+/*===========================================================================*
+ *
+ * EXPORTED DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/* Records failed check with its location, test continues so all failures are listed */
+#define TEST_CHECK(_COND_)                                      Test_Check((_COND_), #_COND_, __FILE__, __LINE__)
+
+#define TEST_CHECK_FLOAT(_VAL_, _EXP_, _TOL_)                   Test_CheckFloat((float)(_VAL_), (float)(_EXP_),   \
+                                                                                (float)(_TOL_), #_VAL_,           \
+                                                                                __FILE__, __LINE__)
+
+#define TEST_RUN(_TEST_)                                        Test_Run((_TEST_), #_TEST_)
+
+/*===========================================================================*
+ *
+ * EXPORTED TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+typedef void (*Test_Function_T)(void);
+
+/*===========================================================================*
+ *
+ * EXPORTED FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Check condition
+ * param[in]:   condition - checked condition
+ * param[in]:   text - condition as written in the test
+ * param[in]:   file - test file name
+ * param[in]:   line - line in test file
+ * param[out]:  None
+ * return:      bool - condition value
+ * details:     None
+ *===========================================================================*/
+bool Test_Check(bool condition, const char* text, const char* file, int line);
+
+/*===========================================================================*
+ * brief:       Check if float value is within tolerance of expected value
+ * param[in]:   value - checked value
+ * param[in]:   expected - expected value
+ * param[in]:   tolerance - allowed absolute difference
+ * param[in]:   text - checked expression as written in the test
+ * param[in]:   file - test file name
+ * param[in]:   line - line in test file
+ * param[out]:  None
+ * return:      bool - true if value is within tolerance
+ * details:     None
+ *===========================================================================*/
+bool Test_CheckFloat(float value, float expected, float tolerance, const char* text, const char* file, int line);
+
+/*===========================================================================*
+ * brief:       Run single test case
+ * param[in]:   test - test function
+ * param[in]:   name - test function name
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+void Test_Run(Test_Function_T test, const char* name);
+
+/*===========================================================================*
+ * brief:       Print summary of all test cases
+ * param[in]:   None
+ * param[out]:  None
+ * return:      int - process exit code, 0 when all checks passed
+ * details:     None
+ *===========================================================================*/
+int Test_Summary(void);
+
+
+#endif
+/* end of file */
@@ -0,0 +1,153 @@
+/*===========================================================================*
+ * File:        bench_fuel.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Processing time of the per event fuel calculation
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "test.h"
+
+#include "fakes.h"
+
+/* Module is included to reach its local functions */
+#include "../../Core/Src/speed_density.c"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+#define BENCH_EVENTS_NO                         (1000000U)
+/* Fastest run is reported, it's the least disturbed by the host */
+#define BENCH_RUNS_NO                           (10U)
+
+/* Filtered IAT differs slightly in every samples set, power of 2 */
+#define BENCH_IAT_VALUES_NO                     (1024U)
+#define BENCH_IAT_VALUES_MASK                   (BENCH_IAT_VALUES_NO - 1U)
+#define BENCH_IAT_NOISE_K                       (0.05F)
+
+#define BENCH_SPEED_RPM                         (3000.0F)
+#define BENCH_PRESSURE_KPA                      (60.0F)
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+static float bench_iat[BENCH_IAT_VALUES_NO];
+static float bench_iat_reciprocal[BENCH_IAT_VALUES_NO];
+
+/* Keeps the calculation from being optimized out */
+static volatile float bench_fuel_sink;
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+static void Bench_Setup(void);
+
+static void Bench_CalculateFuel(void);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: main
+ *===========================================================================*/
+int main(void)
+{
+    printf("bench_fuel\n");
+
+    TEST_RUN(Bench_CalculateFuel);
+
+    return Test_Summary();
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Bench_Setup
+ *===========================================================================*/
+static void Bench_Setup(void)
+{
+    uint32_t index;
+
+    Test_ResetPeripherals();
+    Fake_EnSensReset();
+    FuelTrim_Init();
+    CylTrim_Init();
+    InjMod_Init();
+    InjMod_Update();
+    WallWet_Init();
+    WallWet_Update(BENCH_SPEED_RPM);
+    SpDen_Init();
+
+    for (index = 0U; index < BENCH_IAT_VALUES_NO; index++)
+    {
+        bench_iat[index] = UTILS_CONVERT_C_TO_K(20.0F) +
+                           (BENCH_IAT_NOISE_K * (float)(int32_t)((index * 7U) % 9U - 4U));
+        bench_iat_reciprocal[index] = 1.0F / bench_iat[index];
+    }
+}
+
+/*===========================================================================*
+ * Function: Bench_CalculateFuel
+ *===========================================================================*/
+static void Bench_CalculateFuel(void)
+{
+    EnCon_CylinderChannels_T channel = ENCON_CHANNEL_1;
+    uint32_t timestamp;
+    uint32_t cycles;
+    uint32_t cyclesMin = UINT32_MAX;
+    uint32_t event;
+    uint32_t run;
+    float fuelMs = 0.0F;
+
+    Bench_Setup();
+    Test_SetTimestampMode(TEST_TIMESTAMP_MODE_HOST_CLOCK);
+
+    for (run = 0U; run < BENCH_RUNS_NO; run++)
+    {
+        timestamp = UTILS_GET_TIMESTAMP();
+
+        for (event = 0U; event < BENCH_EVENTS_NO; event++)
+        {
+            /* New samples set for every event, as with the filtered sensor at 10kHz */
+            fake_engine_sensors.iat = bench_iat[event & BENCH_IAT_VALUES_MASK];
+            fake_engine_sensors.iatReciprocal = bench_iat_reciprocal[event & BENCH_IAT_VALUES_MASK];
+
+            fuelMs += SpDen_CalculateFuel(BENCH_SPEED_RPM, BENCH_PRESSURE_KPA, channel);
+            channel = SPDEN_NEXT_CHANNEL(channel);
+        }
+
+        cycles = UTILS_GET_TIMESTAMP() - timestamp;
+        cyclesMin = (cycles < cyclesMin) ? cycles : cyclesMin;
+    }
+
+    bench_fuel_sink = fuelMs;
+
+    printf("    SpDen_CalculateFuel: %.1f ns per event (host, fastest of %u runs)\n",
+           (double)(UTILS_TIMESTAMP_TO_MS(cyclesMin) * 1000000.0F / (float)BENCH_EVENTS_NO), (unsigned)BENCH_RUNS_NO);
+
+    TEST_CHECK(fuelMs > 0.0F);
+}
+
+/* end of file */
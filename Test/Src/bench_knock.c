@@ -0,0 +1,334 @@
+/*===========================================================================*
+ * File:        bench_knock.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Knock detection quality and processing time on synthetic windows
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "test.h"
+
+#include "fakes.h"
+
+#include "math.h"
+
+/* Module is included to reach the learned background */
+#include "../../Core/Src/knock.c"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/* Knock sensor sampling with TPS and lambda channels enabled: 3 groups at 10kHz */
+#define BENCH_SAMPLING_FREQUENCY_HZ             (30000.0F)
+#define BENCH_WINDOW_SAMPLES                    (KNOCK_WINDOW_SAMPLES_MAX)
+
+#define BENCH_ADC_OFFSET                        (2048.0F)
+/* Sensor noise RMS in ADC codes */
+#define BENCH_NOISE_RMS                         (20.0F)
+/* Valve train and injector noise, far from the knock frequency */
+#define BENCH_MECHANICAL_AMPLITUDE              (40.0F)
+#define BENCH_MECHANICAL_FREQUENCY_HZ           (2200.0F)
+/* Knock ringing decays within a few ms */
+#define BENCH_KNOCK_DECAY_MS                    (1.0F)
+/* Frequency close to the knock band, e.g. other cylinder resonance */
+#define BENCH_OFF_BAND_FREQUENCY_HZ             (5000.0F)
+
+#define BENCH_WINDOWS_NO                        (2000U)
+/* Every n-th window contains knock */
+#define BENCH_KNOCK_WINDOW_PERIOD               (5U)
+
+#define BENCH_PI                                (3.14159265F)
+
+/*===========================================================================*
+ *
+ * LOCAL TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+typedef struct Bench_Result_Tag
+{
+    uint32_t knockWindows;
+    uint32_t detected;
+    uint32_t falseDetected;
+    float windowTimeUs;
+} Bench_Result_T;
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+static uint32_t bench_random_state;
+static float bench_samples[BENCH_WINDOW_SAMPLES];
+
+static const float bench_knock_amplitudes[] = { 10.0F, 20.0F, 40.0F, 80.0F, 160.0F };
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+static float Bench_RandomUniform(void);
+static float Bench_RandomNoise(void);
+static void Bench_GenerateWindow(float knockAmplitude, float knockFrequency);
+static void Bench_Learn(void);
+static Bench_Result_T Bench_Run(float knockAmplitude, float knockFrequency);
+
+static void Bench_Learning(void);
+static void Bench_NoKnock(void);
+static void Bench_KnockAtResonance(void);
+static void Bench_OffBandKnock(void);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: main
+ *===========================================================================*/
+int main(void)
+{
+    printf("bench_knock\n");
+
+    Fake_EnSensReset();
+    fake_engine_sensors.knockSamplingFrequency = BENCH_SAMPLING_FREQUENCY_HZ;
+    Test_SetTimestampMode(TEST_TIMESTAMP_MODE_HOST_CLOCK);
+
+    TEST_RUN(Bench_Learning);
+    TEST_RUN(Bench_NoKnock);
+    TEST_RUN(Bench_KnockAtResonance);
+    TEST_RUN(Bench_OffBandKnock);
+
+    return Test_Summary();
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Bench_RandomUniform
+ *===========================================================================*/
+static float Bench_RandomUniform(void)
+{
+    bench_random_state = (bench_random_state * 1664525U) + 1013904223U;
+
+    return (float)(bench_random_state >> 8) / (float)(1U << 24);
+}
+
+/*===========================================================================*
+ * Function: Bench_RandomNoise
+ *===========================================================================*/
+static float Bench_RandomNoise(void)
+{
+    float sum = 0.0F;
+    uint8_t index;
+
+    /* Sum of 12 uniform values has unit variance */
+    for (index = 0U; index < 12U; index++)
+    {
+        sum += Bench_RandomUniform();
+    }
+
+    return (sum - 6.0F) * BENCH_NOISE_RMS;
+}
+
+/*===========================================================================*
+ * Function: Bench_GenerateWindow
+ *===========================================================================*/
+static void Bench_GenerateWindow(float knockAmplitude, float knockFrequency)
+{
+    float mechanicalPhase;
+    float knockStart;
+    float time;
+    float knockTime;
+    uint16_t index;
+
+    mechanicalPhase = 2.0F * BENCH_PI * Bench_RandomUniform();
+    /* Knock starts in the first half of the window, after the spark */
+    knockStart = Bench_RandomUniform() * 0.5F * ((float)BENCH_WINDOW_SAMPLES / BENCH_SAMPLING_FREQUENCY_HZ);
+
+    for (index = 0U; index < BENCH_WINDOW_SAMPLES; index++)
+    {
+        time = (float)index / BENCH_SAMPLING_FREQUENCY_HZ;
+        bench_samples[index] = BENCH_ADC_OFFSET + Bench_RandomNoise() +
+                               (BENCH_MECHANICAL_AMPLITUDE *
+                                sinf((2.0F * BENCH_PI * BENCH_MECHANICAL_FREQUENCY_HZ * time) + mechanicalPhase));
+
+        if ((knockAmplitude > 0.0F) && (time >= knockStart))
+        {
+            knockTime = time - knockStart;
+            bench_samples[index] += knockAmplitude * expf(-(knockTime * 1000.0F) / BENCH_KNOCK_DECAY_MS) *
+                                    sinf(2.0F * BENCH_PI * knockFrequency * knockTime);
+        }
+
+        /* ADC codes are integers */
+        bench_samples[index] = floorf(bench_samples[index] + 0.5F);
+    }
+}
+
+/*===========================================================================*
+ * Function: Bench_Learn
+ *===========================================================================*/
+static void Bench_Learn(void)
+{
+    uint32_t window;
+
+    bench_random_state = 1U;
+    Knock_Init();
+
+    for (window = 0U; window < KNOCK_LEARNING_WINDOWS_NO; window++)
+    {
+        Bench_GenerateWindow(0.0F, 0.0F);
+        Knock_OnWindowCaptured(ENCON_CHANNEL_1, bench_samples, BENCH_WINDOW_SAMPLES);
+    }
+}
+
+/*===========================================================================*
+ * Function: Bench_Run
+ *===========================================================================*/
+static Bench_Result_T Bench_Run(float knockAmplitude, float knockFrequency)
+{
+    Bench_Result_T result = { 0U, 0U, 0U, 0.0F };
+    uint32_t processingTime = 0U;
+    uint32_t timestamp;
+    uint32_t window;
+    bool isKnock;
+    float retard;
+
+    Bench_Learn();
+
+    for (window = 0U; window < BENCH_WINDOWS_NO; window++)
+    {
+        isKnock = (knockAmplitude > 0.0F) && (0U == (window % BENCH_KNOCK_WINDOW_PERIOD));
+        Bench_GenerateWindow(isKnock ? knockAmplitude : 0.0F, knockFrequency);
+
+        retard = Knock_GetRetard(ENCON_CHANNEL_1);
+        timestamp = UTILS_GET_TIMESTAMP();
+        Knock_OnWindowCaptured(ENCON_CHANNEL_1, bench_samples, BENCH_WINDOW_SAMPLES);
+        processingTime += UTILS_GET_TIMESTAMP() - timestamp;
+
+        /* Retard step means window was detected as knock */
+        if ((Knock_GetRetard(ENCON_CHANNEL_1) > retard) ||
+            ((KNOCK_RETARD_MAX_ANGLE == retard) && (Knock_GetRetard(ENCON_CHANNEL_1) == retard)))
+        {
+            if (isKnock)
+            {
+                result.detected++;
+            }
+            else
+            {
+                result.falseDetected++;
+            }
+        }
+
+        result.knockWindows += isKnock ? 1U : 0U;
+    }
+
+    result.windowTimeUs = UTILS_TIMESTAMP_TO_MS(processingTime) * 1000.0F / (float)BENCH_WINDOWS_NO;
+
+    return result;
+}
+
+/*===========================================================================*
+ * Function: Bench_Learning
+ *===========================================================================*/
+static void Bench_Learning(void)
+{
+    uint32_t processingTime;
+    uint32_t timestamp;
+    float background;
+
+    timestamp = UTILS_GET_TIMESTAMP();
+    Bench_Learn();
+    processingTime = UTILS_GET_TIMESTAMP() - timestamp;
+
+    background = knock_cylinders[ENCON_CHANNEL_1].background;
+
+    printf("    learned background %.4f after %u windows, %.2f us per window (host, incl. signal synthesis)\n",
+           (double)background, (unsigned)KNOCK_LEARNING_WINDOWS_NO,
+           (double)(UTILS_TIMESTAMP_TO_MS(processingTime) * 1000.0F / (float)KNOCK_LEARNING_WINDOWS_NO));
+
+    TEST_CHECK(KNOCK_LEARNING_WINDOWS_NO == knock_cylinders[ENCON_CHANNEL_1].windowsNo);
+    TEST_CHECK(background > 0.0F);
+    /* No retard while learning */
+    TEST_CHECK(0.0F == Knock_GetRetard(ENCON_CHANNEL_1));
+}
+
+/*===========================================================================*
+ * Function: Bench_NoKnock
+ *===========================================================================*/
+static void Bench_NoKnock(void)
+{
+    Bench_Result_T result;
+
+    result = Bench_Run(0.0F, 0.0F);
+
+    printf("    no knock: %u/%u false detections, %.2f us per window (host)\n", (unsigned)result.falseDetected,
+           (unsigned)BENCH_WINDOWS_NO, (double)result.windowTimeUs);
+
+    TEST_CHECK(result.falseDetected <= (BENCH_WINDOWS_NO / 200U));
+    TEST_CHECK(Knock_GetRetard(ENCON_CHANNEL_1) < KNOCK_RETARD_STEP_ANGLE);
+}
+
+/*===========================================================================*
+ * Function: Bench_KnockAtResonance
+ *===========================================================================*/
+static void Bench_KnockAtResonance(void)
+{
+    Bench_Result_T result;
+    uint32_t index;
+
+    printf("    %10s %10s %10s %10s\n", "amplitude", "detected", "false", "us/window");
+
+    for (index = 0U; index < (sizeof(bench_knock_amplitudes) / sizeof(bench_knock_amplitudes[0])); index++)
+    {
+        result = Bench_Run(bench_knock_amplitudes[index], KNOCK_FREQUENCY_HZ);
+
+        printf("    %10.0f %9.1f%% %9.1f%% %10.2f\n", (double)bench_knock_amplitudes[index],
+               (double)(100.0F * (float)result.detected / (float)result.knockWindows),
+               (double)(100.0F * (float)result.falseDetected / (float)(BENCH_WINDOWS_NO - result.knockWindows)),
+               (double)result.windowTimeUs);
+
+        /* Knock well above the noise floor is always detected */
+        if (bench_knock_amplitudes[index] >= (4.0F * BENCH_NOISE_RMS))
+        {
+            TEST_CHECK(result.detected >= ((result.knockWindows * 95U) / 100U));
+        }
+
+        TEST_CHECK(result.falseDetected <= (BENCH_WINDOWS_NO / 100U));
+    }
+}
+
+/*===========================================================================*
+ * Function: Bench_OffBandKnock
+ *===========================================================================*/
+static void Bench_OffBandKnock(void)
+{
+    Bench_Result_T result;
+
+    result = Bench_Run(4.0F * BENCH_NOISE_RMS, BENCH_OFF_BAND_FREQUENCY_HZ);
+
+    printf("    %.0fHz ringing of knock amplitude: %.1f%% detected\n", (double)BENCH_OFF_BAND_FREQUENCY_HZ,
+           (double)(100.0F * (float)result.detected / (float)result.knockWindows));
+
+    /* Goertzel main lobe is 2 * fs / N wide, 5kHz is far outside */
+    TEST_CHECK(result.detected <= (result.knockWindows / 20U));
+}
+
+/* end of file */
@@ -0,0 +1,233 @@
+/*===========================================================================*
+ * File:        bench_spark.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Processing time of the ignition event spark calculation
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "test.h"
+
+#include "fakes.h"
+
+/* Module is included to reach its local functions */
+#include "../../Core/Src/speed_density.c"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+#define BENCH_EVENTS_NO                         (1000000U)
+/* Fastest run is reported, it's the least disturbed by the host */
+#define BENCH_RUNS_NO                           (10U)
+
+/* Operating points change every event, so the table lookups can't be cached by the host */
+#define BENCH_POINTS_NO                         (1024U)
+#define BENCH_POINTS_MASK                       (BENCH_POINTS_NO - 1U)
+
+/*===========================================================================*
+ *
+ * LOCAL TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+typedef enum Bench_SparkPath_Tag
+{
+    /* Ignition event reads the advance cached once per engine cycle */
+    BENCH_SPARK_PATH_CACHED,
+    /* Cache update, amortized over the cylinder events of the cycle */
+    BENCH_SPARK_PATH_CYCLE_UPDATE,
+    /* All tables are read at every ignition event */
+    BENCH_SPARK_PATH_UNCACHED,
+
+    BENCH_SPARK_PATH_COUNT
+} Bench_SparkPath_T;
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+static float bench_speeds[BENCH_POINTS_NO];
+static float bench_pressures[BENCH_POINTS_NO];
+
+static const char* const bench_path_names[BENCH_SPARK_PATH_COUNT] =
+{
+    "cached advance per event",
+    "cycle update per event",
+    "uncached per event"
+};
+
+/* Keeps the calculation from being optimized out */
+static volatile float bench_spark_sink;
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+static void Bench_Setup(void);
+static float Bench_Run(Bench_SparkPath_T path, float* sparkSum);
+
+static void Bench_CalculateSpark(void);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: main
+ *===========================================================================*/
+int main(void)
+{
+    printf("bench_spark\n");
+
+    TEST_RUN(Bench_CalculateSpark);
+
+    return Test_Summary();
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Bench_Setup
+ *===========================================================================*/
+static void Bench_Setup(void)
+{
+    uint32_t index;
+
+    Test_ResetPeripherals();
+    Fake_EnSensReset();
+    CylTrim_Init();
+    Knock_Init();
+    RevLim_Init();
+    SpDen_Init();
+
+    SpDen_EnterEngineState(SPDEN_ENGINE_STATE_RUNING);
+    spden_engine_state = SPDEN_ENGINE_STATE_RUNING;
+
+    for (index = 0U; index < BENCH_POINTS_NO; index++)
+    {
+        bench_speeds[index] = 1000.0F + (float)((index * 37U) % 5000U);
+        bench_pressures[index] = 30.0F + (float)((index * 13U) % 70U);
+    }
+
+    CylTrim_Update(bench_speeds[0], bench_pressures[0]);
+    SpDen_UpdateSparkAdvances(bench_speeds[0], bench_pressures[0]);
+}
+
+/*===========================================================================*
+ * Function: Bench_Run
+ *===========================================================================*/
+static float Bench_Run(Bench_SparkPath_T path, float* sparkSum)
+{
+    EnCon_CylinderChannels_T channel = ENCON_CHANNEL_1;
+    uint32_t timestamp;
+    uint32_t cycles;
+    uint32_t cyclesMin = UINT32_MAX;
+    uint32_t event;
+    uint32_t run;
+    uint32_t point;
+    float spark = 0.0F;
+
+    for (run = 0U; run < BENCH_RUNS_NO; run++)
+    {
+        timestamp = UTILS_GET_TIMESTAMP();
+
+        for (event = 0U; event < BENCH_EVENTS_NO; event++)
+        {
+            point = event & BENCH_POINTS_MASK;
+
+            switch (path)
+            {
+                case BENCH_SPARK_PATH_CACHED:
+                    spark += SpDen_CalculateSpark(bench_speeds[point], channel);
+                    break;
+
+                case BENCH_SPARK_PATH_CYCLE_UPDATE:
+                    if (ENCON_CHANNEL_1 == channel)
+                    {
+                        SpDen_UpdateSparkAdvances(bench_speeds[point], bench_pressures[point]);
+                    }
+                    spark += spden_spark_advances[channel];
+                    break;
+
+                default:
+                    SpDen_UpdateSparkAdvances(bench_speeds[point], bench_pressures[point]);
+                    spark += SpDen_CalculateSpark(bench_speeds[point], channel);
+                    break;
+            }
+
+            channel = SPDEN_NEXT_CHANNEL(channel);
+        }
+
+        cycles = UTILS_GET_TIMESTAMP() - timestamp;
+        cyclesMin = (cycles < cyclesMin) ? cycles : cyclesMin;
+    }
+
+    *sparkSum = spark;
+
+    return UTILS_TIMESTAMP_TO_MS(cyclesMin) * 1000000.0F / (float)BENCH_EVENTS_NO;
+}
+
+/*===========================================================================*
+ * Function: Bench_CalculateSpark
+ *===========================================================================*/
+static void Bench_CalculateSpark(void)
+{
+    Bench_SparkPath_T path;
+    float eventTimeNs[BENCH_SPARK_PATH_COUNT];
+    float sparkSum;
+    float sparkAngle;
+    float expectedAdvance;
+
+    Bench_Setup();
+    Test_SetTimestampMode(TEST_TIMESTAMP_MODE_HOST_CLOCK);
+
+    for (path = BENCH_SPARK_PATH_CACHED; path < BENCH_SPARK_PATH_COUNT; path++)
+    {
+        eventTimeNs[path] = Bench_Run(path, &sparkSum);
+        bench_spark_sink = sparkSum;
+
+        printf("    %-26s %.1f ns (host, fastest of %u runs)\n", bench_path_names[path], (double)eventTimeNs[path],
+               (unsigned)BENCH_RUNS_NO);
+    }
+
+    printf("    cached path saves %.1f%% of the ignition event calculation\n",
+           (double)(100.0F * (1.0F - (eventTimeNs[BENCH_SPARK_PATH_CACHED] /
+                                      eventTimeNs[BENCH_SPARK_PATH_UNCACHED]))));
+
+    /* Cached advance gives the same spark as the tables read at the event */
+    SpDen_UpdateSparkAdvances(bench_speeds[1], bench_pressures[1]);
+    sparkAngle = SpDen_CalculateSpark(bench_speeds[1], ENCON_CHANNEL_2);
+
+    expectedAdvance = Tables_Get3DTableValue(TABLES_3D_SPARK, bench_speeds[1], bench_pressures[1]) +
+                      Tables_Get2DTableValue(TABLES_2D_SPARK_CLT_CORRECTION,
+                                             UTILS_CONVERT_K_TO_C(fake_engine_sensors.cltTemperature)) +
+                      Tables_Get2DTableValue(TABLES_2D_SPARK_IAT_CORRECTION,
+                                             UTILS_CONVERT_K_TO_C(fake_engine_sensors.iat)) +
+                      CylTrim_GetSparkAdvance(ENCON_CHANNEL_2);
+
+    TEST_CHECK_FLOAT(sparkAngle, UTILS_CIRCULAR_DIFFERENCE(spden_work_tdc_angles[ENCON_CHANNEL_2], expectedAdvance,
+                                                           ENCON_ENGINE_FULL_CYCLE_ANGLE),
+                     0.001F);
+    TEST_CHECK(eventTimeNs[BENCH_SPARK_PATH_CACHED] > 0.0F);
+}
+
+/* end of file */
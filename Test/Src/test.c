@@ -0,0 +1,100 @@
+/*===========================================================================*
+ * File:        test.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Minimal host test framework
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "test.h"
+
+#include "math.h"
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+static uint32_t test_checks_count = 0U;
+static uint32_t test_failures_count = 0U;
+static uint32_t test_cases_count = 0U;
+static uint32_t test_failed_cases_count = 0U;
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Test_Check
+ *===========================================================================*/
+bool Test_Check(bool condition, const char* text, const char* file, int line)
+{
+    test_checks_count++;
+
+    if (condition == false)
+    {
+        test_failures_count++;
+        printf("    FAIL %s:%d: %s\n", file, line, text);
+    }
+
+    return condition;
+}
+
+/*===========================================================================*
+ * Function: Test_CheckFloat
+ *===========================================================================*/
+bool Test_CheckFloat(float value, float expected, float tolerance, const char* text, const char* file, int line)
+{
+    bool result = (fabsf(value - expected) <= tolerance);
+
+    test_checks_count++;
+
+    if (result == false)
+    {
+        test_failures_count++;
+        printf("    FAIL %s:%d: %s = %f, expected %f +/- %f\n", file, line, text, (double)value,
+               (double)expected, (double)tolerance);
+    }
+
+    return result;
+}
+
+/*===========================================================================*
+ * Function: Test_Run
+ *===========================================================================*/
+void Test_Run(Test_Function_T test, const char* name)
+{
+    uint32_t failuresBefore = test_failures_count;
+
+    printf("  %s\n", name);
+    test();
+
+    test_cases_count++;
+
+    if (test_failures_count != failuresBefore)
+    {
+        test_failed_cases_count++;
+    }
+}
+
+/*===========================================================================*
+ * Function: Test_Summary
+ *===========================================================================*/
+int Test_Summary(void)
+{
+    printf("  %u/%u cases passed, %u/%u checks failed\n", (unsigned)(test_cases_count - test_failed_cases_count),
+           (unsigned)test_cases_count, (unsigned)test_failures_count, (unsigned)test_checks_count);
+
+    return (test_failures_count == 0U) ? 0 : 1;
+}
+
+/* end of file */
@@ -0,0 +1,246 @@
+/*===========================================================================*
+ * File:        test_accel_enrichment.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Acceleration enrichment profile simulated with MAP steps
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "test.h"
+
+#include "fakes.h"
+
+/* Module is included to reach its local functions */
+#include "../../Core/Src/speed_density.c"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+#define TEST_SPEED_RPM                          (3000.0F)
+/* Engine cycle is two revolutions */
+#define TEST_CYCLE_MS                           ((2.0F * 60000.0F) / TEST_SPEED_RPM)
+/* One MAP sample per injection event */
+#define TEST_EVENT_MS                           (TEST_CYCLE_MS / (float)ENCON_ENGINE_PISTONS_NO)
+
+#define TEST_IDLE_PRESSURE                      (30.0F)
+#define TEST_WOT_PRESSURE                       (90.0F)
+
+/* Engine cycles simulated before the step, so the history is full */
+#define TEST_STEADY_CYCLES                      (2U)
+#define TEST_EVENTS_NO                          ((TEST_STEADY_CYCLES + SPDEN_ACCEL_ENRICHMENT_DECAY_CYCLES + 2U) *   \
+                                                 ENCON_ENGINE_PISTONS_NO)
+#define TEST_STEP_EVENT                         (TEST_STEADY_CYCLES * ENCON_ENGINE_PISTONS_NO)
+
+#define TEST_ENRICHMENT_TOLERANCE               (0.001F)
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+static void Test_Setup(SpDen_EngineState_T state);
+static float Test_Event(uint32_t event, float pressure);
+
+static void Test_MapStepProfile(void);
+static void Test_MapRampGivesLowerPeak(void);
+static void Test_MapDecreaseIsNotEnriched(void);
+static void Test_CrankingIsNotEnriched(void);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: main
+ *===========================================================================*/
+int main(void)
+{
+    printf("test_accel_enrichment\n");
+
+    TEST_RUN(Test_MapStepProfile);
+    TEST_RUN(Test_MapRampGivesLowerPeak);
+    TEST_RUN(Test_MapDecreaseIsNotEnriched);
+    TEST_RUN(Test_CrankingIsNotEnriched);
+
+    return Test_Summary();
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Test_Setup
+ *===========================================================================*/
+static void Test_Setup(SpDen_EngineState_T state)
+{
+    Test_ResetPeripherals();
+    Test_SetTimestampMode(TEST_TIMESTAMP_MODE_MANUAL);
+    Fake_EnSensReset();
+    SpDen_Init();
+
+    SpDen_EnterEngineState(state);
+    spden_engine_state = state;
+}
+
+/*===========================================================================*
+ * Function: Test_Event
+ *===========================================================================*/
+static float Test_Event(uint32_t event, float pressure)
+{
+    Test_SetTimeMs((float)event * TEST_EVENT_MS);
+    SpDen_UpdateAccelEnrichment(TEST_SPEED_RPM, pressure);
+
+    return spden_accel_enrichment.enrichment;
+}
+
+/*===========================================================================*
+ * Function: Test_MapStepProfile
+ *===========================================================================*/
+static void Test_MapStepProfile(void)
+{
+    float enrichment;
+    float peak;
+    float decayStep;
+    float pressure;
+    uint32_t decayEvents;
+    uint32_t event;
+
+    Test_Setup(SPDEN_ENGINE_STATE_RUNING);
+
+    /* Step is seen against the sample one engine cycle before */
+    peak = Tables_Get3DTableValue(TABLES_3D_ACCEL_ENRICHMENT, TEST_SPEED_RPM,
+                                  ((TEST_WOT_PRESSURE - TEST_IDLE_PRESSURE) * 1000.0F) / TEST_CYCLE_MS);
+    decayEvents = SPDEN_ACCEL_ENRICHMENT_DECAY_CYCLES * ENCON_ENGINE_PISTONS_NO;
+    decayStep = peak / (float)decayEvents;
+
+    TEST_CHECK(peak > 0.0F);
+
+    printf("    %6s %8s %12s\n", "event", "MAP kPa", "enrich. %");
+
+    for (event = 0U; event < TEST_EVENTS_NO; event++)
+    {
+        pressure = (event < TEST_STEP_EVENT) ? TEST_IDLE_PRESSURE : TEST_WOT_PRESSURE;
+        enrichment = Test_Event(event, pressure);
+
+        printf("    %6u %8.1f %12.3f\n", (unsigned)event, (double)pressure, (double)enrichment);
+
+        if (event < TEST_STEP_EVENT)
+        {
+            TEST_CHECK_FLOAT(enrichment, 0.0F, TEST_ENRICHMENT_TOLERANCE);
+        }
+        else if (event < (TEST_STEP_EVENT + SPDEN_MAP_DERIVATIVE_SAMPLES))
+        {
+            /* Sample one cycle before is still below the step, so the peak is held for one cycle */
+            TEST_CHECK_FLOAT(enrichment, peak, TEST_ENRICHMENT_TOLERANCE);
+        }
+        else if (event < (TEST_STEP_EVENT + SPDEN_MAP_DERIVATIVE_SAMPLES + decayEvents))
+        {
+            /* Linear decay over SPDEN_ACCEL_ENRICHMENT_DECAY_CYCLES engine cycles */
+            TEST_CHECK_FLOAT(enrichment,
+                             peak - (decayStep *
+                                     (float)(event - TEST_STEP_EVENT - SPDEN_MAP_DERIVATIVE_SAMPLES + 1U)),
+                             TEST_ENRICHMENT_TOLERANCE);
+        }
+        else
+        {
+            TEST_CHECK_FLOAT(enrichment, 0.0F, TEST_ENRICHMENT_TOLERANCE);
+        }
+    }
+}
+
+/*===========================================================================*
+ * Function: Test_MapRampGivesLowerPeak
+ *===========================================================================*/
+static void Test_MapRampGivesLowerPeak(void)
+{
+    float stepPeak = 0.0F;
+    float rampPeak = 0.0F;
+    float enrichment;
+    float pressure;
+    float rampEvents;
+    uint32_t event;
+
+    Test_Setup(SPDEN_ENGINE_STATE_RUNING);
+
+    for (event = 0U; event < TEST_EVENTS_NO; event++)
+    {
+        pressure = (event < TEST_STEP_EVENT) ? TEST_IDLE_PRESSURE : TEST_WOT_PRESSURE;
+        enrichment = Test_Event(event, pressure);
+        stepPeak = (enrichment > stepPeak) ? enrichment : stepPeak;
+    }
+
+    Test_Setup(SPDEN_ENGINE_STATE_RUNING);
+
+    /* Same pressure change spread over 3 engine cycles */
+    rampEvents = (float)(3U * ENCON_ENGINE_PISTONS_NO);
+
+    for (event = 0U; event < TEST_EVENTS_NO; event++)
+    {
+        pressure = TEST_IDLE_PRESSURE;
+
+        if (event >= TEST_STEP_EVENT)
+        {
+            pressure += (TEST_WOT_PRESSURE - TEST_IDLE_PRESSURE) * ((float)(event - TEST_STEP_EVENT) / rampEvents);
+            pressure = (pressure > TEST_WOT_PRESSURE) ? TEST_WOT_PRESSURE : pressure;
+        }
+
+        enrichment = Test_Event(event, pressure);
+        rampPeak = (enrichment > rampPeak) ? enrichment : rampPeak;
+    }
+
+    printf("    step peak %.2f%%, 3 cycles ramp peak %.2f%%\n", (double)stepPeak, (double)rampPeak);
+
+    TEST_CHECK(rampPeak > 0.0F);
+    TEST_CHECK(rampPeak < stepPeak);
+}
+
+/*===========================================================================*
+ * Function: Test_MapDecreaseIsNotEnriched
+ *===========================================================================*/
+static void Test_MapDecreaseIsNotEnriched(void)
+{
+    float pressure;
+    uint32_t event;
+
+    Test_Setup(SPDEN_ENGINE_STATE_RUNING);
+
+    for (event = 0U; event < TEST_EVENTS_NO; event++)
+    {
+        pressure = (event < TEST_STEP_EVENT) ? TEST_WOT_PRESSURE : TEST_IDLE_PRESSURE;
+        TEST_CHECK_FLOAT(Test_Event(event, pressure), 0.0F, TEST_ENRICHMENT_TOLERANCE);
+    }
+}
+
+/*===========================================================================*
+ * Function: Test_CrankingIsNotEnriched
+ *===========================================================================*/
+static void Test_CrankingIsNotEnriched(void)
+{
+    float pressure;
+    uint32_t event;
+
+    Test_Setup(SPDEN_ENGINE_STATE_CRANKING);
+
+    for (event = 0U; event < TEST_EVENTS_NO; event++)
+    {
+        pressure = (event < TEST_STEP_EVENT) ? TEST_IDLE_PRESSURE : TEST_WOT_PRESSURE;
+        TEST_CHECK_FLOAT(Test_Event(event, pressure), 0.0F, TEST_ENRICHMENT_TOLERANCE);
+    }
+}
+
+/* end of file */
@@ -0,0 +1,281 @@
+/*===========================================================================*
+ * File:        test_engine_state.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Engine start states sequence with prime pulse and idle stumble
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "test.h"
+
+#include "fakes.h"
+
+/* Module is included to reach its local functions */
+#include "../../Core/Src/speed_density.c"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+#define TEST_US_IN_MINUTE                       (60000000.0F)
+#define TEST_SPEED_RAW(_RPM_)                   ((uint32_t)((TEST_US_IN_MINUTE /                               \
+                                                             ((_RPM_) * ENCON_TRIGGER_WHEEL_TEETH_NO)) + 0.5F))
+
+#define TEST_CRANKING_SPEED_RPM                 (250.0F)
+#define TEST_IDLE_SPEED_RPM                     (900.0F)
+/* Idle stumble below the running floor */
+#define TEST_STUMBLE_SPEED_RPM                  (350.0F)
+
+#define TEST_WARM_UP_ENRICHMENT                 (10.0F)
+
+/* Limit of cycles waiting for a state change */
+#define TEST_CYCLES_MAX                         (1000U)
+
+/* Engine angles before and after the cycle beggining */
+#define TEST_CYCLE_END_ANGLE                    (700.0F)
+#define TEST_CYCLE_START_ANGLE                  (10.0F)
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+static void Test_Setup(void);
+static void Test_Update(float speed, float angle);
+static void Test_Cycle(float speed);
+static void Test_InjectAll(void);
+static void Test_RunUntilState(SpDen_EngineState_T state, float speed);
+static void Test_StartToRunning(void);
+
+static void Test_PrimeWaitsForAngle(void);
+static void Test_PrimeLastsUntilAllPulses(void);
+static void Test_StumbleSkipsAfterStart(void);
+static void Test_StumbleWithColdEngine(void);
+static void Test_StopRestartsSequence(void);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: main
+ *===========================================================================*/
+int main(void)
+{
+    printf("test_engine_state\n");
+
+    TEST_RUN(Test_PrimeWaitsForAngle);
+    TEST_RUN(Test_PrimeLastsUntilAllPulses);
+    TEST_RUN(Test_StumbleSkipsAfterStart);
+    TEST_RUN(Test_StumbleWithColdEngine);
+    TEST_RUN(Test_StopRestartsSequence);
+
+    return Test_Summary();
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Test_Setup
+ *===========================================================================*/
+static void Test_Setup(void)
+{
+    Test_ResetPeripherals();
+    Fake_EnSensReset();
+    FuelTrim_Init();
+    CylTrim_Init();
+    InjMod_Init();
+    InjMod_Update();
+    WallWet_Init();
+    SpDen_Init();
+
+    EnCon_UpdateEngineSpeed(ENCON_SPEED_RAW_UNKNOWN);
+    EnCon_UpdateEngineAngle(ENCON_ANGLE_UNKNOWN);
+    SpDen_CheckCurrentEngineState();
+}
+
+/*===========================================================================*
+ * Function: Test_Update
+ *===========================================================================*/
+static void Test_Update(float speed, float angle)
+{
+    EnCon_UpdateEngineSpeed(TEST_SPEED_RAW(speed));
+    EnCon_UpdateEngineAngle(angle);
+    SpDen_CheckCurrentEngineState();
+}
+
+/*===========================================================================*
+ * Function: Test_Cycle
+ *===========================================================================*/
+static void Test_Cycle(float speed)
+{
+    Test_Update(speed, TEST_CYCLE_END_ANGLE);
+    Test_Update(speed, TEST_CYCLE_START_ANGLE);
+}
+
+/*===========================================================================*
+ * Function: Test_InjectAll
+ *===========================================================================*/
+static void Test_InjectAll(void)
+{
+    EnCon_CylinderChannels_T channel;
+
+    for (channel = ENCON_CHANNEL_1; channel < ENCON_CHANNEL_COUNT; channel++)
+    {
+        (void)SpDen_CalculateFuel(TEST_CRANKING_SPEED_RPM, fake_engine_sensors.map, channel);
+    }
+}
+
+/*===========================================================================*
+ * Function: Test_RunUntilState
+ *===========================================================================*/
+static void Test_RunUntilState(SpDen_EngineState_T state, float speed)
+{
+    uint32_t cycle;
+
+    for (cycle = 0U; (cycle < TEST_CYCLES_MAX) && (state != spden_engine_state); cycle++)
+    {
+        Test_InjectAll();
+        Test_Cycle(speed);
+    }
+
+    TEST_CHECK(state == spden_engine_state);
+}
+
+/*===========================================================================*
+ * Function: Test_StartToRunning
+ *===========================================================================*/
+static void Test_StartToRunning(void)
+{
+    Test_Update(TEST_CRANKING_SPEED_RPM, TEST_CYCLE_START_ANGLE);
+    TEST_CHECK(SPDEN_ENGINE_STATE_PRIME == spden_engine_state);
+
+    Test_RunUntilState(SPDEN_ENGINE_STATE_CRANKING, TEST_CRANKING_SPEED_RPM);
+    Test_RunUntilState(SPDEN_ENGINE_STATE_AFTER_START, TEST_IDLE_SPEED_RPM);
+    Test_RunUntilState(SPDEN_ENGINE_STATE_RUNING, TEST_IDLE_SPEED_RPM);
+}
+
+/*===========================================================================*
+ * Function: Test_PrimeWaitsForAngle
+ *===========================================================================*/
+static void Test_PrimeWaitsForAngle(void)
+{
+    Test_Setup();
+
+    /* Speed is known after a few teeth, angle only after the synchronization */
+    EnCon_UpdateEngineSpeed(TEST_SPEED_RAW(TEST_CRANKING_SPEED_RPM));
+    SpDen_CheckCurrentEngineState();
+
+    TEST_CHECK(SPDEN_ENGINE_STATE_NOT_RUNNING == spden_engine_state);
+    TEST_CHECK(0U == spden_engine_state_data.primePendingMask);
+
+    Test_Update(TEST_CRANKING_SPEED_RPM, TEST_CYCLE_START_ANGLE);
+
+    TEST_CHECK(SPDEN_ENGINE_STATE_PRIME == spden_engine_state);
+    TEST_CHECK(((1UL << ENCON_CHANNEL_COUNT) - 1U) == spden_engine_state_data.primePendingMask);
+}
+
+/*===========================================================================*
+ * Function: Test_PrimeLastsUntilAllPulses
+ *===========================================================================*/
+static void Test_PrimeLastsUntilAllPulses(void)
+{
+    float primedMs;
+    float fuelMs;
+    EnCon_CylinderChannels_T channel;
+
+    Test_Setup();
+    Test_Update(TEST_CRANKING_SPEED_RPM, TEST_CYCLE_START_ANGLE);
+
+    /* Only the first cylinder had its injection event before the cycle end */
+    primedMs = SpDen_CalculateFuel(TEST_CRANKING_SPEED_RPM, fake_engine_sensors.map, ENCON_CHANNEL_1);
+    Test_Cycle(TEST_CRANKING_SPEED_RPM);
+    Test_Cycle(TEST_CRANKING_SPEED_RPM);
+
+    TEST_CHECK(SPDEN_ENGINE_STATE_PRIME == spden_engine_state);
+
+    for (channel = ENCON_CHANNEL_2; channel < ENCON_CHANNEL_COUNT; channel++)
+    {
+        fuelMs = SpDen_CalculateFuel(TEST_CRANKING_SPEED_RPM, fake_engine_sensors.map, channel);
+        /* Film is not updated, so every cylinder gets the same fuel with the prime pulse */
+        TEST_CHECK_FLOAT(fuelMs, primedMs, 0.001F);
+    }
+
+    TEST_CHECK(0U == spden_engine_state_data.primePendingMask);
+
+    Test_Cycle(TEST_CRANKING_SPEED_RPM);
+
+    TEST_CHECK(SPDEN_ENGINE_STATE_CRANKING == spden_engine_state);
+}
+
+/*===========================================================================*
+ * Function: Test_StumbleSkipsAfterStart
+ *===========================================================================*/
+static void Test_StumbleSkipsAfterStart(void)
+{
+    Test_Setup();
+    Test_StartToRunning();
+
+    Test_Cycle(TEST_STUMBLE_SPEED_RPM);
+    TEST_CHECK(SPDEN_ENGINE_STATE_CRANKING == spden_engine_state);
+
+    Test_Cycle(TEST_IDLE_SPEED_RPM);
+    TEST_CHECK(SPDEN_ENGINE_STATE_RUNING == spden_engine_state);
+    TEST_CHECK(0.0F == spden_engine_state_data.enrichment);
+}
+
+/*===========================================================================*
+ * Function: Test_StumbleWithColdEngine
+ *===========================================================================*/
+static void Test_StumbleWithColdEngine(void)
+{
+    Test_Setup();
+    fake_engine_sensors.cltEnrichment = TEST_WARM_UP_ENRICHMENT;
+
+    Test_Update(TEST_CRANKING_SPEED_RPM, TEST_CYCLE_START_ANGLE);
+    Test_RunUntilState(SPDEN_ENGINE_STATE_CRANKING, TEST_CRANKING_SPEED_RPM);
+    Test_RunUntilState(SPDEN_ENGINE_STATE_AFTER_START, TEST_IDLE_SPEED_RPM);
+    Test_RunUntilState(SPDEN_ENGINE_STATE_WARM_UP, TEST_IDLE_SPEED_RPM);
+
+    Test_Cycle(TEST_STUMBLE_SPEED_RPM);
+    TEST_CHECK(SPDEN_ENGINE_STATE_CRANKING == spden_engine_state);
+
+    /* Warm up enrichment continues, without the after start part */
+    Test_Cycle(TEST_IDLE_SPEED_RPM);
+    TEST_CHECK(SPDEN_ENGINE_STATE_WARM_UP == spden_engine_state);
+    TEST_CHECK_FLOAT(spden_engine_state_data.enrichment, TEST_WARM_UP_ENRICHMENT, 0.0001F);
+}
+
+/*===========================================================================*
+ * Function: Test_StopRestartsSequence
+ *===========================================================================*/
+static void Test_StopRestartsSequence(void)
+{
+    Test_Setup();
+    Test_StartToRunning();
+
+    EnCon_UpdateEngineSpeed(ENCON_SPEED_RAW_UNKNOWN);
+    EnCon_UpdateEngineAngle(ENCON_ANGLE_UNKNOWN);
+    SpDen_CheckCurrentEngineState();
+    TEST_CHECK(SPDEN_ENGINE_STATE_NOT_RUNNING == spden_engine_state);
+
+    /* Restart gets the prime pulse and the after start enrichment again */
+    Test_StartToRunning();
+}
+
+/* end of file */
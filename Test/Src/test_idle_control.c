@@ -0,0 +1,393 @@
+/*===========================================================================*
+ * File:        test_idle_control.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Idle air and spark loops closed around a simple engine torque model
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "test.h"
+
+#include "fakes.h"
+
+/* Module is included to reach its local values */
+#include "../../Core/Src/idle_control.c"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+#define TEST_US_IN_MINUTE                       (60000000.0F)
+#define TEST_SPEED_RAW(_RPM_)                   ((uint32_t)((TEST_US_IN_MINUTE /                               \
+                                                             ((_RPM_) * ENCON_TRIGGER_WHEEL_TEETH_NO)) + 0.5F))
+
+/* Simulation step, the air loop runs every IDLE_UPDATE_PERIOD_MS of it */
+#define TEST_STEP_MS                            (1.0F)
+#define TEST_SETTLE_MS                          (10000.0F)
+
+/* Torque of the throttle leak and of the valve, base duty gives idle below the target */
+#define TEST_LEAK_TORQUE                        (2.0F)
+#define TEST_TORQUE_PER_DUTY                    (8.0F / 30.0F)
+/* Manifold filling delays the valve change */
+#define TEST_AIR_TAU_MS                         (150.0F)
+/* Idle spark has a margin to MBT, torque changes by 2% per degree */
+#define TEST_TORQUE_PER_SPARK_DEGREE            (0.02F)
+/* Friction and pumping losses grow with speed */
+#define TEST_LOAD_TORQUE                        (1.5F)
+#define TEST_LOAD_TORQUE_PER_RPM                (0.01F)
+/* Alternator or A/C compressor switched on */
+#define TEST_LOAD_STEP_TORQUE                   (3.0F)
+/* Engine and flywheel inertia, 0.15kgm2 */
+#define TEST_RPM_PER_TORQUE_S                   (60.0F)
+
+/* Speed the engine runs at with base duty, without any control */
+#define TEST_OPEN_LOOP_SPEED_RPM                (850.0F)
+
+#define TEST_SPEED_TOLERANCE_RPM                (10.0F)
+#define TEST_SPARK_TOLERANCE_DEGREE             (0.5F)
+/* Speed dip after the load step */
+#define TEST_LOAD_STEP_DIP_MAX_RPM              (200.0F)
+
+/* Low speed drive under load, inside the idle speed window */
+#define TEST_LOAD_SPEED_RPM                     (1200.0F)
+#define TEST_LOAD_PRESSURE                      (85.0F)
+#define TEST_COLD_COOLANT_TEMP                  (-20.0F)
+
+/*===========================================================================*
+ *
+ * LOCAL TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+typedef struct Test_Engine_Tag
+{
+    float speed;
+    /* Valve duty after the manifold filling lag */
+    float airDuty;
+    float loadTorque;
+    /* Spark correction is calculated for every ignition event */
+    float sparkCorrection;
+    float eventAngle;
+    /* Spark torque is not modelled, to compare with the air loop alone */
+    bool isSparkModelled;
+    float timeMs;
+} Test_Engine_T;
+
+typedef struct Test_Result_Tag
+{
+    float minSpeed;
+    float maxSpeed;
+    float finalSpeed;
+    float finalSparkCorrection;
+} Test_Result_T;
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+static void Test_Setup(Test_Engine_T* engine, bool isSparkModelled);
+static float Test_GetValveDuty(void);
+static float Test_GetBaseDuty(void);
+static void Test_Step(Test_Engine_T* engine);
+static Test_Result_T Test_Simulate(Test_Engine_T* engine, float durationMs);
+
+static void Test_SpeedSettlesAtTarget(void);
+static void Test_LoadStepRecovers(void);
+static void Test_SparkLoopReducesDip(void);
+static void Test_OpenThrottleDisablesIdle(void);
+static void Test_LoadAtLowSpeedDisablesIdle(void);
+static void Test_InitDutyIsFixed(void);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: main
+ *===========================================================================*/
+int main(void)
+{
+    printf("test_idle_control\n");
+
+    TEST_RUN(Test_SpeedSettlesAtTarget);
+    TEST_RUN(Test_LoadStepRecovers);
+    TEST_RUN(Test_SparkLoopReducesDip);
+    TEST_RUN(Test_OpenThrottleDisablesIdle);
+    TEST_RUN(Test_LoadAtLowSpeedDisablesIdle);
+    TEST_RUN(Test_InitDutyIsFixed);
+
+    return Test_Summary();
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Test_Setup
+ *===========================================================================*/
+static void Test_Setup(Test_Engine_T* engine, bool isSparkModelled)
+{
+    Test_ResetPeripherals();
+    Test_SetTimestampMode(TEST_TIMESTAMP_MODE_MANUAL);
+    Test_SetTimeMs(0.0F);
+    Fake_EnSensReset();
+    Idle_Init();
+
+    engine->speed = TEST_OPEN_LOOP_SPEED_RPM;
+    /* Engine has been idling with base duty */
+    engine->airDuty = Test_GetBaseDuty();
+    engine->loadTorque = TEST_LOAD_TORQUE;
+    engine->sparkCorrection = 0.0F;
+    engine->eventAngle = 0.0F;
+    engine->isSparkModelled = isSparkModelled;
+    engine->timeMs = 0.0F;
+}
+
+/*===========================================================================*
+ * Function: Test_GetValveDuty
+ *===========================================================================*/
+static float Test_GetValveDuty(void)
+{
+    return (float)TIMER_IDLE_VALVE->CCR1 / IDLE_VALVE_TICKS_PER_PERCENT;
+}
+
+/*===========================================================================*
+ * Function: Test_GetBaseDuty
+ *===========================================================================*/
+static float Test_GetBaseDuty(void)
+{
+    return Tables_Get2DTableValue(TABLES_2D_IDLE_BASE_DUTY, UTILS_CONVERT_K_TO_C(fake_engine_sensors.cltTemperature));
+}
+
+/*===========================================================================*
+ * Function: Test_Step
+ *===========================================================================*/
+static void Test_Step(Test_Engine_T* engine)
+{
+    float torque;
+    float sparkTorque;
+
+    engine->timeMs += TEST_STEP_MS;
+    Test_SetTimeMs(engine->timeMs);
+    EnCon_UpdateEngineSpeed(TEST_SPEED_RAW(engine->speed));
+
+    Idle_OnBackgroundTask();
+
+    /* One ignition event every 720 / ENCON_ENGINE_PISTONS_NO degrees */
+    engine->eventAngle += engine->speed * 6.0F * (TEST_STEP_MS / 1000.0F);
+
+    if (engine->eventAngle >= (720.0F / (float)ENCON_ENGINE_PISTONS_NO))
+    {
+        engine->eventAngle -= 720.0F / (float)ENCON_ENGINE_PISTONS_NO;
+        engine->sparkCorrection = Idle_GetSparkCorrection(engine->speed);
+    }
+
+    engine->airDuty += (Test_GetValveDuty() - engine->airDuty) * (TEST_STEP_MS / TEST_AIR_TAU_MS);
+
+    sparkTorque = engine->isSparkModelled ? (TEST_TORQUE_PER_SPARK_DEGREE * engine->sparkCorrection) : 0.0F;
+    torque = (TEST_LEAK_TORQUE + (TEST_TORQUE_PER_DUTY * engine->airDuty)) * (1.0F + sparkTorque);
+    torque -= engine->loadTorque + (TEST_LOAD_TORQUE_PER_RPM * engine->speed);
+
+    engine->speed += torque * TEST_RPM_PER_TORQUE_S * (TEST_STEP_MS / 1000.0F);
+}
+
+/*===========================================================================*
+ * Function: Test_Simulate
+ *===========================================================================*/
+static Test_Result_T Test_Simulate(Test_Engine_T* engine, float durationMs)
+{
+    Test_Result_T result;
+    float endMs;
+
+    result.minSpeed = engine->speed;
+    result.maxSpeed = engine->speed;
+    endMs = engine->timeMs + durationMs;
+
+    while (engine->timeMs < endMs)
+    {
+        Test_Step(engine);
+
+        result.minSpeed = (engine->speed < result.minSpeed) ? engine->speed : result.minSpeed;
+        result.maxSpeed = (engine->speed > result.maxSpeed) ? engine->speed : result.maxSpeed;
+    }
+
+    result.finalSpeed = engine->speed;
+    result.finalSparkCorrection = engine->sparkCorrection;
+
+    return result;
+}
+
+/*===========================================================================*
+ * Function: Test_SpeedSettlesAtTarget
+ *===========================================================================*/
+static void Test_SpeedSettlesAtTarget(void)
+{
+    Test_Engine_T engine;
+    Test_Result_T result;
+    float targetSpeed;
+
+    Test_Setup(&engine, true);
+    targetSpeed = Tables_Get2DTableValue(TABLES_2D_IDLE_TARGET_SPEED,
+                                         UTILS_CONVERT_K_TO_C(fake_engine_sensors.cltTemperature));
+
+    result = Test_Simulate(&engine, TEST_SETTLE_MS);
+
+    printf("    target %.0fRPM: settled at %.1fRPM, overshoot to %.1fRPM, valve %.1f%%, spark %.2fdeg\n",
+           (double)targetSpeed, (double)result.finalSpeed, (double)result.maxSpeed, (double)Test_GetValveDuty(),
+           (double)result.finalSparkCorrection);
+
+    TEST_CHECK(idle_is_active);
+    TEST_CHECK_FLOAT(result.finalSpeed, targetSpeed, TEST_SPEED_TOLERANCE_RPM);
+    TEST_CHECK(result.maxSpeed < (targetSpeed + (2.0F * TEST_SPEED_TOLERANCE_RPM)));
+    /* Integral air loop removes the error, so spark returns to the base angle */
+    TEST_CHECK_FLOAT(result.finalSparkCorrection, 0.0F, TEST_SPARK_TOLERANCE_DEGREE);
+}
+
+/*===========================================================================*
+ * Function: Test_LoadStepRecovers
+ *===========================================================================*/
+static void Test_LoadStepRecovers(void)
+{
+    Test_Engine_T engine;
+    Test_Result_T result;
+    float targetSpeed;
+    float baseDuty;
+
+    Test_Setup(&engine, true);
+    baseDuty = Test_GetBaseDuty();
+    (void)Test_Simulate(&engine, TEST_SETTLE_MS);
+    targetSpeed = idle_target_speed;
+
+    engine.loadTorque += TEST_LOAD_STEP_TORQUE;
+    result = Test_Simulate(&engine, TEST_SETTLE_MS);
+
+    printf("    load step: dip to %.1fRPM, settled at %.1fRPM, valve %.1f%% (base %.1f%%)\n",
+           (double)result.minSpeed, (double)result.finalSpeed, (double)Test_GetValveDuty(), (double)baseDuty);
+
+    TEST_CHECK(result.minSpeed > (targetSpeed - TEST_LOAD_STEP_DIP_MAX_RPM));
+    TEST_CHECK(result.minSpeed > ENCON_RUNNING_FLOOR_RPM);
+    TEST_CHECK_FLOAT(result.finalSpeed, targetSpeed, TEST_SPEED_TOLERANCE_RPM);
+    TEST_CHECK_FLOAT(result.finalSparkCorrection, 0.0F, TEST_SPARK_TOLERANCE_DEGREE);
+    /* Extra load is carried by the air, within the correction limit */
+    TEST_CHECK(Test_GetValveDuty() > baseDuty);
+    TEST_CHECK(Test_GetValveDuty() < (baseDuty + IDLE_AIR_CORRECTION_LIMIT));
+}
+
+/*===========================================================================*
+ * Function: Test_SparkLoopReducesDip
+ *===========================================================================*/
+static void Test_SparkLoopReducesDip(void)
+{
+    Test_Engine_T engine;
+    Test_Result_T withSpark;
+    Test_Result_T airOnly;
+
+    Test_Setup(&engine, true);
+    (void)Test_Simulate(&engine, TEST_SETTLE_MS);
+    engine.loadTorque += TEST_LOAD_STEP_TORQUE;
+    withSpark = Test_Simulate(&engine, TEST_SETTLE_MS);
+
+    Test_Setup(&engine, false);
+    (void)Test_Simulate(&engine, TEST_SETTLE_MS);
+    engine.loadTorque += TEST_LOAD_STEP_TORQUE;
+    airOnly = Test_Simulate(&engine, TEST_SETTLE_MS);
+
+    printf("    load step dip: %.1fRPM with spark loop, %.1fRPM with air loop only\n",
+           (double)(idle_target_speed - withSpark.minSpeed), (double)(idle_target_speed - airOnly.minSpeed));
+
+    /* Torque responds to spark within one cycle, before the manifold fills */
+    TEST_CHECK(withSpark.minSpeed > airOnly.minSpeed);
+}
+
+/*===========================================================================*
+ * Function: Test_OpenThrottleDisablesIdle
+ *===========================================================================*/
+static void Test_OpenThrottleDisablesIdle(void)
+{
+    Test_Engine_T engine;
+    float baseDuty;
+
+    Test_Setup(&engine, true);
+    baseDuty = Test_GetBaseDuty();
+    /* Open throttle is seen by TPS and, without the sensor, by MAP */
+    fake_engine_sensors.tps = 2.0F * IDLE_TPS_THRESHOLD;
+    fake_engine_sensors.map = TEST_LOAD_PRESSURE;
+
+    (void)Test_Simulate(&engine, TEST_SETTLE_MS);
+
+    TEST_CHECK(false == idle_is_active);
+    TEST_CHECK_FLOAT(Idle_GetSparkCorrection(engine.speed - 100.0F), 0.0F, 0.0001F);
+    TEST_CHECK_FLOAT(Test_GetValveDuty(), baseDuty, 0.1F);
+}
+
+/*===========================================================================*
+ * Function: Test_LoadAtLowSpeedDisablesIdle
+ *===========================================================================*/
+static void Test_LoadAtLowSpeedDisablesIdle(void)
+{
+    Test_Engine_T engine;
+    float timeMs;
+
+    Test_Setup(&engine, true);
+    fake_engine_sensors.map = TEST_LOAD_PRESSURE;
+#if ENSENS_TPS_LAMBDA_SENSORS_ENABLED
+    fake_engine_sensors.tps = 2.0F * IDLE_TPS_THRESHOLD;
+#else
+    /* Getter of the missing sensor reads closed throttle */
+    fake_engine_sensors.tps = 0.0F;
+#endif
+
+    /* Speed is held by the vehicle, engine model is not used */
+    EnCon_UpdateEngineSpeed(TEST_SPEED_RAW(TEST_LOAD_SPEED_RPM));
+
+    for (timeMs = 0.0F; timeMs < TEST_SETTLE_MS; timeMs += IDLE_UPDATE_PERIOD_MS)
+    {
+        Test_SetTimeMs(timeMs);
+        Idle_OnBackgroundTask();
+    }
+
+    TEST_CHECK(TEST_LOAD_SPEED_RPM < (idle_target_speed + IDLE_SPEED_WINDOW_RPM));
+    TEST_CHECK(false == idle_is_active);
+    /* Spark would be retarded by the idle loop above the target speed */
+    TEST_CHECK_FLOAT(Idle_GetSparkCorrection(TEST_LOAD_SPEED_RPM), 0.0F, 0.0001F);
+    TEST_CHECK_FLOAT(Test_GetValveDuty(), Test_GetBaseDuty(), 0.1F);
+}
+
+/*===========================================================================*
+ * Function: Test_InitDutyIsFixed
+ *===========================================================================*/
+static void Test_InitDutyIsFixed(void)
+{
+    Test_Engine_T engine;
+
+    /* Coolant value is not converted before the first ADC scan */
+    Test_Setup(&engine, true);
+    TEST_CHECK_FLOAT(Test_GetValveDuty(), IDLE_VALVE_INIT_DUTY, 0.1F);
+
+    fake_engine_sensors.cltTemperature = UTILS_CONVERT_C_TO_K(TEST_COLD_COOLANT_TEMP);
+    Idle_Init();
+    TEST_CHECK_FLOAT(Test_GetValveDuty(), IDLE_VALVE_INIT_DUTY, 0.1F);
+
+    /* First update with stopped engine sets base duty of the coolant temperature */
+    EnCon_UpdateEngineSpeed(ENCON_SPEED_RAW_UNKNOWN);
+    Test_SetTimeMs(IDLE_UPDATE_PERIOD_MS);
+    Idle_OnBackgroundTask();
+    TEST_CHECK_FLOAT(Test_GetValveDuty(), Test_GetBaseDuty(), 0.1F);
+}
+
+/* end of file */
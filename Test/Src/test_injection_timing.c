@@ -0,0 +1,234 @@
+/*===========================================================================*
+ * File:        test_injection_timing.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       End of injection angle timing across engine speed
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "test.h"
+
+#include "fakes.h"
+
+/* Module is included to reach its local functions */
+#include "../../Core/Src/speed_density.c"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+#define TEST_US_IN_MINUTE                       (60000000.0F)
+#define TEST_SPEED_RAW(_RPM_)                   ((uint32_t)((TEST_US_IN_MINUTE /                               \
+                                                             ((_RPM_) * ENCON_TRIGGER_WHEEL_TEETH_NO)) + 0.5F))
+
+#define TEST_ANGLE_TOLERANCE                    (0.01F)
+#define TEST_TIME_TOLERANCE_MS                  (0.001F)
+
+/*===========================================================================*
+ *
+ * LOCAL TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+/* Injection as executed by the shared injector timer, angles relative to the timer start */
+typedef struct Test_Injection_Tag
+{
+    float startAngle;
+    float endAngle;
+    float openTimeMs;
+} Test_Injection_T;
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+static const float test_speeds[] = { 600.0F, 1500.0F, 3000.0F, 4500.0F, 6000.0F, 7500.0F };
+static const float test_fuel_ms[] = { 1.0F, 4.0F, 8.0F, 16.0F };
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+static void Test_Setup(void);
+static Test_Injection_T Test_Execute(const InjDrv_Pulse_T* pulses, uint8_t pulsesNo, float timerStartAngle);
+
+static void Test_EndAngleAcrossSpeed(void);
+static void Test_UnknownSpeedFallsBackToStartAngle(void);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: main
+ *===========================================================================*/
+int main(void)
+{
+    printf("test_injection_timing\n");
+
+    TEST_RUN(Test_EndAngleAcrossSpeed);
+    TEST_RUN(Test_UnknownSpeedFallsBackToStartAngle);
+
+    return Test_Summary();
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Test_Setup
+ *===========================================================================*/
+static void Test_Setup(void)
+{
+    Test_ResetPeripherals();
+    Fake_EnSensReset();
+    InjMod_Init();
+    InjMod_Update();
+    SpDen_Init();
+}
+
+/*===========================================================================*
+ * Function: Test_Execute
+ *===========================================================================*/
+static Test_Injection_T Test_Execute(const InjDrv_Pulse_T* pulses, uint8_t pulsesNo, float timerStartAngle)
+{
+    Test_Injection_T injection = { 0.0F, 0.0F, 0.0F };
+    float pulseStart;
+    float pulseEnd;
+    uint8_t pulse;
+
+    /* Same rules as the injection driver: overlapping pulse is started right after the previous one */
+    for (pulse = 0U; pulse < pulsesNo; pulse++)
+    {
+        pulseStart = UTILS_CIRCULAR_DIFFERENCE(pulses[pulse].injAngle, timerStartAngle,
+                                               ENCON_ENGINE_FULL_CYCLE_ANGLE);
+        pulseStart = (pulseStart > injection.endAngle) ? pulseStart : injection.endAngle;
+        pulseEnd = pulseStart + EnCon_ConvertTimeToAngle(pulses[pulse].openTimeMs);
+
+        if (0U == pulse)
+        {
+            injection.startAngle = pulseStart;
+        }
+
+        injection.endAngle = pulseEnd;
+        injection.openTimeMs += pulses[pulse].openTimeMs;
+    }
+
+    return injection;
+}
+
+/*===========================================================================*
+ * Function: Test_EndAngleAcrossSpeed
+ *===========================================================================*/
+static void Test_EndAngleAcrossSpeed(void)
+{
+    EnCon_CylinderChannels_T channel;
+    InjDrv_Pulse_T pulses[ENCON_INJECTION_PULSES_NO];
+    Test_Injection_T injection;
+    uint8_t pulsesNo;
+    float timerStartAngle;
+    float targetEndAngle;
+    float windowEndAngle;
+    float anglePerMs;
+    float requestedMs;
+    float pressure;
+    uint32_t speed;
+    uint32_t fuel;
+
+    Test_Setup();
+    pressure = fake_engine_sensors.map;
+
+    printf("    %6s %8s %10s %10s %10s %10s\n", "rpm", "fuel ms", "pulse ms", "open ms", "end [deg]",
+           "limit [deg]");
+
+    for (speed = 0U; speed < (sizeof(test_speeds) / sizeof(test_speeds[0])); speed++)
+    {
+        EnCon_UpdateEngineSpeed(TEST_SPEED_RAW(test_speeds[speed]));
+        anglePerMs = EnCon_ConvertTimeToAngle(1.0F);
+
+        for (fuel = 0U; fuel < (sizeof(test_fuel_ms) / sizeof(test_fuel_ms[0])); fuel++)
+        {
+            for (channel = ENCON_CHANNEL_1; channel < ENCON_CHANNEL_COUNT; channel++)
+            {
+                pulsesNo = SpDen_CalculateInjectionPulses(test_speeds[speed], pressure, test_fuel_ms[fuel], channel,
+                                                          pulses);
+
+                timerStartAngle = UTILS_CIRCULAR_ADDITION(spden_injection_end_calc_angles[channel],
+                                                          ENCON_ONE_TRIGGER_PULSE_ANGLE,
+                                                          ENCON_ENGINE_FULL_CYCLE_ANGLE);
+                targetEndAngle = UTILS_CIRCULAR_DIFFERENCE(spden_injection_end_angles[channel], timerStartAngle,
+                                                           ENCON_ENGINE_FULL_CYCLE_ANGLE);
+                /* Injector timer is prepared again for the next channel at its calculation tooth */
+                windowEndAngle = UTILS_CIRCULAR_DIFFERENCE(
+                    spden_injection_end_calc_angles[SPDEN_NEXT_CHANNEL(channel)], timerStartAngle,
+                    ENCON_ENGINE_FULL_CYCLE_ANGLE);
+
+                injection = Test_Execute(pulses, pulsesNo, timerStartAngle);
+                requestedMs = InjMod_GetPulseWidth(test_fuel_ms[fuel]);
+
+                TEST_CHECK((pulsesNo >= 1U) && (pulsesNo <= ENCON_INJECTION_PULSES_NO));
+                /* Never truncated by the next channel preparation */
+                TEST_CHECK(injection.endAngle <= (windowEndAngle + TEST_ANGLE_TOLERANCE));
+
+                if (injection.startAngle > TEST_ANGLE_TOLERANCE)
+                {
+                    /* Injection fits, it ends exactly at the target angle */
+                    TEST_CHECK_FLOAT(injection.endAngle, targetEndAngle, TEST_ANGLE_TOLERANCE);
+                }
+                else
+                {
+                    /* Doesn't fit, one pulse from the first tooth limited to the window */
+                    TEST_CHECK(1U == pulsesNo);
+                    TEST_CHECK_FLOAT(pulses[0].openTimeMs,
+                                     (requestedMs < (windowEndAngle / anglePerMs)) ? requestedMs :
+                                                                                     (windowEndAngle / anglePerMs),
+                                     TEST_TIME_TOLERANCE_MS);
+                }
+
+                if (ENCON_CHANNEL_1 == channel)
+                {
+                    printf("    %6.0f %8.2f %10.3f %10.3f %10.2f %10.2f\n", (double)test_speeds[speed],
+                           (double)test_fuel_ms[fuel], (double)requestedMs, (double)injection.openTimeMs,
+                           (double)injection.endAngle, (double)windowEndAngle);
+                }
+            }
+        }
+    }
+}
+
+/*===========================================================================*
+ * Function: Test_UnknownSpeedFallsBackToStartAngle
+ *===========================================================================*/
+static void Test_UnknownSpeedFallsBackToStartAngle(void)
+{
+    InjDrv_Pulse_T pulses[ENCON_INJECTION_PULSES_NO];
+    uint8_t pulsesNo;
+
+    Test_Setup();
+    EnCon_UpdateEngineSpeed(ENCON_SPEED_RAW_UNKNOWN);
+
+    pulsesNo = SpDen_CalculateInjectionPulses(1000.0F, fake_engine_sensors.map, 4.0F, ENCON_CHANNEL_2, pulses);
+
+    TEST_CHECK(pulsesNo >= 1U);
+    TEST_CHECK_FLOAT(pulses[0].injAngle, spden_intake_beggining_angles[ENCON_CHANNEL_2], TEST_ANGLE_TOLERANCE);
+    TEST_CHECK(pulses[0].openTimeMs > 0.0F);
+}
+
+/* end of file */
@@ -0,0 +1,286 @@
+/*===========================================================================*
+ * File:        test_output_map.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Timer and GPIO outputs of the output map with interrupt latency estimate
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "test.h"
+
+/* Module is included to reach its outputs table and local functions */
+#include "../../Core/Src/output_map.c"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+#define TEST_LATENCY_EVENTS_NO                  (2000U)
+
+#define TEST_COMPARE_VALUE                      (50000U)
+
+/* Handlers which can run between the compare event and the GPIO write, estimated from their code paths. */
+/* Each one runs at most once in the window, as their events are tens of microseconds apart */
+/* Exception entry of Cortex-M4 with FPU context stacking, paid by every handler */
+#define TEST_ISR_ENTRY_CYCLES                   (12U)
+/* TIM3 capture handler preempts the group timer handler (priority 0) */
+#define TEST_SPEED_CAPTURE_ISR_CYCLES           (150U)
+/* Priority 1 handlers can't be preempted: sync input, injection pulses DMA and the other group timer */
+#define TEST_SYNC_ISR_CYCLES                    (30U)
+#define TEST_PULSES_DMA_ISR_CYCLES              (40U)
+#define TEST_OTHER_GROUP_ISR_CYCLES             (80U)
+/* Group timer handler up to the BSRR write */
+#define TEST_GPIO_SET_CYCLES                    (40U)
+
+#define TEST_GPIO_HANDLERS_NO                   (5U)
+#define TEST_GPIO_LATENCY_MAX_CYCLES            ((TEST_GPIO_HANDLERS_NO * TEST_ISR_ENTRY_CYCLES) +                 \
+                                                 TEST_SPEED_CAPTURE_ISR_CYCLES + TEST_SYNC_ISR_CYCLES +            \
+                                                 TEST_PULSES_DMA_ISR_CYCLES + TEST_OTHER_GROUP_ISR_CYCLES +        \
+                                                 TEST_GPIO_SET_CYCLES)
+
+/* Accepted GPIO output error: 0.25 deg of spark at the highest speed, 1% of the shortest injection */
+#define TEST_SPEED_MAX_RPM                      (8000.0F)
+#define TEST_SPARK_ERROR_MAX_DEGREE             (0.25F)
+#define TEST_INJECTION_MIN_MS                   (1.0F)
+#define TEST_INJECTION_ERROR_MAX_PERCENT        (1.0F)
+
+#define TEST_DEGREES_PER_REVOLUTION             (360.0F)
+#define TEST_S_IN_MINUTE                        (60.0F)
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+static uint32_t test_random_state;
+
+static const float test_speeds_rpm[] = { 1000.0F, 3000.0F, 6000.0F, TEST_SPEED_MAX_RPM };
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+static uint32_t Test_Random(uint32_t max);
+static const OutMap_Output_T* Test_GetGpioOutput(OutMap_Group_T group);
+static void Test_CompareEvent(OutMap_Group_T group, uint32_t latency);
+static void Test_UpdateEvent(OutMap_Group_T group);
+
+static void Test_GpioOutputFollowsTimerEvents(void);
+static void Test_TimerOutputIsNotDrivenBySoftware(void);
+static void Test_GpioOutputLatency(void);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: main
+ *===========================================================================*/
+int main(void)
+{
+    printf("test_output_map\n");
+
+    TEST_RUN(Test_GpioOutputFollowsTimerEvents);
+    TEST_RUN(Test_TimerOutputIsNotDrivenBySoftware);
+    TEST_RUN(Test_GpioOutputLatency);
+
+    return Test_Summary();
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Test_Random
+ *===========================================================================*/
+static uint32_t Test_Random(uint32_t max)
+{
+    test_random_state = (test_random_state * 1664525U) + 1013904223U;
+
+    return (max == 0U) ? 0U : ((test_random_state >> 8) % (max + 1U));
+}
+
+/*===========================================================================*
+ * Function: Test_GetGpioOutput
+ *===========================================================================*/
+static const OutMap_Output_T* Test_GetGpioOutput(OutMap_Group_T group)
+{
+    /* 4th output of each group is GPIO, it's used by engines with 4 or more cylinders */
+    return &outmap_groups[group].outputs[3U];
+}
+
+/*===========================================================================*
+ * Function: Test_CompareEvent
+ *===========================================================================*/
+static void Test_CompareEvent(OutMap_Group_T group, uint32_t latency)
+{
+    TIM_TypeDef* timer = outmap_groups[group].timer;
+
+    /* Interrupt handler runs latency ticks after the compare match */
+    timer->CR1 |= TIM_CR1_CEN;
+    timer->CNT = OUTMAP_TIMER_CCR(timer, outmap_active_outputs[group]->timerChannel) + latency;
+    timer->SR |= OUTMAP_TIMER_SR_CCIF(outmap_active_outputs[group]->timerChannel);
+    OutMap_OnTimerInterrupt(group);
+}
+
+/*===========================================================================*
+ * Function: Test_UpdateEvent
+ *===========================================================================*/
+static void Test_UpdateEvent(OutMap_Group_T group)
+{
+    TIM_TypeDef* timer = outmap_groups[group].timer;
+
+    /* One-shot timer is stopped and reset at the update event */
+    timer->CR1 &= ~TIM_CR1_CEN;
+    timer->CNT = 0U;
+    timer->SR |= TIM_SR_UIF;
+    OutMap_OnTimerInterrupt(group);
+}
+
+/*===========================================================================*
+ * Function: Test_GpioOutputFollowsTimerEvents
+ *===========================================================================*/
+static void Test_GpioOutputFollowsTimerEvents(void)
+{
+    const OutMap_Output_T* output;
+    TIM_TypeDef* timer;
+    uint8_t group;
+
+    for (group = 0U; group < OUTMAP_GROUP_COUNT; group++)
+    {
+        Test_ResetPeripherals();
+        OutMap_Init((OutMap_Group_T)group);
+
+        output = Test_GetGpioOutput((OutMap_Group_T)group);
+        timer = outmap_groups[group].timer;
+
+        TEST_CHECK(OUTMAP_OUTPUT_TYPE_GPIO == output->type);
+
+        OutMap_SelectOutput((OutMap_Group_T)group, output, TEST_COMPARE_VALUE);
+        /* Selection resets the other GPIO outputs, fake register keeps the last written value */
+        output->port->BSRR = 0U;
+
+        TEST_CHECK(TEST_COMPARE_VALUE == OUTMAP_TIMER_CCR(timer, output->timerChannel));
+        TEST_CHECK((timer->DIER & OUTMAP_TIMER_DIER_CCIE(output->timerChannel)) != 0U);
+        TEST_CHECK((timer->DIER & TIM_DIER_UIE) != 0U);
+
+        /* Compare match of the stopped timer, e.g. at counter reset, doesn't start the pulse */
+        timer->SR |= OUTMAP_TIMER_SR_CCIF(output->timerChannel);
+        OutMap_OnTimerInterrupt((OutMap_Group_T)group);
+        TEST_CHECK(0U == output->port->BSRR);
+        TEST_CHECK((timer->SR & OUTMAP_TIMER_SR_CCIF(output->timerChannel)) == 0U);
+
+        Test_CompareEvent((OutMap_Group_T)group, 123U);
+        TEST_CHECK((1UL << output->pin) == output->port->BSRR);
+        TEST_CHECK(123U == outmap_gpio_latencies[group].last);
+
+        Test_UpdateEvent((OutMap_Group_T)group);
+        TEST_CHECK((1UL << (output->pin + 16U)) == output->port->BSRR);
+        TEST_CHECK((timer->SR & TIM_SR_UIF) == 0U);
+    }
+}
+
+/*===========================================================================*
+ * Function: Test_TimerOutputIsNotDrivenBySoftware
+ *===========================================================================*/
+static void Test_TimerOutputIsNotDrivenBySoftware(void)
+{
+    const OutMap_Output_T* output;
+    TIM_TypeDef* timer;
+
+    Test_ResetPeripherals();
+    OutMap_Init(OUTMAP_GROUP_IGNITION);
+
+    output = &outmap_groups[OUTMAP_GROUP_IGNITION].outputs[ENCON_CHANNEL_1];
+    timer = outmap_groups[OUTMAP_GROUP_IGNITION].timer;
+
+    OutMap_SelectChannel(OUTMAP_GROUP_IGNITION, ENCON_CHANNEL_1, TEST_COMPARE_VALUE);
+    output->port->BSRR = 0U;
+
+    /* Timer output edges are exact, no interrupt is needed */
+    TEST_CHECK(OUTMAP_OUTPUT_TYPE_TIMER == output->type);
+    TEST_CHECK((timer->CCMR1 & TIM_CCMR1_OC1M) == TIM_CCMR1_OC1M);
+    TEST_CHECK((timer->DIER & TIM_DIER_UIE) == 0U);
+
+    Test_CompareEvent(OUTMAP_GROUP_IGNITION, 123U);
+    Test_UpdateEvent(OUTMAP_GROUP_IGNITION);
+
+    TEST_CHECK(0U == output->port->BSRR);
+}
+
+/*===========================================================================*
+ * Function: Test_GpioOutputLatency
+ *===========================================================================*/
+static void Test_GpioOutputLatency(void)
+{
+    uint32_t latencyMax;
+    uint32_t latency;
+    uint32_t event;
+    uint8_t group;
+    uint8_t speed;
+    float latencyUs;
+    float sparkError;
+    float injectionError;
+
+    test_random_state = 12345U;
+
+    for (group = 0U; group < OUTMAP_GROUP_COUNT; group++)
+    {
+        Test_ResetPeripherals();
+        OutMap_Init((OutMap_Group_T)group);
+        OutMap_SelectOutput((OutMap_Group_T)group, Test_GetGpioOutput((OutMap_Group_T)group), TEST_COMPARE_VALUE);
+        outmap_gpio_latencies[group].max = 0U;
+        latencyMax = 0U;
+
+        for (event = 0U; event < TEST_LATENCY_EVENTS_NO; event++)
+        {
+            latency = Test_Random(TEST_GPIO_LATENCY_MAX_CYCLES);
+            latencyMax = (latency > latencyMax) ? latency : latencyMax;
+
+            Test_CompareEvent((OutMap_Group_T)group, latency);
+            Test_UpdateEvent((OutMap_Group_T)group);
+        }
+
+        /* Debugger reads the same statistics on the target */
+        TEST_CHECK(latencyMax == outmap_gpio_latencies[group].max);
+    }
+
+    /* Timer clock is the core clock, so ticks and cycles are equal */
+    latencyUs = ((float)TEST_GPIO_LATENCY_MAX_CYCLES / TIMER_TIM_CLOCK) * 1000000.0F;
+    injectionError = (100.0F * latencyUs) / (TEST_INJECTION_MIN_MS * 1000.0F);
+
+    printf("    GPIO output worst case latency %u cycles, %.2f us, %.2f%% of %.1f ms injection\n",
+           (unsigned)TEST_GPIO_LATENCY_MAX_CYCLES, (double)latencyUs, (double)injectionError,
+           (double)TEST_INJECTION_MIN_MS);
+    printf("    %8s %16s\n", "rpm", "spark error [deg]");
+
+    for (speed = 0U; speed < (sizeof(test_speeds_rpm) / sizeof(test_speeds_rpm[0])); speed++)
+    {
+        sparkError = ((test_speeds_rpm[speed] * TEST_DEGREES_PER_REVOLUTION) / TEST_S_IN_MINUTE) *
+                     (latencyUs / 1000000.0F);
+
+        printf("    %8.0f %16.3f\n", (double)test_speeds_rpm[speed], (double)sparkError);
+
+        TEST_CHECK(sparkError <= TEST_SPARK_ERROR_MAX_DEGREE);
+    }
+
+    TEST_CHECK(injectionError <= TEST_INJECTION_ERROR_MAX_PERCENT);
+}
+
+/* end of file */
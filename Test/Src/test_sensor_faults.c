@@ -0,0 +1,180 @@
+/*===========================================================================*
+ * File:        test_sensor_faults.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Sensor plausibility faults latching, substitution and healing
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "test.h"
+
+/* Module is included to reach its diagnostic state and local functions */
+#include "../../Core/Src/engine_sensors.c"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/* Engine speed is only checked for being known */
+#define TEST_RUNNING_SPEED_RAW                  (1000U)
+
+/* MAP sensor codes: plausible value and shorted to ground */
+#define TEST_MAP_GOOD_CODE                      (2000U)
+#define TEST_MAP_LOW_CODE                       (10U)
+
+/* Range faults are latched after the debounce sets */
+#define TEST_RANGE_FAULT_SETS                   (ENSENS_RANGE_FAULT_DEBOUNCE + 1U)
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+static void Test_Setup(uint32_t speedRaw);
+static void Test_CheckSets(uint16_t code, bool isChanging, uint32_t setsNo);
+
+static void Test_StuckCheckNeedsRunningEngine(void);
+static void Test_SubstituteHealsAfterGoodSets(void);
+static void Test_FaultRestartsHealing(void);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: main
+ *===========================================================================*/
+int main(void)
+{
+    printf("test_sensor_faults\n");
+
+    TEST_RUN(Test_StuckCheckNeedsRunningEngine);
+    TEST_RUN(Test_SubstituteHealsAfterGoodSets);
+    TEST_RUN(Test_FaultRestartsHealing);
+
+    return Test_Summary();
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Test_Setup
+ *===========================================================================*/
+static void Test_Setup(uint32_t speedRaw)
+{
+    Test_ResetPeripherals();
+    memset(ensens_diagnostic_states, 0, sizeof(ensens_diagnostic_states));
+    EnSens_ClearFaults();
+    ensens_is_filters_primed = true;
+
+    EnCon_UpdateEngineSpeed(speedRaw);
+}
+
+/*===========================================================================*
+ * Function: Test_CheckSets
+ *===========================================================================*/
+static void Test_CheckSets(uint16_t code, bool isChanging, uint32_t setsNo)
+{
+    uint32_t set;
+    uint16_t setCode;
+
+    for (set = 0U; set < setsNo; set++)
+    {
+        /* Changing value toggles the lowest bit, it's below the noise of a working sensor */
+        setCode = isChanging ? (uint16_t)(code + (set & 1U)) : code;
+
+        ensens_sensors_data[ENSENS_SENSOR_MAP] = (float)setCode;
+        EnSens_CheckSensor(ENSENS_SENSOR_MAP, setCode);
+    }
+}
+
+/*===========================================================================*
+ * Function: Test_StuckCheckNeedsRunningEngine
+ *===========================================================================*/
+static void Test_StuckCheckNeedsRunningEngine(void)
+{
+    uint32_t stuckSetsNo = ensens_channels_config[ENSENS_SENSOR_MAP].diagnostic.stuckSetsNo;
+
+    /* Key-on without cranking, MAP reads constant atmospheric pressure */
+    Test_Setup(ENCON_SPEED_RAW_UNKNOWN);
+    Test_CheckSets(TEST_MAP_GOOD_CODE, false, 2U * stuckSetsNo);
+
+    TEST_CHECK(0U == EnSens_GetFaults(ENSENS_SENSOR_MAP));
+    TEST_CHECK(0U == ensens_diagnostic_states[ENSENS_SENSOR_MAP].stuckCounter);
+
+    /* Constant value is a fault only when the engine is running */
+    EnCon_UpdateEngineSpeed(TEST_RUNNING_SPEED_RAW);
+    Test_CheckSets(TEST_MAP_GOOD_CODE, false, stuckSetsNo);
+    TEST_CHECK(0U == EnSens_GetFaults(ENSENS_SENSOR_MAP));
+
+    Test_CheckSets(TEST_MAP_GOOD_CODE, false, 1U);
+    TEST_CHECK(ENSENS_FAULT_MASK(ENSENS_FAULT_STUCK) == EnSens_GetFaults(ENSENS_SENSOR_MAP));
+    TEST_CHECK(ENSENS_FAULT_MASK(ENSENS_FAULT_STUCK) == EnSens_GetActiveFaults(ENSENS_SENSOR_MAP));
+}
+
+/*===========================================================================*
+ * Function: Test_SubstituteHealsAfterGoodSets
+ *===========================================================================*/
+static void Test_SubstituteHealsAfterGoodSets(void)
+{
+    float substitute = ensens_channels_config[ENSENS_SENSOR_MAP].diagnostic.substituteValue;
+
+    Test_Setup(TEST_RUNNING_SPEED_RAW);
+
+    Test_CheckSets(TEST_MAP_LOW_CODE, true, TEST_RANGE_FAULT_SETS);
+
+    TEST_CHECK(ENSENS_FAULT_MASK(ENSENS_FAULT_RANGE_LOW) == EnSens_GetActiveFaults(ENSENS_SENSOR_MAP));
+    TEST_CHECK_FLOAT(EnSens_GetMap(), substitute, 0.0001F);
+
+    /* Substitute is kept until the sensor is good for the whole healing time */
+    Test_CheckSets(TEST_MAP_GOOD_CODE, true, ENSENS_FAULT_HEAL_SETS);
+    TEST_CHECK(0U != EnSens_GetActiveFaults(ENSENS_SENSOR_MAP));
+    TEST_CHECK_FLOAT(EnSens_GetMap(), substitute, 0.0001F);
+
+    Test_CheckSets(TEST_MAP_GOOD_CODE, true, 1U);
+    TEST_CHECK(0U == EnSens_GetActiveFaults(ENSENS_SENSOR_MAP));
+    TEST_CHECK_FLOAT(EnSens_GetMap(), EnSens_ConvertChannel(ENSENS_SENSOR_MAP, ensens_sensors_data[ENSENS_SENSOR_MAP]),
+                     0.0001F);
+
+    /* Code stays latched for diagnostics until it's cleared */
+    TEST_CHECK(ENSENS_FAULT_MASK(ENSENS_FAULT_RANGE_LOW) == EnSens_GetFaults(ENSENS_SENSOR_MAP));
+
+    EnSens_ClearFaults();
+    TEST_CHECK(0U == EnSens_GetFaults(ENSENS_SENSOR_MAP));
+}
+
+/*===========================================================================*
+ * Function: Test_FaultRestartsHealing
+ *===========================================================================*/
+static void Test_FaultRestartsHealing(void)
+{
+    Test_Setup(TEST_RUNNING_SPEED_RAW);
+
+    Test_CheckSets(TEST_MAP_LOW_CODE, true, TEST_RANGE_FAULT_SETS);
+    Test_CheckSets(TEST_MAP_GOOD_CODE, true, ENSENS_FAULT_HEAL_SETS / 2U);
+
+    /* Intermittent sensor, short drops below the debounce don't latch a new fault but stop healing */
+    Test_CheckSets(TEST_MAP_LOW_CODE, true, 1U);
+    Test_CheckSets(TEST_MAP_GOOD_CODE, true, ENSENS_FAULT_HEAL_SETS / 2U);
+    TEST_CHECK(0U != EnSens_GetActiveFaults(ENSENS_SENSOR_MAP));
+
+    Test_CheckSets(TEST_MAP_GOOD_CODE, true, ENSENS_FAULT_HEAL_SETS);
+    TEST_CHECK(0U == EnSens_GetActiveFaults(ENSENS_SENSOR_MAP));
+}
+
+/* end of file */
@@ -0,0 +1,271 @@
+/*===========================================================================*
+ * File:        test_speed_trigger.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Hardware start of event timers from the speed signal
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "test.h"
+
+#include "engine_constants.h"
+#include "ignition_driver.h"
+#include "injection_driver.h"
+#include "timers.h"
+#include "trigger_decoder.h"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+#define TEST_JITTER_EVENTS_NO                   (2000U)
+
+/* Exception entry of Cortex-M4 with FPU context stacking */
+#define TEST_ISR_ENTRY_CYCLES                   (12U)
+/* Former software start: capture ISR prologue and callback dispatch before CEN was set */
+#define TEST_SW_START_DISPATCH_CYCLES           (60U)
+/* Longest section with masked interrupts or same priority ISR, which can delay the capture ISR */
+/* Assumption based on the prepare calls in SpDen_OnTriggerInterrupt, wrapped in DisableIRQ */
+#define TEST_SW_START_BLOCKING_MAX_CYCLES       (800U)
+/* Trigger input resynchronization of the slave timer, constant part is calibrated out */
+#define TEST_HW_START_JITTER_MAX_CYCLES         (1U)
+
+#define TEST_US_IN_MINUTE                       (60000000.0F)
+
+#define TEST_SPARK_ANGLE                        (355.0F)
+#define TEST_DWELL_ANGLE                        (30.0F)
+
+/*===========================================================================*
+ *
+ * LOCAL TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+typedef struct Test_JitterResult_Tag
+{
+    float meanError;
+    float maxError;
+} Test_JitterResult_T;
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+extern void TIM2_IRQHandler(void);
+extern void TIM5_IRQHandler(void);
+
+static uint32_t test_random_state;
+
+/* Speed timer ticks (1us) between teeth */
+static const uint32_t test_speed_raw[] = { 2000U, 667U, 333U, 222U };
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+static uint32_t Test_Random(uint32_t max);
+static Test_JitterResult_T Test_SimulateSparkJitter(uint32_t speedRaw, uint32_t jitterBase, uint32_t jitterMax);
+
+static void Test_IgnitionIsStartedByTrigger(void);
+static void Test_InjectionIsStartedByTrigger(void);
+static void Test_SpeedTimerEmitsTrgo(void);
+static void Test_SparkJitter(void);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: main
+ *===========================================================================*/
+int main(void)
+{
+    printf("test_speed_trigger\n");
+
+    TEST_RUN(Test_IgnitionIsStartedByTrigger);
+    TEST_RUN(Test_InjectionIsStartedByTrigger);
+    TEST_RUN(Test_SpeedTimerEmitsTrgo);
+    TEST_RUN(Test_SparkJitter);
+
+    return Test_Summary();
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Test_Random
+ *===========================================================================*/
+static uint32_t Test_Random(uint32_t max)
+{
+    test_random_state = (test_random_state * 1664525U) + 1013904223U;
+
+    return (max == 0U) ? 0U : ((test_random_state >> 8) % (max + 1U));
+}
+
+/*===========================================================================*
+ * Function: Test_SimulateSparkJitter
+ *===========================================================================*/
+static Test_JitterResult_T Test_SimulateSparkJitter(uint32_t speedRaw, uint32_t jitterBase, uint32_t jitterMax)
+{
+    Test_JitterResult_T result = { 0.0F, 0.0F };
+    float anglePerTick;
+    float startAngle;
+    float sparkAngle;
+    float error;
+    uint32_t startDelay;
+    uint32_t i;
+
+    test_random_state = 12345U;
+    EnCon_UpdateEngineSpeed(speedRaw);
+    anglePerTick = ENCON_ONE_TRIGGER_PULSE_ANGLE / ((float)speedRaw * TIMER_SPEED_TIM_MULTIPLIER);
+
+    for (i = 0U; i < TEST_JITTER_EVENTS_NO; i++)
+    {
+        /* Prepare is called in the ISR of the previous tooth, timer starts at the next one */
+        startAngle = TEST_SPARK_ANGLE - (ENCON_ONE_TRIGGER_PULSE_ANGLE * (float)(1U + (i % 3U)));
+        IgnDrv_PrepareIgnitionChannel(ENCON_CHANNEL_1, TEST_SPARK_ANGLE, TEST_DWELL_ANGLE, startAngle);
+
+        /* Timer reaches update event (spark) ARR + 1 ticks after the start */
+        startDelay = jitterBase + Test_Random(jitterMax);
+        sparkAngle = startAngle + ((float)(startDelay + TIMER_IGNITION->ARR + 1U) * anglePerTick);
+        error = sparkAngle - TEST_SPARK_ANGLE;
+        error = (error < 0.0F) ? -error : error;
+
+        result.meanError += error;
+        result.maxError = (error > result.maxError) ? error : result.maxError;
+
+        TIMER_IGNITION->SR |= TIM_SR_TIF;
+        TIM2_IRQHandler();
+    }
+
+    result.meanError /= (float)TEST_JITTER_EVENTS_NO;
+
+    return result;
+}
+
+/*===========================================================================*
+ * Function: Test_IgnitionIsStartedByTrigger
+ *===========================================================================*/
+static void Test_IgnitionIsStartedByTrigger(void)
+{
+    Test_ResetPeripherals();
+    IgnDrv_Init();
+    EnCon_UpdateEngineSpeed(333U);
+
+    TEST_CHECK((TIMER_IGNITION->SMCR & TIM_SMCR_TS) == TIMER_IGNITION_SPEED_TRIGGER);
+    TEST_CHECK((TIMER_IGNITION->SMCR & TIM_SMCR_SMS) == 0U);
+
+    IgnDrv_PrepareIgnitionChannel(ENCON_CHANNEL_1, TEST_SPARK_ANGLE, TEST_DWELL_ANGLE, 300.0F);
+
+    /* Software never starts the timer, it's only armed for the next TRGO */
+    TEST_CHECK((TIMER_IGNITION->CR1 & TIM_CR1_CEN) == 0U);
+    TEST_CHECK((TIMER_IGNITION->SMCR & TIM_SMCR_SMS) == TIMER_SLAVE_MODE_TRIGGER);
+    TEST_CHECK(TIMER_IGNITION->CNT == 0U);
+
+    /* Started by hardware, trigger interrupt disarms slave mode so next teeth can't restart it */
+    TIMER_IGNITION->SR |= TIM_SR_TIF;
+    TIM2_IRQHandler();
+
+    TEST_CHECK((TIMER_IGNITION->SMCR & TIM_SMCR_SMS) == 0U);
+    TEST_CHECK((TIMER_IGNITION->SMCR & TIM_SMCR_TS) == TIMER_IGNITION_SPEED_TRIGGER);
+    TEST_CHECK((TIMER_IGNITION->SR & TIM_SR_TIF) == 0U);
+}
+
+/*===========================================================================*
+ * Function: Test_InjectionIsStartedByTrigger
+ *===========================================================================*/
+static void Test_InjectionIsStartedByTrigger(void)
+{
+    InjDrv_Pulse_T pulse = { 100.0F, 2.0F };
+
+    Test_ResetPeripherals();
+    /* Preload left enabled would delay periods loaded by the DMA burst by one pulse */
+    TIMER_INJECTOR->CR1 = TIM_CR1_ARPE;
+    TIMER_INJECTOR->CCMR1 = TIM_CCMR1_OC1PE | TIM_CCMR1_OC2PE;
+    TIMER_INJECTOR->CCMR2 = TIM_CCMR2_OC3PE | TIM_CCMR2_OC4PE;
+    InjDrv_Init();
+    EnCon_UpdateEngineSpeed(333U);
+
+    TEST_CHECK((TIMER_INJECTOR->SMCR & TIM_SMCR_TS) == TIMER_INJECTOR_SPEED_TRIGGER);
+    TEST_CHECK((TIMER_INJECTOR->CR1 & TIM_CR1_ARPE) == 0U);
+    TEST_CHECK((TIMER_INJECTOR->CCMR1 & (TIM_CCMR1_OC1PE | TIM_CCMR1_OC2PE)) == 0U);
+    TEST_CHECK((TIMER_INJECTOR->CCMR2 & (TIM_CCMR2_OC3PE | TIM_CCMR2_OC4PE)) == 0U);
+
+    InjDrv_PrepareInjectionChannel(ENCON_CHANNEL_1, &pulse, 1U, 60.0F);
+
+    TEST_CHECK((TIMER_INJECTOR->CR1 & TIM_CR1_CEN) == 0U);
+    TEST_CHECK((TIMER_INJECTOR->SMCR & TIM_SMCR_SMS) == TIMER_SLAVE_MODE_TRIGGER);
+
+    TIMER_INJECTOR->SR |= TIM_SR_TIF;
+    TIM5_IRQHandler();
+
+    TEST_CHECK((TIMER_INJECTOR->SMCR & TIM_SMCR_SMS) == 0U);
+}
+
+/*===========================================================================*
+ * Function: Test_SpeedTimerEmitsTrgo
+ *===========================================================================*/
+static void Test_SpeedTimerEmitsTrgo(void)
+{
+    Test_ResetPeripherals();
+    TrigD_Init(NULL);
+
+    /* Master mode compare pulse: TRGO on every capture of the speed input */
+    TEST_CHECK((TIMER_SPEED->CR2 & TIM_CR2_MMS) == (TIM_CR2_MMS_1 | TIM_CR2_MMS_0));
+    TEST_CHECK((TIMER_SPEED->CCER & TIM_CCER_CC1E) != 0U);
+}
+
+/*===========================================================================*
+ * Function: Test_SparkJitter
+ *===========================================================================*/
+static void Test_SparkJitter(void)
+{
+    Test_JitterResult_T software;
+    Test_JitterResult_T hardware;
+    float rpm;
+    float anglePerTick;
+    uint32_t i;
+
+    Test_ResetPeripherals();
+    IgnDrv_Init();
+
+    printf("    %8s %22s %22s\n", "rpm", "software start [deg]", "TRGO start [deg]");
+    printf("    %8s %11s %10s %11s %10s\n", "", "mean", "max", "mean", "max");
+
+    for (i = 0U; i < (sizeof(test_speed_raw) / sizeof(test_speed_raw[0])); i++)
+    {
+        rpm = TEST_US_IN_MINUTE / ((float)test_speed_raw[i] * ENCON_TRIGGER_WHEEL_TEETH_NO);
+        anglePerTick = ENCON_ONE_TRIGGER_PULSE_ANGLE / ((float)test_speed_raw[i] * TIMER_SPEED_TIM_MULTIPLIER);
+
+        software = Test_SimulateSparkJitter(test_speed_raw[i], TEST_ISR_ENTRY_CYCLES + TEST_SW_START_DISPATCH_CYCLES,
+                                            TEST_SW_START_BLOCKING_MAX_CYCLES);
+        hardware = Test_SimulateSparkJitter(test_speed_raw[i], 0U, TEST_HW_START_JITTER_MAX_CYCLES);
+
+        printf("    %8.0f %11.4f %10.4f %11.4f %10.4f\n", (double)rpm, (double)software.meanError,
+               (double)software.maxError, (double)hardware.meanError, (double)hardware.maxError);
+
+        /* Hardware start error is limited to compare rounding and one tick of resynchronization */
+        TEST_CHECK(hardware.maxError <= (2.0F * anglePerTick));
+        TEST_CHECK(software.maxError > hardware.maxError);
+    }
+}
+
+/* end of file */
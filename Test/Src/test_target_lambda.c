@@ -0,0 +1,208 @@
+/*===========================================================================*
+ * File:        test_target_lambda.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Target lambda fuel multiplier together with start and warm up enrichments
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "test.h"
+
+#include "fakes.h"
+
+/* Module is included to reach its local functions */
+#include "../../Core/Src/speed_density.c"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/* Table points and lambda targets they were tuned for */
+#define TEST_WOT_SPEED_RPM                      (6200.0F)
+#define TEST_WOT_PRESSURE                       (101.0F)
+#define TEST_WOT_LAMBDA                         (0.86F)
+
+#define TEST_CRUISE_SPEED_RPM                   (3200.0F)
+#define TEST_CRUISE_PRESSURE                    (60.0F)
+#define TEST_CRUISE_LAMBDA                      (1.05F)
+
+/* Speed below the first table column, lambda of the 600RPM column */
+#define TEST_CRANKING_SPEED_RPM                 (250.0F)
+#define TEST_CRANKING_PRESSURE                  (96.0F)
+#define TEST_CRANKING_LAMBDA                    (0.90F)
+
+#define TEST_COLD_COOLANT_TEMP                  (-10.0F)
+#define TEST_WARM_UP_ENRICHMENT                 (35.0F)
+
+/* Table keeps the multiplier rounded to 3 decimal places */
+#define TEST_FUEL_TOLERANCE_RATIO               (0.001F)
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+static void Test_Setup(SpDen_EngineState_T state, float speed);
+static float Test_StoichiometricFuel(float speed, float pressure);
+static void Test_CheckFuel(float speed, float pressure, float lambda, float enrichment);
+
+static void Test_TargetLambdaScalesFuel(void);
+static void Test_TargetLambdaWithCrankingEnrichment(void);
+static void Test_TargetLambdaWithWarmUpEnrichment(void);
+static void Test_ClosedLoopTargetIsLambda(void);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: main
+ *===========================================================================*/
+int main(void)
+{
+    printf("test_target_lambda\n");
+
+    TEST_RUN(Test_TargetLambdaScalesFuel);
+    TEST_RUN(Test_TargetLambdaWithCrankingEnrichment);
+    TEST_RUN(Test_TargetLambdaWithWarmUpEnrichment);
+    TEST_RUN(Test_ClosedLoopTargetIsLambda);
+
+    return Test_Summary();
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Test_Setup
+ *===========================================================================*/
+static void Test_Setup(SpDen_EngineState_T state, float speed)
+{
+    Test_ResetPeripherals();
+    Fake_EnSensReset();
+    FuelTrim_Init();
+    CylTrim_Init();
+    InjMod_Init();
+    InjMod_Update();
+    /* Film is not updated, so compensation passes the fuel through */
+    WallWet_Init();
+    SpDen_Init();
+
+    /* Enrichment of the state is calculated once per engine cycle */
+    SpDen_EnterEngineState(state);
+    SpDen_OnEngineCycle(speed);
+    spden_engine_state = spden_engine_state_data.state;
+}
+
+/*===========================================================================*
+ * Function: Test_StoichiometricFuel
+ *===========================================================================*/
+static float Test_StoichiometricFuel(float speed, float pressure)
+{
+    /* Speed density equation with lambda 1.0 and without enrichments */
+    return Tables_Get3DTableValue(TABLES_3D_VE, speed, pressure) * pressure * EnSens_GetIatReciprocal() *
+           spden_fuel_multiplier;
+}
+
+/*===========================================================================*
+ * Function: Test_CheckFuel
+ *===========================================================================*/
+static void Test_CheckFuel(float speed, float pressure, float lambda, float enrichment)
+{
+    float fuelMs;
+    float expectedMs;
+
+    fuelMs = SpDen_CalculateFuel(speed, pressure, ENCON_CHANNEL_1);
+    /* Enrichment multiplies the fuel of the target mixture */
+    expectedMs = (Test_StoichiometricFuel(speed, pressure) / lambda) *
+                 (1.0F + (enrichment / (float)UTILS_PERCENTAGE_CONVERTER));
+
+    printf("    %6.0fRPM %6.1fkPa lambda %.2f enrichment %5.1f%%: %.4fms, expected %.4fms\n", (double)speed,
+           (double)pressure, (double)lambda, (double)enrichment, (double)fuelMs, (double)expectedMs);
+
+    TEST_CHECK_FLOAT(fuelMs, expectedMs, expectedMs * TEST_FUEL_TOLERANCE_RATIO);
+}
+
+/*===========================================================================*
+ * Function: Test_TargetLambdaScalesFuel
+ *===========================================================================*/
+static void Test_TargetLambdaScalesFuel(void)
+{
+    Test_Setup(SPDEN_ENGINE_STATE_RUNING, TEST_CRUISE_SPEED_RPM);
+
+    TEST_CHECK(0.0F == spden_engine_state_data.enrichment);
+
+    Test_CheckFuel(TEST_WOT_SPEED_RPM, TEST_WOT_PRESSURE, TEST_WOT_LAMBDA, 0.0F);
+    Test_CheckFuel(TEST_CRUISE_SPEED_RPM, TEST_CRUISE_PRESSURE, TEST_CRUISE_LAMBDA, 0.0F);
+}
+
+/*===========================================================================*
+ * Function: Test_TargetLambdaWithCrankingEnrichment
+ *===========================================================================*/
+static void Test_TargetLambdaWithCrankingEnrichment(void)
+{
+    float enrichment;
+
+    Test_Setup(SPDEN_ENGINE_STATE_NOT_RUNNING, TEST_CRANKING_SPEED_RPM);
+    fake_engine_sensors.cltTemperature = UTILS_CONVERT_C_TO_K(TEST_COLD_COOLANT_TEMP);
+    SpDen_EnterEngineState(SPDEN_ENGINE_STATE_CRANKING);
+    SpDen_OnEngineCycle(TEST_CRANKING_SPEED_RPM);
+    spden_engine_state = spden_engine_state_data.state;
+
+    enrichment = Tables_Get2DTableValue(TABLES_2D_CRANKING_ENRICHMENT, TEST_COLD_COOLANT_TEMP);
+
+    TEST_CHECK(SPDEN_ENGINE_STATE_CRANKING == spden_engine_state);
+    TEST_CHECK(enrichment > 0.0F);
+    TEST_CHECK_FLOAT(spden_engine_state_data.enrichment, enrichment, 0.0001F);
+
+    Test_CheckFuel(TEST_CRANKING_SPEED_RPM, TEST_CRANKING_PRESSURE, TEST_CRANKING_LAMBDA, enrichment);
+}
+
+/*===========================================================================*
+ * Function: Test_TargetLambdaWithWarmUpEnrichment
+ *===========================================================================*/
+static void Test_TargetLambdaWithWarmUpEnrichment(void)
+{
+    Test_Setup(SPDEN_ENGINE_STATE_NOT_RUNNING, TEST_CRUISE_SPEED_RPM);
+    fake_engine_sensors.cltTemperature = UTILS_CONVERT_C_TO_K(TEST_COLD_COOLANT_TEMP);
+    fake_engine_sensors.cltEnrichment = TEST_WARM_UP_ENRICHMENT;
+    SpDen_EnterEngineState(SPDEN_ENGINE_STATE_WARM_UP);
+    SpDen_OnEngineCycle(TEST_CRUISE_SPEED_RPM);
+    spden_engine_state = spden_engine_state_data.state;
+
+    TEST_CHECK(SPDEN_ENGINE_STATE_WARM_UP == spden_engine_state);
+    TEST_CHECK_FLOAT(spden_engine_state_data.enrichment, TEST_WARM_UP_ENRICHMENT, 0.0001F);
+
+    Test_CheckFuel(TEST_WOT_SPEED_RPM, TEST_WOT_PRESSURE, TEST_WOT_LAMBDA, TEST_WARM_UP_ENRICHMENT);
+    Test_CheckFuel(TEST_CRUISE_SPEED_RPM, TEST_CRUISE_PRESSURE, TEST_CRUISE_LAMBDA, TEST_WARM_UP_ENRICHMENT);
+}
+
+/*===========================================================================*
+ * Function: Test_ClosedLoopTargetIsLambda
+ *===========================================================================*/
+static void Test_ClosedLoopTargetIsLambda(void)
+{
+    /* Fuel trim controller compares the sensor with the reciprocal of the table value */
+    TEST_CHECK_FLOAT(1.0F / Tables_Get3DTableValue(TABLES_3D_TARGET_LAMBDA_RECIPROCAL, TEST_WOT_SPEED_RPM,
+                                                   TEST_WOT_PRESSURE),
+                     TEST_WOT_LAMBDA, 0.001F);
+    TEST_CHECK_FLOAT(1.0F / Tables_Get3DTableValue(TABLES_3D_TARGET_LAMBDA_RECIPROCAL, TEST_CRUISE_SPEED_RPM,
+                                                   TEST_CRUISE_PRESSURE),
+                     TEST_CRUISE_LAMBDA, 0.001F);
+}
+
+/* end of file */
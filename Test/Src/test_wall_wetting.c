@@ -0,0 +1,305 @@
+/*===========================================================================*
+ * File:        test_wall_wetting.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Fuel film compensation checked against the continuous X-tau model
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "test.h"
+
+#include "fakes.h"
+
+#include "tables.h"
+#include "wall_wetting.h"
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+#define TEST_LOW_FUEL_MS                        (4.0F)
+#define TEST_HIGH_FUEL_MS                       (8.0F)
+
+/* Engine cycles of every fuel level, film settles within them */
+#define TEST_PLATEAU_CYCLES                     (200U)
+#define TEST_CYCLES_NO                          (3U * TEST_PLATEAU_CYCLES)
+
+/* Integration steps of the continuous model in one engine cycle */
+#define TEST_MODEL_STEPS                        (10000U)
+
+/* Deposited fraction limit of the module */
+#define TEST_DEPOSIT_FRACTION_MAX               (0.9F)
+
+/* Steady state delivered fuel error in % */
+#define TEST_STEADY_ERROR_MAX                   (0.1F)
+/* Compensated transient error in % of the uncompensated one */
+#define TEST_TRANSIENT_ERROR_RATIO_MAX          (0.2F)
+
+/*===========================================================================*
+ *
+ * LOCAL TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+/* Continuous film model: dm/dt = -m / tau, injection deposits X of the fuel at once */
+typedef struct Test_FilmModel_Tag
+{
+    float depositFraction;
+    float tauMs;
+    float cycleMs;
+    float film;
+    /* Fuel evaporated since the previous injection, enters the cylinder with the next intake */
+    float evaporated;
+} Test_FilmModel_T;
+
+typedef struct Test_StepResult_Tag
+{
+    /* Maximum delivered fuel error in % of requested */
+    float compensatedError;
+    float uncompensatedError;
+    /* Delivered fuel error at the end of every plateau in % */
+    float steadyError;
+} Test_StepResult_T;
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+static const float test_speeds[] = { 1000.0F, 3000.0F, 6000.0F };
+static const float test_coolant_temps[] = { -10.0F, 20.0F, 90.0F };
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+static void Test_ModelInit(Test_FilmModel_T* model, float speed, float coolantTemp);
+static float Test_ModelInject(Test_FilmModel_T* model, float injectedMs);
+static float Test_RequestedFuel(uint32_t cycle);
+static float Test_Error(float deliveredMs, float requestedMs);
+static Test_StepResult_T Test_SimulateFuelSteps(float speed, float coolantTemp, bool isPrinted);
+
+static void Test_NoCompensationBeforeUpdate(void);
+static void Test_FuelStepTracksContinuousModel(void);
+static void Test_FuelStepAcrossSpeedAndTemperature(void);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: main
+ *===========================================================================*/
+int main(void)
+{
+    printf("test_wall_wetting\n");
+
+    TEST_RUN(Test_NoCompensationBeforeUpdate);
+    TEST_RUN(Test_FuelStepTracksContinuousModel);
+    TEST_RUN(Test_FuelStepAcrossSpeedAndTemperature);
+
+    return Test_Summary();
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Test_ModelInit
+ *===========================================================================*/
+static void Test_ModelInit(Test_FilmModel_T* model, float speed, float coolantTemp)
+{
+    model->depositFraction = Tables_Get3DTableValue(TABLES_3D_WALL_WETTING_X, speed, coolantTemp) /
+                             (float)UTILS_PERCENTAGE_CONVERTER;
+    model->depositFraction = (model->depositFraction > TEST_DEPOSIT_FRACTION_MAX) ? TEST_DEPOSIT_FRACTION_MAX :
+                                                                                    model->depositFraction;
+    model->tauMs = Tables_Get3DTableValue(TABLES_3D_WALL_WETTING_TAU, speed, coolantTemp);
+    model->cycleMs = (2.0F * 60000.0F) / speed;
+    model->film = 0.0F;
+    model->evaporated = 0.0F;
+}
+
+/*===========================================================================*
+ * Function: Test_ModelInject
+ *===========================================================================*/
+static float Test_ModelInject(Test_FilmModel_T* model, float injectedMs)
+{
+    double film;
+    double evaporated = 0.0;
+    double step;
+    float deliveredMs;
+    uint32_t index;
+
+    /* Cylinder gets direct part of the injection and film evaporated over the previous cycle */
+    deliveredMs = ((1.0F - model->depositFraction) * injectedMs) + model->evaporated;
+
+    film = (double)model->film + ((double)model->depositFraction * (double)injectedMs);
+    step = (double)model->cycleMs / (double)TEST_MODEL_STEPS;
+
+    for (index = 0U; index < TEST_MODEL_STEPS; index++)
+    {
+        evaporated += (film / (double)model->tauMs) * step;
+        film -= (film / (double)model->tauMs) * step;
+    }
+
+    model->film = (float)film;
+    model->evaporated = (float)evaporated;
+
+    return deliveredMs;
+}
+
+/*===========================================================================*
+ * Function: Test_RequestedFuel
+ *===========================================================================*/
+static float Test_RequestedFuel(uint32_t cycle)
+{
+    /* Low, tip-in step to high, tip-out step back to low */
+    return ((cycle >= TEST_PLATEAU_CYCLES) && (cycle < (2U * TEST_PLATEAU_CYCLES))) ? TEST_HIGH_FUEL_MS :
+                                                                                      TEST_LOW_FUEL_MS;
+}
+
+/*===========================================================================*
+ * Function: Test_Error
+ *===========================================================================*/
+static float Test_Error(float deliveredMs, float requestedMs)
+{
+    float error;
+
+    error = ((deliveredMs - requestedMs) * 100.0F) / requestedMs;
+
+    return (error < 0.0F) ? -error : error;
+}
+
+/*===========================================================================*
+ * Function: Test_SimulateFuelSteps
+ *===========================================================================*/
+static Test_StepResult_T Test_SimulateFuelSteps(float speed, float coolantTemp, bool isPrinted)
+{
+    Test_StepResult_T result = { 0.0F, 0.0F, 0.0F };
+    Test_FilmModel_T compensated;
+    Test_FilmModel_T uncompensated;
+    float requestedMs;
+    float injectedMs;
+    float deliveredMs;
+    float uncompensatedMs;
+    float error;
+    uint32_t cycle;
+
+    Fake_EnSensReset();
+    fake_engine_sensors.cltTemperature = UTILS_CONVERT_C_TO_K(coolantTemp);
+    WallWet_Init();
+    WallWet_Update(speed);
+
+    Test_ModelInit(&compensated, speed, coolantTemp);
+    Test_ModelInit(&uncompensated, speed, coolantTemp);
+
+    if (isPrinted)
+    {
+        printf("    X %.2f, tau %.1fms, cycle %.1fms\n", (double)compensated.depositFraction,
+               (double)compensated.tauMs, (double)compensated.cycleMs);
+        printf("    %6s %10s %10s %10s %14s\n", "cycle", "requested", "injected", "delivered", "uncompensated");
+    }
+
+    for (cycle = 0U; cycle < TEST_CYCLES_NO; cycle++)
+    {
+        requestedMs = Test_RequestedFuel(cycle);
+        injectedMs = WallWet_Compensate(ENCON_CHANNEL_1, requestedMs);
+        deliveredMs = Test_ModelInject(&compensated, injectedMs);
+        uncompensatedMs = Test_ModelInject(&uncompensated, requestedMs);
+
+        /* Film build up of the first plateau is not a fuel step */
+        if (cycle >= TEST_PLATEAU_CYCLES)
+        {
+            error = Test_Error(deliveredMs, requestedMs);
+            result.compensatedError = (error > result.compensatedError) ? error : result.compensatedError;
+            error = Test_Error(uncompensatedMs, requestedMs);
+            result.uncompensatedError = (error > result.uncompensatedError) ? error : result.uncompensatedError;
+        }
+
+        if (0U == ((cycle + 1U) % TEST_PLATEAU_CYCLES))
+        {
+            error = Test_Error(deliveredMs, requestedMs);
+            result.steadyError = (error > result.steadyError) ? error : result.steadyError;
+        }
+
+        if (isPrinted && ((cycle % TEST_PLATEAU_CYCLES) < 6U) && (cycle >= TEST_PLATEAU_CYCLES))
+        {
+            printf("    %6u %10.3f %10.3f %10.3f %14.3f\n", (unsigned)cycle, (double)requestedMs, (double)injectedMs,
+                   (double)deliveredMs, (double)uncompensatedMs);
+        }
+    }
+
+    return result;
+}
+
+/*===========================================================================*
+ * Function: Test_NoCompensationBeforeUpdate
+ *===========================================================================*/
+static void Test_NoCompensationBeforeUpdate(void)
+{
+    Fake_EnSensReset();
+    WallWet_Init();
+
+    TEST_CHECK_FLOAT(WallWet_Compensate(ENCON_CHANNEL_1, TEST_LOW_FUEL_MS), TEST_LOW_FUEL_MS, 0.0001F);
+    TEST_CHECK_FLOAT(WallWet_Compensate(ENCON_CHANNEL_1, TEST_HIGH_FUEL_MS), TEST_HIGH_FUEL_MS, 0.0001F);
+}
+
+/*===========================================================================*
+ * Function: Test_FuelStepTracksContinuousModel
+ *===========================================================================*/
+static void Test_FuelStepTracksContinuousModel(void)
+{
+    Test_StepResult_T result;
+
+    result = Test_SimulateFuelSteps(3000.0F, 20.0F, true);
+
+    printf("    max error: compensated %.2f%%, uncompensated %.2f%%\n", (double)result.compensatedError,
+           (double)result.uncompensatedError);
+
+    TEST_CHECK(result.steadyError < TEST_STEADY_ERROR_MAX);
+    TEST_CHECK(result.compensatedError < (result.uncompensatedError * TEST_TRANSIENT_ERROR_RATIO_MAX));
+}
+
+/*===========================================================================*
+ * Function: Test_FuelStepAcrossSpeedAndTemperature
+ *===========================================================================*/
+static void Test_FuelStepAcrossSpeedAndTemperature(void)
+{
+    Test_StepResult_T result;
+    uint32_t speed;
+    uint32_t temp;
+
+    printf("    %6s %8s %14s %14s\n", "rpm", "CLT oC", "compensated %", "uncompensated %");
+
+    for (speed = 0U; speed < (sizeof(test_speeds) / sizeof(test_speeds[0])); speed++)
+    {
+        for (temp = 0U; temp < (sizeof(test_coolant_temps) / sizeof(test_coolant_temps[0])); temp++)
+        {
+            result = Test_SimulateFuelSteps(test_speeds[speed], test_coolant_temps[temp], false);
+
+            printf("    %6.0f %8.0f %14.2f %14.2f\n", (double)test_speeds[speed], (double)test_coolant_temps[temp],
+                   (double)result.compensatedError, (double)result.uncompensatedError);
+
+            TEST_CHECK(result.steadyError < TEST_STEADY_ERROR_MAX);
+            TEST_CHECK(result.compensatedError < (result.uncompensatedError * TEST_TRANSIENT_ERROR_RATIO_MAX));
+        }
+    }
+}
+
+/* end of file */
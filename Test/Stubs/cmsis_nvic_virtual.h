@@ -0,0 +1,80 @@
+/*===========================================================================*
+ * File:        cmsis_nvic_virtual.h
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Host replacement of CMSIS NVIC functions
+ *===========================================================================*/
+#ifndef _TEST_CMSIS_NVIC_VIRTUAL_H_
+#define _TEST_CMSIS_NVIC_VIRTUAL_H_
+
+/*===========================================================================*
+ *
+ * EXPORTED DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/* Inline CMSIS functions access core registers by their fixed addresses, calls are redirected to RAM instance */
+#define NVIC_SetPriorityGrouping                __NVIC_SetPriorityGrouping
+#define NVIC_GetPriorityGrouping                __NVIC_GetPriorityGrouping
+#define NVIC_EnableIRQ                          Test_NvicEnableIrq
+#define NVIC_DisableIRQ                         Test_NvicDisableIrq
+#define NVIC_ClearPendingIRQ                    Test_NvicClearPendingIrq
+#define NVIC_SetPriority                        Test_NvicSetPriority
+#define NVIC_SystemReset                        Test_NvicSystemReset
+
+/*===========================================================================*
+ *
+ * EXPORTED FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Host replacement of NVIC interrupt enable
+ * param[in]:   IRQn - interrupt number
+ * param[out]:  None
+ * return:      None
+ * details:     Enable bit is set in the RAM instance of NVIC
+ *===========================================================================*/
+void Test_NvicEnableIrq(IRQn_Type IRQn);
+
+/*===========================================================================*
+ * brief:       Host replacement of NVIC interrupt disable
+ * param[in]:   IRQn - interrupt number
+ * param[out]:  None
+ * return:      None
+ * details:     Enable bit is cleared in the RAM instance of NVIC
+ *===========================================================================*/
+void Test_NvicDisableIrq(IRQn_Type IRQn);
+
+/*===========================================================================*
+ * brief:       Host replacement of NVIC pending flag clear
+ * param[in]:   IRQn - interrupt number
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+void Test_NvicClearPendingIrq(IRQn_Type IRQn);
+
+/*===========================================================================*
+ * brief:       Host replacement of NVIC priority setting
+ * param[in]:   IRQn - interrupt number
+ * param[in]:   priority - interrupt priority
+ * param[out]:  None
+ * return:      None
+ * details:     Priority is stored in the RAM instance of NVIC
+ *===========================================================================*/
+void Test_NvicSetPriority(IRQn_Type IRQn, uint32_t priority);
+
+/*===========================================================================*
+ * brief:       Host replacement of system reset request
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Test is aborted, reset is never expected
+ *===========================================================================*/
+void Test_NvicSystemReset(void);
+
+
+#endif
+/* end of file */
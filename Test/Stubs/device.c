@@ -0,0 +1,215 @@
+/*===========================================================================*
+ * File:        device.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Host instances of device peripherals used by tests
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+/* clock_gettime is not part of C99 */
+#define _POSIX_C_SOURCE                         (199309L)
+
+#include "stm32f411xe.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*===========================================================================*
+ *
+ * DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+#define TEST_DEVICE_CORE_CLOCK                  (100000000U)
+#define TEST_DEVICE_NS_IN_S                     (1000000000ULL)
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+uint32_t SystemCoreClock = TEST_DEVICE_CORE_CLOCK;
+
+TIM_TypeDef test_tim[12];
+Test_GpioPort_T test_gpio[TEST_GPIO_PORTS_NO];
+RCC_TypeDef test_rcc;
+PWR_TypeDef test_pwr;
+FLASH_TypeDef test_flash;
+ADC_TypeDef test_adc1;
+ADC_Common_TypeDef test_adc_common;
+SYSCFG_TypeDef test_syscfg;
+EXTI_TypeDef test_exti;
+DMA_TypeDef test_dma[2];
+DMA_Stream_TypeDef test_dma_streams[2][8];
+DBGMCU_TypeDef test_dbgmcu;
+SCB_Type test_scb;
+SysTick_Type test_systick;
+NVIC_Type test_nvic;
+ITM_Type test_itm;
+CoreDebug_Type test_core_debug;
+
+static DWT_Type test_dwt;
+static Test_TimestampMode_T test_timestamp_mode = TEST_TIMESTAMP_MODE_MANUAL;
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+static uint64_t Test_GetHostTimeNs(void);
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Test_GetDwt
+ *===========================================================================*/
+DWT_Type* Test_GetDwt(void)
+{
+    uint64_t hostTimeNs;
+
+    if (test_timestamp_mode == TEST_TIMESTAMP_MODE_HOST_CLOCK)
+    {
+        hostTimeNs = Test_GetHostTimeNs();
+        test_dwt.CYCCNT = (uint32_t)((hostTimeNs * (uint64_t)SystemCoreClock) / TEST_DEVICE_NS_IN_S);
+    }
+
+    return &test_dwt;
+}
+
+/*===========================================================================*
+ * Function: Test_SetTimestampMode
+ *===========================================================================*/
+void Test_SetTimestampMode(Test_TimestampMode_T mode)
+{
+    if (mode < TEST_TIMESTAMP_MODE_COUNT)
+    {
+        test_timestamp_mode = mode;
+    }
+}
+
+/*===========================================================================*
+ * Function: Test_SetTimeMs
+ *===========================================================================*/
+void Test_SetTimeMs(float timeMs)
+{
+    test_dwt.CYCCNT = (uint32_t)((uint64_t)((double)timeMs * ((double)SystemCoreClock / 1000.0)));
+}
+
+/*===========================================================================*
+ * Function: Test_DisableIrq
+ *===========================================================================*/
+void Test_DisableIrq(void)
+{
+}
+
+/*===========================================================================*
+ * Function: Test_EnableIrq
+ *===========================================================================*/
+void Test_EnableIrq(void)
+{
+}
+
+/*===========================================================================*
+ * Function: Test_NvicEnableIrq
+ *===========================================================================*/
+void Test_NvicEnableIrq(IRQn_Type IRQn)
+{
+    if ((int32_t)IRQn >= 0)
+    {
+        test_nvic.ISER[(uint32_t)IRQn >> 5U] |= (1UL << ((uint32_t)IRQn & 0x1FUL));
+    }
+}
+
+/*===========================================================================*
+ * Function: Test_NvicDisableIrq
+ *===========================================================================*/
+void Test_NvicDisableIrq(IRQn_Type IRQn)
+{
+    if ((int32_t)IRQn >= 0)
+    {
+        test_nvic.ISER[(uint32_t)IRQn >> 5U] &= ~(1UL << ((uint32_t)IRQn & 0x1FUL));
+    }
+}
+
+/*===========================================================================*
+ * Function: Test_NvicClearPendingIrq
+ *===========================================================================*/
+void Test_NvicClearPendingIrq(IRQn_Type IRQn)
+{
+    if ((int32_t)IRQn >= 0)
+    {
+        test_nvic.ISPR[(uint32_t)IRQn >> 5U] &= ~(1UL << ((uint32_t)IRQn & 0x1FUL));
+    }
+}
+
+/*===========================================================================*
+ * Function: Test_NvicSetPriority
+ *===========================================================================*/
+void Test_NvicSetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+    if ((int32_t)IRQn >= 0)
+    {
+        test_nvic.IP[(uint32_t)IRQn] = (uint8_t)((priority << (8U - __NVIC_PRIO_BITS)) & 0xFFUL);
+    }
+}
+
+/*===========================================================================*
+ * Function: Test_NvicSystemReset
+ *===========================================================================*/
+void Test_NvicSystemReset(void)
+{
+    printf("    FAIL: unexpected system reset\n");
+    exit(1);
+}
+
+/*===========================================================================*
+ * Function: Test_ResetPeripherals
+ *===========================================================================*/
+void Test_ResetPeripherals(void)
+{
+    memset(test_tim, 0, sizeof(test_tim));
+    memset(test_gpio, 0, sizeof(test_gpio));
+    memset(&test_rcc, 0, sizeof(test_rcc));
+    memset(&test_adc1, 0, sizeof(test_adc1));
+    memset(&test_adc_common, 0, sizeof(test_adc_common));
+    memset(&test_syscfg, 0, sizeof(test_syscfg));
+    memset(&test_exti, 0, sizeof(test_exti));
+    memset(test_dma, 0, sizeof(test_dma));
+    memset(test_dma_streams, 0, sizeof(test_dma_streams));
+    memset(&test_nvic, 0, sizeof(test_nvic));
+    memset(&test_dwt, 0, sizeof(test_dwt));
+}
+
+/*===========================================================================*
+ *
+ * LOCAL FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Test_GetHostTimeNs
+ *===========================================================================*/
+static uint64_t Test_GetHostTimeNs(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t)now.tv_sec * TEST_DEVICE_NS_IN_S) + (uint64_t)now.tv_nsec;
+}
+
+/* end of file */
@@ -0,0 +1,210 @@
+/*===========================================================================*
+ * File:        fake_engine_sensors.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Engine sensors module replacement with values set by tests
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "fakes.h"
+
+#include "string.h"
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+Fake_EngineSensors_T fake_engine_sensors;
+
+/*===========================================================================*
+ *
+ * FUNCTION DEFINITION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * Function: Fake_EnSensReset
+ *===========================================================================*/
+void Fake_EnSensReset(void)
+{
+    memset(&fake_engine_sensors, 0, sizeof(fake_engine_sensors));
+
+    fake_engine_sensors.map = 40.0F;
+    fake_engine_sensors.iat = UTILS_CONVERT_C_TO_K(20.0F);
+    fake_engine_sensors.iatReciprocal = 1.0F / fake_engine_sensors.iat;
+    fake_engine_sensors.cltTemperature = UTILS_CONVERT_C_TO_K(90.0F);
+    fake_engine_sensors.cltEnrichment = 0.0F;
+    fake_engine_sensors.batteryVoltage = 14.0F;
+    fake_engine_sensors.tps = 0.0F;
+    fake_engine_sensors.lambda = 1.0F;
+    fake_engine_sensors.oilPressure = 0.0F;
+    fake_engine_sensors.knockSamplingFrequency = 40000.0F;
+}
+
+/*===========================================================================*
+ * Function: EnSens_Init
+ *===========================================================================*/
+void EnSens_Init(void)
+{
+    Fake_EnSensReset();
+}
+
+/*===========================================================================*
+ * Function: EnSens_StartMapWindow
+ *===========================================================================*/
+void EnSens_StartMapWindow(void)
+{
+}
+
+/*===========================================================================*
+ * Function: EnSens_EndMapWindow
+ *===========================================================================*/
+void EnSens_EndMapWindow(void)
+{
+}
+
+/*===========================================================================*
+ * Function: EnSens_CancelMapWindow
+ *===========================================================================*/
+void EnSens_CancelMapWindow(void)
+{
+}
+
+/*===========================================================================*
+ * Function: EnSens_StartKnockWindow
+ *===========================================================================*/
+void EnSens_StartKnockWindow(EnCon_CylinderChannels_T channel)
+{
+    (void)channel;
+}
+
+/*===========================================================================*
+ * Function: EnSens_EndKnockWindow
+ *===========================================================================*/
+void EnSens_EndKnockWindow(void)
+{
+}
+
+/*===========================================================================*
+ * Function: EnSens_CancelKnockWindow
+ *===========================================================================*/
+void EnSens_CancelKnockWindow(void)
+{
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetKnockSamplingFrequency
+ *===========================================================================*/
+float EnSens_GetKnockSamplingFrequency(void)
+{
+    return fake_engine_sensors.knockSamplingFrequency;
+}
+
+/*===========================================================================*
+ * Function: EnSens_AlignMapSampling
+ *===========================================================================*/
+void EnSens_AlignMapSampling(float engineAngle, float sampleAngle)
+{
+    (void)engineAngle;
+    (void)sampleAngle;
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetMap
+ *===========================================================================*/
+float EnSens_GetMap(void)
+{
+    return fake_engine_sensors.map;
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetIat
+ *===========================================================================*/
+float EnSens_GetIat(void)
+{
+    return fake_engine_sensors.iat;
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetIatReciprocal
+ *===========================================================================*/
+float EnSens_GetIatReciprocal(void)
+{
+    return fake_engine_sensors.iatReciprocal;
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetClt
+ *===========================================================================*/
+float EnSens_GetClt(EnSens_CltResultTypes_T resultType)
+{
+    return (ENSENS_CLT_RESULT_TYPE_ENRICHEMENT == resultType) ? fake_engine_sensors.cltEnrichment :
+                                                                 fake_engine_sensors.cltTemperature;
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetBatteryVoltage
+ *===========================================================================*/
+float EnSens_GetBatteryVoltage(void)
+{
+    return fake_engine_sensors.batteryVoltage;
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetTps
+ *===========================================================================*/
+float EnSens_GetTps(void)
+{
+    return fake_engine_sensors.tps;
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetLambda
+ *===========================================================================*/
+float EnSens_GetLambda(void)
+{
+    return fake_engine_sensors.lambda;
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetOilPressure
+ *===========================================================================*/
+float EnSens_GetOilPressure(void)
+{
+    return fake_engine_sensors.oilPressure;
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetFaults
+ *===========================================================================*/
+uint32_t EnSens_GetFaults(EnSens_Sensor_T sensor)
+{
+    return (sensor < ENSENS_SENSOR_COUNT) ? fake_engine_sensors.faults[sensor] : 0U;
+}
+
+/*===========================================================================*
+ * Function: EnSens_GetActiveFaults
+ *===========================================================================*/
+uint32_t EnSens_GetActiveFaults(EnSens_Sensor_T sensor)
+{
+    /* Fake faults don't heal, they are active until cleared */
+    return EnSens_GetFaults(sensor);
+}
+
+/*===========================================================================*
+ * Function: EnSens_ClearFaults
+ *===========================================================================*/
+void EnSens_ClearFaults(void)
+{
+    memset(fake_engine_sensors.faults, 0, sizeof(fake_engine_sensors.faults));
+}
+
+/* end of file */
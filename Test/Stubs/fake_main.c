@@ -0,0 +1,26 @@
+/*===========================================================================*
+ * File:        fake_main.c
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Host replacement of main module globals
+ *===========================================================================*/
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "common_include.h"
+
+/*===========================================================================*
+ *
+ * GLOBAL VARIABLES AND CONSTANTS SECTION
+ *
+ *===========================================================================*/
+
+/* Set by the trigger decoder, background task of main is not executed in tests */
+volatile bool main_is_speed_trigger_occured;
+
+/* end of file */
@@ -0,0 +1,67 @@
+/*===========================================================================*
+ * File:        fakes.h
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Controllable replacements of modules not under test
+ *===========================================================================*/
+#ifndef _TEST_FAKES_H_
+#define _TEST_FAKES_H_
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+#include "engine_sensors.h"
+
+/*===========================================================================*
+ *
+ * EXPORTED TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+/* Values returned by the fake engine sensors getters */
+typedef struct Fake_EngineSensors_Tag
+{
+    float map;
+    float iat;
+    /* Has to be set together with iat */
+    float iatReciprocal;
+    float cltTemperature;
+    float cltEnrichment;
+    float batteryVoltage;
+    float tps;
+    float lambda;
+    float oilPressure;
+    float knockSamplingFrequency;
+    uint32_t faults[ENSENS_SENSOR_COUNT];
+} Fake_EngineSensors_T;
+
+/*===========================================================================*
+ *
+ * EXPORTED GLOBAL VARIABLES SECTION
+ *
+ *===========================================================================*/
+
+extern Fake_EngineSensors_T fake_engine_sensors;
+
+/*===========================================================================*
+ *
+ * EXPORTED FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Set fake engine sensors to warm engine at idle
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     MAP 40kPa, IAT 20C, CLT 90C, 14V, closed throttle, lambda 1.0, no faults
+ *===========================================================================*/
+void Fake_EnSensReset(void);
+
+
+#endif
+/* end of file */
@@ -0,0 +1,247 @@
+/*===========================================================================*
+ * File:        stm32f411xe.h
+ * Project:     ECU
+ * Author:      Mateusz Mroz
+ * Date:        19.10.2026
+ * Brief:       Host replacement of the device header used by tests
+ *===========================================================================*/
+#ifndef _TEST_STM32F411XE_H_
+#define _TEST_STM32F411XE_H_
+
+/*===========================================================================*
+ *
+ * INCLUDE SECTION
+ *
+ *===========================================================================*/
+
+/* NVIC functions of the core header are replaced by Stubs/cmsis_nvic_virtual.h */
+#define CMSIS_NVIC_VIRTUAL
+
+/* Register layouts and bit definitions come from the real device header */
+#include "../../Drivers/CMSIS/Device/ST/STM32F4xx/Include/stm32f411xe.h"
+
+/*===========================================================================*
+ *
+ * EXPORTED DEFINES AND MACRO SECTION
+ *
+ *===========================================================================*/
+
+/* GPIO ports are placed with the device address stride, port index is calculated from the address */
+#define TEST_GPIO_PORTS_NO                      (8U)
+#define TEST_GPIO_PORT_STRIDE                   (0x400U)
+
+/* Peripherals are mapped to RAM instances, so drivers can be executed and registers inspected */
+#undef TIM1
+#undef TIM2
+#undef TIM3
+#undef TIM4
+#undef TIM5
+#undef TIM9
+#undef TIM10
+#undef TIM11
+#undef GPIOA_BASE
+#undef GPIOB_BASE
+#undef GPIOA
+#undef GPIOB
+#undef GPIOC
+#undef GPIOD
+#undef GPIOE
+#undef GPIOH
+#undef RCC
+#undef PWR
+#undef FLASH
+#undef ADC1
+#undef ADC1_COMMON
+#undef SYSCFG
+#undef EXTI
+#undef DMA1
+#undef DMA2
+#undef DMA1_Stream0
+#undef DMA1_Stream1
+#undef DMA1_Stream2
+#undef DMA1_Stream3
+#undef DMA1_Stream4
+#undef DMA1_Stream5
+#undef DMA1_Stream6
+#undef DMA1_Stream7
+#undef DMA2_Stream0
+#undef DMA2_Stream1
+#undef DMA2_Stream2
+#undef DMA2_Stream3
+#undef DMA2_Stream4
+#undef DMA2_Stream5
+#undef DMA2_Stream6
+#undef DMA2_Stream7
+#undef DBGMCU
+#undef SCB
+#undef SysTick
+#undef NVIC
+#undef ITM
+#undef DWT
+#undef CoreDebug
+
+#define TIM1                                    (&test_tim[1])
+#define TIM2                                    (&test_tim[2])
+#define TIM3                                    (&test_tim[3])
+#define TIM4                                    (&test_tim[4])
+#define TIM5                                    (&test_tim[5])
+#define TIM9                                    (&test_tim[9])
+#define TIM10                                   (&test_tim[10])
+#define TIM11                                   (&test_tim[11])
+
+#define GPIOA_BASE                              ((uint32_t)(uintptr_t)&test_gpio[0])
+#define GPIOB_BASE                              ((uint32_t)(uintptr_t)&test_gpio[1])
+#define GPIOA                                   (&test_gpio[0].port)
+#define GPIOB                                   (&test_gpio[1].port)
+#define GPIOC                                   (&test_gpio[2].port)
+#define GPIOD                                   (&test_gpio[3].port)
+#define GPIOE                                   (&test_gpio[4].port)
+#define GPIOH                                   (&test_gpio[7].port)
+
+#define RCC                                     (&test_rcc)
+#define PWR                                     (&test_pwr)
+#define FLASH                                   (&test_flash)
+#define ADC1                                    (&test_adc1)
+#define ADC1_COMMON                             (&test_adc_common)
+#define SYSCFG                                  (&test_syscfg)
+#define EXTI                                    (&test_exti)
+#define DMA1                                    (&test_dma[0])
+#define DMA2                                    (&test_dma[1])
+#define DMA1_Stream0                            (&test_dma_streams[0][0])
+#define DMA1_Stream1                            (&test_dma_streams[0][1])
+#define DMA1_Stream2                            (&test_dma_streams[0][2])
+#define DMA1_Stream3                            (&test_dma_streams[0][3])
+#define DMA1_Stream4                            (&test_dma_streams[0][4])
+#define DMA1_Stream5                            (&test_dma_streams[0][5])
+#define DMA1_Stream6                            (&test_dma_streams[0][6])
+#define DMA1_Stream7                            (&test_dma_streams[0][7])
+#define DMA2_Stream0                            (&test_dma_streams[1][0])
+#define DMA2_Stream1                            (&test_dma_streams[1][1])
+#define DMA2_Stream2                            (&test_dma_streams[1][2])
+#define DMA2_Stream3                            (&test_dma_streams[1][3])
+#define DMA2_Stream4                            (&test_dma_streams[1][4])
+#define DMA2_Stream5                            (&test_dma_streams[1][5])
+#define DMA2_Stream6                            (&test_dma_streams[1][6])
+#define DMA2_Stream7                            (&test_dma_streams[1][7])
+#define DBGMCU                                  (&test_dbgmcu)
+#define SCB                                     (&test_scb)
+#define SysTick                                 (&test_systick)
+#define NVIC                                    (&test_nvic)
+#define ITM                                     (&test_itm)
+#define CoreDebug                               (&test_core_debug)
+/* Every read of the cycles counter goes through Test_GetDwt, see Test_SetTimestampMode */
+#define DWT                                     (Test_GetDwt())
+
+/* Interrupts masking has no meaning on the host, Cortex-M instructions can't be assembled */
+#define __disable_irq                           Test_DisableIrq
+#define __enable_irq                            Test_EnableIrq
+
+/*===========================================================================*
+ *
+ * EXPORTED TYPES AND ENUMERATION SECTION
+ *
+ *===========================================================================*/
+
+typedef union Test_GpioPort_Tag
+{
+    GPIO_TypeDef port;
+    uint8_t space[TEST_GPIO_PORT_STRIDE];
+} Test_GpioPort_T;
+
+typedef enum Test_TimestampMode_Tag
+{
+    /* DWT->CYCCNT changes only when written by the test */
+    TEST_TIMESTAMP_MODE_MANUAL,
+    /* DWT->CYCCNT follows host monotonic clock scaled to SystemCoreClock */
+    TEST_TIMESTAMP_MODE_HOST_CLOCK,
+
+    TEST_TIMESTAMP_MODE_COUNT
+} Test_TimestampMode_T;
+
+/*===========================================================================*
+ *
+ * EXPORTED GLOBAL VARIABLES SECTION
+ *
+ *===========================================================================*/
+
+extern TIM_TypeDef test_tim[12];
+extern Test_GpioPort_T test_gpio[TEST_GPIO_PORTS_NO];
+extern RCC_TypeDef test_rcc;
+extern PWR_TypeDef test_pwr;
+extern FLASH_TypeDef test_flash;
+extern ADC_TypeDef test_adc1;
+extern ADC_Common_TypeDef test_adc_common;
+extern SYSCFG_TypeDef test_syscfg;
+extern EXTI_TypeDef test_exti;
+extern DMA_TypeDef test_dma[2];
+extern DMA_Stream_TypeDef test_dma_streams[2][8];
+extern DBGMCU_TypeDef test_dbgmcu;
+extern SCB_Type test_scb;
+extern SysTick_Type test_systick;
+extern NVIC_Type test_nvic;
+extern ITM_Type test_itm;
+extern CoreDebug_Type test_core_debug;
+
+/*===========================================================================*
+ *
+ * EXPORTED FUNCTION DECLARATION SECTION
+ *
+ *===========================================================================*/
+
+/*===========================================================================*
+ * brief:       Gets DWT registers
+ * param[in]:   None
+ * param[out]:  None
+ * return:      DWT_Type* - pointer to the RAM instance
+ * details:     Cycles counter is updated from the host clock in TEST_TIMESTAMP_MODE_HOST_CLOCK
+ *===========================================================================*/
+DWT_Type* Test_GetDwt(void);
+
+/*===========================================================================*
+ * brief:       Select the source of the cycles counter
+ * param[in]:   mode - timestamp mode
+ * param[out]:  None
+ * return:      None
+ * details:     Tests with simulated time use manual mode, benchmarks use host clock
+ *===========================================================================*/
+void Test_SetTimestampMode(Test_TimestampMode_T mode);
+
+/*===========================================================================*
+ * brief:       Set cycles counter in manual timestamp mode
+ * param[in]:   timeMs - simulated time since start in ms
+ * param[out]:  None
+ * return:      None
+ * details:     Counter wraps around the same way as on the target
+ *===========================================================================*/
+void Test_SetTimeMs(float timeMs);
+
+/*===========================================================================*
+ * brief:       Host replacement of interrupts disable instruction
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+void Test_DisableIrq(void);
+
+/*===========================================================================*
+ * brief:       Host replacement of interrupts enable instruction
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     None
+ *===========================================================================*/
+void Test_EnableIrq(void);
+
+/*===========================================================================*
+ * brief:       Clear all peripheral registers
+ * param[in]:   None
+ * param[out]:  None
+ * return:      None
+ * details:     Registers start from zero, not from the device reset values
+ *===========================================================================*/
+void Test_ResetPeripherals(void);
+
+
+#endif
+/* end of file */